@@ -0,0 +1,92 @@
+#pragma once
+
+#include "AudioTrack.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/**
+ * Shared helpers for the micro-benchmarks under bench/.
+ * Build and run them with `make bench`.
+ */
+namespace bench {
+
+/**
+ * Stream buffer that swallows everything; used to mute the per-track
+ * constructor logging while building large fixtures.
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+/**
+ * RAII guard that redirects std::cout to a NullBuffer for its lifetime.
+ */
+class ScopedSilence {
+private:
+    NullBuffer sink;
+    std::streambuf* saved;
+
+public:
+    ScopedSilence() : sink(), saved(std::cout.rdbuf(&sink)) {}
+    ~ScopedSilence() { std::cout.rdbuf(saved); }
+    ScopedSilence(const ScopedSilence&) = delete;
+    ScopedSilence& operator=(const ScopedSilence&) = delete;
+};
+
+/**
+ * Minimal concrete track with a configurable waveform size, so benchmarks
+ * measure the data structure under test rather than MP3/WAV logging.
+ * Interned on construction, as buildLibrary does for library tracks.
+ */
+class BenchTrack : public AudioTrack {
+public:
+    BenchTrack(const std::string& title, size_t waveform_samples = 0)
+        : AudioTrack(title, std::vector<std::string>(1, "Bench"), 300, 128, waveform_samples) {
+        intern_id();
+    }
+
+    void load() override {}
+    void analyze_beatgrid() override {}
+    double get_quality_score() const override { return 50.0; }
+    PointerWrapper<AudioTrack> clone() const override {
+        return PointerWrapper<AudioTrack>(new BenchTrack(*this));
+    }
+};
+
+inline uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Small xorshift generator so benchmark access patterns are reproducible.
+ */
+class Rng {
+private:
+    uint64_t state;
+
+public:
+    explicit Rng(uint64_t seed = 0x9E3779B97F4A7C15ULL) : state(seed ? seed : 1) {}
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+    size_t below(size_t n) { return static_cast<size_t>(next() % n); }
+};
+
+/**
+ * Keeps the optimiser from discarding a computed value.
+ */
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    __asm__ __volatile__("" : : "g"(&value) : "memory");
+}
+
+} // namespace bench
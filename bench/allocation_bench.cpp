@@ -0,0 +1,120 @@
+/**
+ * Allocation counter for the title lookup paths. Global operator new is
+ * replaced with a counting version; every cache hit (for each eviction
+ * policy and through DJControllerService) and every playlist lookup must
+ * allocate nothing. Exits non-zero if any of them does, so `make run-bench`
+ * fails.
+ */
+#include "BenchUtils.h"
+#include "DJControllerService.h"
+#include "EvictionPolicy.h"
+#include "LRUCache.h"
+#include "Playlist.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+std::atomic<uint64_t> g_allocations(0);
+
+void* counted_allocate(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+}
+
+void* operator new(size_t size) { return counted_allocate(size); }
+void* operator new[](size_t size) { return counted_allocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+const size_t kTracks = 64;
+const size_t kLookups = 100000;
+
+int g_failures = 0;
+
+// Titles longer than the small-string buffer, so any copy has to allocate.
+std::string long_title(size_t i) {
+    return "Extended Club Mix Number " + std::to_string(i);
+}
+
+template<typename Fn>
+void expect_no_allocations(const std::string& label, Fn fn) {
+    uint64_t before = g_allocations.load();
+    uint64_t start = bench::now_ns();
+    for (size_t i = 0; i < kLookups; ++i)
+        fn(i);
+    double ns = static_cast<double>(bench::now_ns() - start) / kLookups;
+    uint64_t allocations = g_allocations.load() - before;
+    std::printf("%-34s %8.1f ns/op  %6.3f allocations/op  %s\n", label.c_str(), ns,
+                static_cast<double>(allocations) / kLookups, allocations ? "FAIL" : "ok");
+    if (allocations)
+        ++g_failures;
+}
+
+} // namespace
+
+int main() {
+    bench::ScopedSilence silence;
+    std::vector<std::string> titles;
+    for (size_t i = 0; i < kTracks; ++i)
+        titles.push_back(long_title(i));
+    std::vector<bench::BenchTrack*> library;
+    for (size_t i = 0; i < kTracks; ++i)
+        library.push_back(new bench::BenchTrack(titles[i]));
+
+    std::vector<std::string> lines;
+    for (const std::string& name : eviction_policy_names()) {
+        LRUCache cache(kTracks);
+        cache.set_policy(make_eviction_policy(name));
+        for (bench::BenchTrack* track : library)
+            cache.put(track->clone());
+        expect_no_allocations("LRUCache::get hit (" + name + ")", [&](size_t i) {
+            bench::do_not_optimize(cache.get(titles[i % kTracks]));
+        });
+    }
+
+    DJControllerService controller(kTracks);
+    for (bench::BenchTrack* track : library)
+        controller.loadTrackToCache(*track);
+    expect_no_allocations("DJControllerService cache hit", [&](size_t i) {
+        bench::do_not_optimize(controller.loadTrackToCache(*library[i % kTracks]));
+    });
+
+    Playlist playlist("Allocation check");
+    for (bench::BenchTrack* track : library)
+        playlist.add_track(track);
+    expect_no_allocations("Playlist::find_track", [&](size_t i) {
+        bench::do_not_optimize(playlist.find_track(titles[i % kTracks]));
+    });
+    expect_no_allocations("Playlist::for_each_track", [&](size_t) {
+        size_t length = 0;
+        playlist.for_each_track([&length](const AudioTrack& track) { length += track.get_title().size(); });
+        bench::do_not_optimize(length);
+    });
+    expect_no_allocations("AudioTrack::get_artists", [&](size_t i) {
+        bench::do_not_optimize(library[i % kTracks]->get_artists().size());
+    });
+
+    for (bench::BenchTrack* track : library)
+        delete track;
+    std::printf("%s\n", g_failures ? "Allocation check FAILED" : "Allocation check passed");
+    return g_failures ? 1 : 0;
+}
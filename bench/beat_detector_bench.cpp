@@ -0,0 +1,118 @@
+/**
+ * BeatDetector benchmark: synthetic 44.1 kHz drum loops (kick on the beat,
+ * quieter hat on the off-beat, over a noise floor) at several tempos. Reports
+ * the estimated BPM, confidence and first-beat offset against the truth, and
+ * times a 6-minute track split into the envelope pass and the tempo/phase
+ * estimation. Pure noise must come out unreliable.
+ *
+ * Last, a track that hands detection a decoded window (analysis_window)
+ * must take the detected tempo over its tagged one, and set_tempo() must
+ * round the tag to the nearest BPM (exit status 1 otherwise).
+ */
+#include "BeatDetector.h"
+#include "BenchUtils.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const double kSampleRate = 44100.0;
+
+double uniform(bench::Rng& rng) {
+    return static_cast<double>(rng.next() >> 11) / 4503599627370496.0 - 1.0;  // [-1, 1)
+}
+
+void add_hit(std::vector<double>& out, double at_seconds, double amplitude, double decay_seconds, bench::Rng& rng) {
+    size_t start = static_cast<size_t>(at_seconds * kSampleRate);
+    size_t length = static_cast<size_t>(6 * decay_seconds * kSampleRate);
+    for (size_t i = 0; i < length && start + i < out.size(); ++i)
+        out[start + i] += amplitude * std::exp(-static_cast<double>(i) / (decay_seconds * kSampleRate)) * uniform(rng);
+}
+
+std::vector<double> drum_loop(double seconds, double bpm, double first_beat, bool with_beats = true) {
+    bench::Rng rng(7);
+    std::vector<double> out(static_cast<size_t>(seconds * kSampleRate));
+    for (double& s : out)
+        s = 0.02 * uniform(rng);
+    if (!with_beats)
+        return out;
+    double period = 60.0 / bpm;
+    for (double t = first_beat; t < seconds; t += period) {
+        add_hit(out, t, 0.9, 0.04, rng);
+        add_hit(out, t + period / 2, 0.25, 0.01, rng);
+    }
+    return out;
+}
+
+void report(const char* label, double bpm, double first_beat, const BeatGrid& grid) {
+    std::printf("%-22s true %6.2f BPM @ %.3fs -> %7.2f BPM @ %.3fs, confidence %.2f%s\n",
+                label, bpm, first_beat, grid.bpm, grid.first_beat, grid.confidence,
+                grid.reliable() ? "" : " (unreliable)");
+}
+
+// Analyzes a drum loop instead of its generated waveform, like a mapped WAVTrack.
+class LoopTrack : public bench::BenchTrack {
+private:
+    std::vector<double> loop;
+
+protected:
+    bool analysis_window(std::vector<double>& samples, double& sample_rate) const override {
+        samples = loop;
+        sample_rate = kSampleRate;
+        return true;
+    }
+
+public:
+    LoopTrack(const std::string& title, const std::vector<double>& samples)
+        : bench::BenchTrack(title, 1000), loop(samples) {}
+
+    PointerWrapper<AudioTrack> clone() const override { return PointerWrapper<AudioTrack>(new LoopTrack(*this)); }
+    const BeatGrid& detect() { return detect_beat_grid(); }
+};
+
+} // namespace
+
+int main() {
+    const double tempos[] = {72.0, 98.5, 120.0, 127.3, 140.0, 174.0};
+    for (double bpm : tempos) {
+        std::vector<double> loop = drum_loop(60.0, bpm, 0.25);
+        char label[32];
+        std::snprintf(label, sizeof(label), "60s loop");
+        report(label, bpm, 0.25, BeatDetector::analyze(loop.data(), loop.size(), kSampleRate));
+    }
+    std::vector<double> noise = drum_loop(60.0, 0.0, 0.0, false);
+    BeatGrid none = BeatDetector::analyze(noise.data(), noise.size(), kSampleRate);
+    std::printf("%-22s -> %7.2f BPM, confidence %.2f%s\n", "60s noise", none.bpm, none.confidence,
+                none.reliable() ? " (RELIABLE?!)" : " (unreliable)");
+
+    std::vector<double> track = drum_loop(360.0, 126.0, 0.37);
+    std::printf("\n6-minute track: %zu samples (%.0f MB)\n", track.size(), track.size() * sizeof(double) / 1e6);
+    BeatDetector::Options options;
+    size_t hop = BeatDetector::hop_size(kSampleRate, options);
+    const int repeats = 5;
+    uint64_t best_envelope = UINT64_MAX, best_estimate = UINT64_MAX;
+    BeatGrid grid;
+    for (int r = 0; r < repeats; ++r) {
+        uint64_t start = bench::now_ns();
+        std::vector<double> energy = WaveformKernels::energy_envelope(track.data(), track.size(), hop);
+        uint64_t mid = bench::now_ns();
+        grid = BeatDetector::estimate(BeatDetector::onset_strength(energy), kSampleRate / hop, options);
+        uint64_t end = bench::now_ns();
+        best_envelope = std::min(best_envelope, mid - start);
+        best_estimate = std::min(best_estimate, end - mid);
+    }
+    report("6-minute track", 126.0, 0.37, grid);
+    std::printf("envelope pass (%s): %.2f ms, onset + autocorrelation + phase: %.2f ms\n",
+                WaveformKernels::active().name, best_envelope / 1e6, best_estimate / 1e6);
+
+    LoopTrack tagged("Loop Track", drum_loop(60.0, 127.3, 0.25));   // tagged 128 BPM
+    double detected = tagged.detect().reliable() ? tagged.get_tempo() : 0.0;
+    bool ok = std::fabs(detected - 127.3) < 0.5 && tagged.get_bpm() == 128;
+    tagged.set_tempo(126.6);
+    ok = ok && tagged.get_bpm() == 127 && tagged.get_tempo() == 126.6;
+    std::printf("\ntrack with a decoded window: tagged 128, detected %.2f BPM; set_tempo(126.6) tags %d\n",
+                detected, tagged.get_bpm());
+    std::printf("%s\n", ok ? "BeatDetector check passed" : "BeatDetector check FAILED");
+    return ok ? 0 : 1;
+}
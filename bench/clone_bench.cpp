@@ -0,0 +1,54 @@
+/**
+ * AudioTrack clone benchmark: cost of clone() as the waveform grows from 0
+ * to 1M samples, next to what the old deep copy of the samples costs. With
+ * the shared copy-on-write WaveformBuffer the clone column should stay flat.
+ */
+#include "BenchUtils.h"
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const size_t kClones = 20000;
+
+void run(size_t samples) {
+    bench::ScopedSilence quiet;
+    bench::BenchTrack prototype("Clone Bench", samples);
+
+    uint64_t start = bench::now_ns();
+    for (size_t i = 0; i < kClones; ++i) {
+        PointerWrapper<AudioTrack> copy = prototype.clone();
+        bench::do_not_optimize(copy.get());
+    }
+    double clone_ns = static_cast<double>(bench::now_ns() - start) / kClones;
+
+    // Reference: allocating and copying the samples, which every clone used to do.
+    size_t copies = samples >= 100000 ? kClones / 100 : kClones;
+    start = bench::now_ns();
+    for (size_t i = 0; i < copies; ++i) {
+        std::vector<double> deep(samples);
+        prototype.get_waveform_copy(deep.data(), samples);
+        bench::do_not_optimize(deep.data());
+    }
+    double deep_ns = static_cast<double>(bench::now_ns() - start) / copies;
+
+    // First write to a clone pays for one private copy.
+    PointerWrapper<AudioTrack> writer = prototype.clone();
+    start = bench::now_ns();
+    double* data = writer->get_mutable_waveform_data();
+    double detach_ns = static_cast<double>(bench::now_ns() - start);
+    bench::do_not_optimize(data);
+
+    std::printf("%10zu %14.1f %16.1f %16.1f\n", samples, clone_ns, deep_ns, detach_ns);
+}
+
+} // namespace
+
+int main() {
+    std::printf("AudioTrack::clone() cost (%zu clones per row)\n", kClones);
+    std::printf("%10s %14s %16s %16s\n", "samples", "clone ns", "deep copy ns", "first write ns");
+    const size_t sizes[] = {0, 1000, 10000, 100000, 1000000};
+    for (size_t samples : sizes)
+        run(samples);
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * Concurrent controller-cache throughput: ops/sec at 1, 2, 4, 8 and 16
+ * threads for ShardedLRUCache versus a single LRUCache behind one mutex.
+ * The mix is 90% reads (hit or miss) and 10% inserts over a key space twice
+ * the cache capacity, so evictions run continuously alongside lookups.
+ *
+ * ShardedLRUCache is a standalone prototype (the session uses LRUCache).
+ * Sharding can only pay off with more than one hardware thread; rows above
+ * the hardware thread count measure time-slicing, not parallel lookups.
+ */
+#include "BenchUtils.h"
+#include "LRUCache.h"
+#include "ShardedLRUCache.h"
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t kCapacity = 4096;
+const size_t kKeys = kCapacity * 2;
+const size_t kOpsPerThread = 200000;
+
+/**
+ * Baseline: the existing single-threaded cache made safe with one big lock.
+ */
+class LockedLRUCache {
+private:
+    std::mutex lock;
+    LRUCache cache;
+
+public:
+    explicit LockedLRUCache(size_t capacity) : lock(), cache(capacity) {}
+
+    template<typename Fn>
+    bool withTrack(const std::string& title, Fn fn) {
+        std::lock_guard<std::mutex> guard(lock);
+        AudioTrack* track = cache.get(title);
+        if (!track)
+            return false;
+        fn(*track);
+        return true;
+    }
+
+    bool put(PointerWrapper<AudioTrack> track) {
+        std::lock_guard<std::mutex> guard(lock);
+        return cache.put(std::move(track));
+    }
+};
+
+template<typename Cache>
+void worker(Cache& cache, const std::vector<AudioTrack*>& prototypes,
+            const std::vector<std::string>& titles, uint64_t seed, size_t& hits) {
+    bench::Rng rng(seed);
+    size_t local_hits = 0;
+    long bpm_sum = 0;
+    for (size_t i = 0; i < kOpsPerThread; ++i) {
+        size_t key = rng.below(kKeys);
+        if (rng.below(10) == 0) {
+            cache.put(prototypes[key]->clone());
+        } else if (cache.withTrack(titles[key], [&](AudioTrack& t) { bpm_sum += t.get_bpm(); })) {
+            ++local_hits;
+        }
+    }
+    bench::do_not_optimize(bpm_sum);
+    hits = local_hits;
+}
+
+template<typename Cache>
+double run(Cache& cache, size_t threads, const std::vector<AudioTrack*>& prototypes,
+           const std::vector<std::string>& titles, double& hit_ratio) {
+    for (size_t i = 0; i < kCapacity; ++i)
+        cache.put(prototypes[i]->clone());
+    std::vector<std::thread> pool;
+    std::vector<size_t> hits(threads, 0);
+    uint64_t start = bench::now_ns();
+    for (size_t t = 0; t < threads; ++t)
+        pool.emplace_back(worker<Cache>, std::ref(cache), std::cref(prototypes),
+                          std::cref(titles), 1234 + t, std::ref(hits[t]));
+    for (auto& th : pool)
+        th.join();
+    double seconds = static_cast<double>(bench::now_ns() - start) / 1e9;
+    size_t total_hits = 0;
+    for (size_t h : hits)
+        total_hits += h;
+    hit_ratio = static_cast<double>(total_hits) / (0.9 * threads * kOpsPerThread);
+    return threads * kOpsPerThread / seconds;
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> titles;
+    std::vector<AudioTrack*> prototypes;
+    {
+        bench::ScopedSilence quiet;
+        for (size_t i = 0; i < kKeys; ++i) {
+            titles.push_back("Concurrent Track #" + std::to_string(i));
+            prototypes.push_back(new bench::BenchTrack(titles.back()));
+        }
+    }
+    std::printf("Controller cache throughput: capacity %zu, %zu keys, %zu ops/thread, "
+                "hardware threads %u\n", kCapacity, kKeys, kOpsPerThread,
+                std::thread::hardware_concurrency());
+    std::printf("%8s %18s %10s %18s %10s\n", "threads", "locked ops/s", "hit%", "sharded ops/s", "hit%");
+    const size_t thread_counts[] = {1, 2, 4, 8, 16};
+    for (size_t threads : thread_counts) {
+        bench::ScopedSilence quiet;
+        double locked_hits = 0, sharded_hits = 0;
+        LockedLRUCache locked(kCapacity);
+        double locked_ops = run(locked, threads, prototypes, titles, locked_hits);
+        ShardedLRUCache sharded(kCapacity);
+        double sharded_ops = run(sharded, threads, prototypes, titles, sharded_hits);
+        std::fprintf(stdout, "%8zu %18.0f %9.1f%% %18.0f %9.1f%%\n", threads,
+                     locked_ops, 100.0 * locked_hits, sharded_ops, 100.0 * sharded_hits);
+        std::fflush(stdout);
+    }
+    unsigned hardware = std::thread::hardware_concurrency();
+    std::printf("Hardware threads: %u; rows with more threads time-slice the same cores and show\n"
+                "lock overhead, not parallel speedup.\n", hardware);
+    for (AudioTrack* track : prototypes)
+        delete track;
+    return 0;
+}
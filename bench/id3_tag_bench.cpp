@@ -0,0 +1,255 @@
+/**
+ * Lazy ID3v2 indexing over a directory of generated files: a v2.3 tag with
+ * UTF-16 text and 512 KB of album art, a v2.4 tag with an extended header,
+ * UTF-8 multi-value text and an unsynchronised APIC carrying a data-length
+ * indicator, and a v2.3 tag with tag-wide unsynchronisation. Title,
+ * artists, BPM and the picture are checked against what was written (exit
+ * status 1 on a mismatch); then reports files per second and bytes read
+ * for ID3v2Tag::read plus the title/artist/BPM lookups, next to reading
+ * each tag whole.
+ */
+#include "BenchUtils.h"
+#include "ID3v2Tag.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const char* const kDirectory = "/tmp/dj_id3_bench";
+const size_t kFilesPerVariant = 20;
+const int kPasses = 20;
+
+struct Variant {
+    const char* name;
+    int version;               // 3 or 4
+    bool tag_unsync;           // v2.3 tag-wide unsynchronisation
+    bool extended_header;
+    bool utf16;                // text as UTF-16 with BOM, else v2.3 Latin-1 / v2.4 UTF-8
+    size_t art_bytes;
+    const char* bpm_text;
+    int expected_bpm;
+};
+
+const char* const kTitle = u8"Café del Mar";
+const char* const kArtists[] = {u8"Tiësto", "Ferry Corsten"};
+
+void put_be32(std::string& out, uint32_t v) {
+    for (int shift = 24; shift >= 0; shift -= 8)
+        out += static_cast<char>((v >> shift) & 0xFF);
+}
+
+void put_syncsafe(std::string& out, uint32_t v) {
+    for (int shift = 21; shift >= 0; shift -= 7)
+        out += static_cast<char>((v >> shift) & 0x7F);
+}
+
+// Insert a zero after every 0xFF (more than the spec requires, still valid).
+std::string unsynchronise(const std::string& data) {
+    std::string out;
+    for (char c : data) {
+        out += c;
+        if (static_cast<uint8_t>(c) == 0xFF)
+            out += '\0';
+    }
+    return out;
+}
+
+std::string frame(const Variant& v, const char* id, const std::string& payload, uint16_t flags = 0) {
+    std::string out(id, 4);
+    if (v.version == 4)
+        put_syncsafe(out, static_cast<uint32_t>(payload.size()));
+    else
+        put_be32(out, static_cast<uint32_t>(payload.size()));
+    out += static_cast<char>(flags >> 8);
+    out += static_cast<char>(flags & 0xFF);
+    return out + payload;
+}
+
+// Encoding byte plus the values in the variant's text encoding
+std::string text_payload(const Variant& v, const std::vector<std::u16string>& values) {
+    std::string out;
+    if (v.utf16) {
+        out += '\x01';
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (v.version == 3 && i > 0)
+                out += std::string("/\0", 2);   // v2.3: one string, "/"-separated
+            else if (i > 0)
+                out += std::string(2, '\0');
+            if (v.version == 4 || i == 0)
+                out += "\xFF\xFE";
+            for (char16_t unit : values[i]) {
+                out += static_cast<char>(unit & 0xFF);
+                out += static_cast<char>(unit >> 8);
+            }
+        }
+        return out;
+    }
+    out += v.version == 4 ? '\x03' : '\x00';
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0)
+            out += v.version == 4 ? std::string(1, '\0') : std::string("/");
+        for (char16_t unit : values[i]) {
+            if (v.version == 4 && unit >= 0x80) {
+                out += static_cast<char>(0xC0 | (unit >> 6));
+                out += static_cast<char>(0x80 | (unit & 0x3F));
+            } else {
+                out += static_cast<char>(unit);   // Latin-1
+            }
+        }
+    }
+    return out;
+}
+
+// Pseudo-random image bytes, with plenty of 0xFF to exercise unsynchronisation
+std::string make_art(size_t bytes, unsigned seed) {
+    std::string art(bytes, '\0');
+    uint32_t x = 2463534242u + seed;
+    for (size_t i = 0; i < bytes; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        art[i] = static_cast<char>((x & 7) == 0 ? 0xFF : (x >> 8) & 0xFF);
+    }
+    return art;
+}
+
+void write_file(const std::string& path, const Variant& v, const std::string& art) {
+    std::string body;
+    if (v.extended_header) {
+        if (v.version == 4)
+            body += std::string("\x00\x00\x00\x06\x01\x00", 6);   // size 6, one flag byte, no flags
+        else
+            body += std::string("\x00\x00\x00\x06\x00\x00\x00\x00\x00\x00", 10);
+    }
+    body += frame(v, "TIT2", text_payload(v, {u"Café del Mar"}));
+    body += frame(v, "TPE1", text_payload(v, {u"Tiësto", u"Ferry Corsten"}));
+    body += frame(v, "TBPM", std::string(1, '\0') + v.bpm_text);
+    std::string apic = std::string(1, '\0') + "image/jpeg" + '\0' + '\x03' + "Cover" + '\0' + art;
+    if (v.version == 4) {
+        std::string stored;
+        put_syncsafe(stored, static_cast<uint32_t>(apic.size()));
+        body += frame(v, "APIC", stored + unsynchronise(apic), 0x0003);   // unsync + data length
+    } else {
+        body += frame(v, "APIC", apic);
+    }
+    body += std::string(2048, '\0');   // padding
+    if (v.tag_unsync)
+        body = unsynchronise(body);
+
+    std::string header("ID3", 3);
+    header += static_cast<char>(v.version);
+    header += '\0';
+    header += static_cast<char>((v.tag_unsync ? 0x80 : 0) | (v.extended_header ? 0x40 : 0));
+    put_syncsafe(header, static_cast<uint32_t>(body.size()));
+    std::string audio(4096, '\0');
+    audio[0] = static_cast<char>(0xFF);
+    audio[1] = static_cast<char>(0xFB);
+
+    std::ofstream out(path.c_str(), std::ios::binary);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(body.data(), static_cast<std::streamsize>(body.size()));
+    out.write(audio.data(), static_cast<std::streamsize>(audio.size()));
+}
+
+bool check(const ID3v2Tag& tag, const Variant& v, const std::string& art) {
+    std::vector<std::string> artists = tag.artists();
+    ID3Picture picture;
+    std::vector<uint8_t> image;
+    return tag.present() && tag.version() == v.version && tag.title() == kTitle && artists.size() == 2 &&
+           artists[0] == kArtists[0] && artists[1] == kArtists[1] && tag.bpm() == v.expected_bpm &&
+           tag.picture_info(picture) && picture.mime == "image/jpeg" && picture.type == 3 &&
+           picture.description == "Cover" && picture.image_bytes == art.size() &&
+           tag.read_picture(picture, image) && std::string(image.begin(), image.end()) == art;
+}
+
+// Baseline: read the whole tag into memory, as an eager parser would.
+uint64_t read_whole_tag(const std::string& path, std::vector<uint8_t>& buffer) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return 0;
+    uint8_t header[10];
+    uint64_t read = 0;
+    if (::pread(fd, header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))) {
+        read = sizeof(header);
+        size_t body = (static_cast<size_t>(header[6] & 0x7F) << 21) | (static_cast<size_t>(header[7] & 0x7F) << 14) |
+                      (static_cast<size_t>(header[8] & 0x7F) << 7) | static_cast<size_t>(header[9] & 0x7F);
+        buffer.resize(body);
+        ssize_t n = ::pread(fd, buffer.data(), body, 10);
+        read += n > 0 ? static_cast<uint64_t>(n) : 0;
+    }
+    ::close(fd);
+    return read;
+}
+
+} // namespace
+
+int main() {
+    const Variant variants[] = {
+        {"v2.3 UTF-16 + 512KB art", 3, false, false, true, 512 * 1024, "128", 128},
+        {"v2.4 ext + unsync art", 4, false, true, false, 512 * 1024, "127.6", 128},
+        {"v2.3 tag unsync", 3, true, true, false, 64 * 1024, "174", 174},
+    };
+    const size_t variant_count = sizeof(variants) / sizeof(variants[0]);
+
+    ::mkdir(kDirectory, 0755);
+    std::vector<std::vector<std::string>> paths(variant_count);
+    std::vector<std::string> art(variant_count);
+    for (size_t v = 0; v < variant_count; ++v) {
+        art[v] = make_art(variants[v].art_bytes, static_cast<unsigned>(v));
+        for (size_t i = 0; i < kFilesPerVariant; ++i) {
+            paths[v].push_back(std::string(kDirectory) + "/" + std::to_string(v) + "_" + std::to_string(i) + ".mp3");
+            write_file(paths[v].back(), variants[v], art[v]);
+        }
+    }
+    std::printf("%zu tagged files in %s\n", variant_count * kFilesPerVariant, kDirectory);
+    std::printf("%-26s %12s %14s %12s %14s  %s\n", "", "lazy files/s", "KB read/file", "whole files/s",
+                "KB read/file", "result");
+
+    int failures = 0;
+    std::vector<uint8_t> buffer;
+    for (size_t v = 0; v < variant_count; ++v) {
+        ID3v2Tag tag;
+        bool ok = true;
+        for (const std::string& path : paths[v])
+            ok = tag.read(path) && check(tag, variants[v], art[v]) && ok;
+
+        uint64_t lazy_read = 0;
+        size_t checksum = 0;
+        uint64_t start = bench::now_ns();
+        for (int pass = 0; pass < kPasses; ++pass) {
+            for (const std::string& path : paths[v]) {
+                tag.read(path);
+                checksum += tag.title().size() + tag.artists().size() + static_cast<size_t>(tag.bpm());
+                lazy_read += tag.bytes_read();
+            }
+        }
+        double lazy_seconds = static_cast<double>(bench::now_ns() - start) / 1e9;
+
+        uint64_t whole_read = 0;
+        start = bench::now_ns();
+        for (int pass = 0; pass < kPasses; ++pass)
+            for (const std::string& path : paths[v])
+                whole_read += read_whole_tag(path, buffer);
+        double whole_seconds = static_cast<double>(bench::now_ns() - start) / 1e9;
+
+        double files = static_cast<double>(kPasses * kFilesPerVariant);
+        bench::do_not_optimize(checksum);
+        std::printf("%-26s %12.0f %14.1f %12.0f %14.1f  %s\n", variants[v].name, files / lazy_seconds,
+                    lazy_read / 1024.0 / files, files / whole_seconds, whole_read / 1024.0 / files,
+                    ok ? "ok" : "FAIL");
+        if (!ok)
+            ++failures;
+    }
+
+    for (const std::vector<std::string>& files : paths)
+        for (const std::string& path : files)
+            std::remove(path.c_str());
+    ::rmdir(kDirectory);
+    std::printf("%s\n", failures ? "ID3v2 check FAILED" : "ID3v2 check passed");
+    return failures ? 1 : 0;
+}
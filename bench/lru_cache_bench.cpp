@@ -0,0 +1,228 @@
+/**
+ * LRUCache micro-benchmark: per-operation latency of get (hit) by TrackId
+ * and by title, contains (miss) and put (miss + eviction) as the slot count
+ * grows from 8 to 100k.
+ *
+ * The "hot id" column repeats 8 keys, so the memory touched per op is the
+ * same at every size: with the id index and intrusive recency list it must
+ * stay flat (checked: 100k slots within 2x of 8 slots), where a scan would
+ * grow with the slot count. The uniform columns touch a working set that
+ * outgrows the CPU caches, so they rise with the slot count even though
+ * the work per op is constant; the title columns also hash the title in
+ * TrackRegistry on every op.
+ *
+ * Also checks putIfApproved() under every eviction policy: approving all
+ * victims must evict exactly what put() evicts, and refusing any one of
+ * them must leave the cache untouched, and bytesUsed() must follow waveforms
+ * that fill in after the insert and drop back when entries leave (exit
+ * status 1 otherwise).
+ */
+#include "BenchUtils.h"
+#include "EvictionPolicy.h"
+#include "LRUCache.h"
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t kOps = 200000;
+const size_t kHotKeys = 8;
+const int kPasses = 3;            // timings are the best pass
+const double kFlatRatio = 2.0;    // allowed hot-id growth from 8 to 100k slots
+
+struct Row {
+    size_t slots;
+    double hot_id_ns;
+    double get_id_ns;
+    double get_title_ns;
+    double contains_ns;
+    double put_ns;
+};
+
+std::vector<std::string> make_titles(size_t count) {
+    std::vector<std::string> titles;
+    titles.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        titles.push_back("Bench Track #" + std::to_string(i));
+    return titles;
+}
+
+template <typename Op>
+double best_ns_per_op(Op op) {
+    double best = 0.0;
+    for (int pass = 0; pass < kPasses; ++pass) {
+        uint64_t start = bench::now_ns();
+        for (size_t i = 0; i < kOps; ++i)
+            op(i);
+        double ns = static_cast<double>(bench::now_ns() - start) / kOps;
+        if (pass == 0 || ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+Row run(size_t capacity) {
+    bench::ScopedSilence quiet;
+    std::vector<std::string> titles = make_titles(capacity * 2);
+    LRUCache cache(capacity);
+    std::vector<TrackId> ids;
+    for (size_t i = 0; i < capacity; ++i) {
+        PointerWrapper<AudioTrack> track(new bench::BenchTrack(titles[i]));
+        ids.push_back(track->get_id());
+        cache.put(std::move(track));
+    }
+
+    bench::Rng rng(capacity);
+    std::vector<size_t> hot(kOps), hits(kOps), misses(kOps);
+    for (size_t i = 0; i < kOps; ++i) {
+        hot[i] = rng.below(kHotKeys);
+        hits[i] = rng.below(capacity);
+        misses[i] = capacity + rng.below(capacity);
+    }
+
+    Row row;
+    row.slots = capacity;
+    row.hot_id_ns = best_ns_per_op([&](size_t i) { bench::do_not_optimize(cache.get(ids[hot[i]])); });
+    row.get_id_ns = best_ns_per_op([&](size_t i) { bench::do_not_optimize(cache.get(ids[hits[i]])); });
+    row.get_title_ns = best_ns_per_op([&](size_t i) { bench::do_not_optimize(cache.get(titles[hits[i]])); });
+    row.contains_ns = best_ns_per_op([&](size_t i) { bench::do_not_optimize(cache.contains(titles[misses[i]])); });
+
+    // Cycle through the second half of the key space so every put misses
+    // and evicts the current LRU entry. Tracks are built up front so only the
+    // cache work (including destroying the evicted track) is timed.
+    std::vector<AudioTrack*> incoming;
+    incoming.reserve(kOps);
+    for (size_t i = 0; i < kOps; ++i)
+        incoming.push_back(new bench::BenchTrack(titles[(capacity + i) % titles.size()]));
+    size_t evictions = 0;
+    uint64_t start = bench::now_ns();
+    for (size_t i = 0; i < kOps; ++i)
+        if (cache.put(PointerWrapper<AudioTrack>(incoming[i])))
+            ++evictions;
+    row.put_ns = static_cast<double>(bench::now_ns() - start) / kOps;
+    bench::do_not_optimize(evictions);
+
+    std::printf("%10zu %12.1f %12.1f %12.1f %12.1f %12.1f\n", row.slots, row.hot_id_ns, row.get_id_ns,
+                row.get_title_ns, row.contains_ns, row.put_ns);
+    return row;
+}
+
+std::vector<TrackId> cached_ids(const LRUCache& cache, const std::vector<bench::BenchTrack*>& tracks) {
+    std::vector<TrackId> ids;
+    for (bench::BenchTrack* track : tracks)
+        if (cache.contains(track->get_id()))
+            ids.push_back(track->get_id());
+    return ids;
+}
+
+// Twin caches under a byte budget, so one insert may need several victims.
+bool check_vetted_puts(const std::string& policy_name) {
+    const size_t kKeys = 48, kSteps = 4000;
+    bench::ScopedSilence quiet;
+    bench::Rng rng(11);
+    std::vector<bench::BenchTrack*> tracks;
+    for (size_t i = 0; i < kKeys; ++i)
+        tracks.push_back(new bench::BenchTrack("Vetted Track #" + std::to_string(i) + std::string(rng.below(400), 'x')));
+    size_t budget = 0;
+    for (size_t i = 0; i < 8; ++i)
+        budget += tracks[i]->memory_footprint();
+    LRUCache plain(16), vetted(16);
+    for (LRUCache* cache : {&plain, &vetted}) {
+        cache->set_policy(make_eviction_policy(policy_name));
+        cache->set_byte_budget(budget);
+    }
+
+    bool ok = true;
+    for (size_t step = 0; step < kSteps && ok; ++step) {
+        bench::BenchTrack* track = tracks[rng.below(kKeys)];
+        bool hit = plain.get(track->get_id()) != nullptr;
+        ok = hit == (vetted.get(track->get_id()) != nullptr);
+        if (hit || !ok)
+            continue;
+        // Refuse the first, second, ... victim until the insert needs fewer:
+        // every refused attempt must leave the cache as it was.
+        std::vector<TrackId> before = cached_ids(vetted, tracks);
+        size_t bytes_before = vetted.bytesUsed();
+        PointerWrapper<AudioTrack> plain_copy = track->clone();
+        for (size_t refuse_at = 1; ok; ++refuse_at) {
+            size_t asked = 0;
+            if (vetted.putIfApproved(track->clone(), [&](TrackId) { return ++asked < refuse_at; }) >= 0)
+                break;
+            ok = asked == refuse_at && cached_ids(vetted, tracks) == before && vetted.bytesUsed() == bytes_before;
+        }
+        plain.put(std::move(plain_copy));
+        ok = ok && cached_ids(plain, tracks) == cached_ids(vetted, tracks) && plain.bytesUsed() == vetted.bytesUsed();
+    }
+    for (bench::BenchTrack* track : tracks)
+        delete track;
+    return ok;
+}
+
+// Lazy waveforms grow after the insert: a hit re-measures the entry, and
+// eviction and clear() must release exactly what was charged.
+bool check_remeasured_bytes() {
+    const size_t kSlots = 4, kSamples = 4096;
+    bench::ScopedSilence quiet;
+    std::vector<bench::BenchTrack*> tracks;
+    for (size_t i = 0; i < 2 * kSlots; ++i)
+        tracks.push_back(new bench::BenchTrack("Measured Track #" + std::to_string(i), kSamples));
+    LRUCache cache(kSlots);
+    auto cached_bytes = [&]() {
+        size_t bytes = 0;
+        for (bench::BenchTrack* track : tracks)
+            if (const AudioTrack* cached = cache.get(track->get_id()))
+                bytes += cached->memory_footprint();
+        return bytes;
+    };
+    bool ok = true;
+    for (size_t i = 0; i < kSlots; ++i)
+        cache.put(tracks[i]->clone());
+    size_t lazy_bytes = cache.bytesUsed();
+    for (size_t i = 0; i < kSlots; ++i)
+        cache.get(tracks[i]->get_id())->get_waveform_stats();   // decodes the samples
+    ok = cached_bytes() == cache.bytesUsed() && cache.bytesUsed() > lazy_bytes + kSlots * kSamples;
+    for (size_t i = kSlots; i < tracks.size(); ++i)
+        cache.put(tracks[i]->clone());
+    ok = ok && cached_bytes() == cache.bytesUsed() && cache.bytesUsed() == lazy_bytes;
+    cache.clear();
+    ok = ok && cache.bytesUsed() == 0;
+    for (bench::BenchTrack* track : tracks)
+        delete track;
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    std::printf("LRUCache per-op latency in ns (%zu ops per column, best of %d)\n", kOps, kPasses);
+    std::printf("%10s %12s %12s %12s %12s %12s\n", "slots", "get hot id", "get id", "get title", "contains",
+                "put+evict");
+    const size_t capacities[] = {8, 64, 512, 4096, 32768, 100000};
+    std::vector<Row> rows;
+    for (size_t capacity : capacities)
+        rows.push_back(run(capacity));
+
+    const Row& small = rows.front();
+    const Row& large = rows.back();
+    double hot_ratio = large.hot_id_ns / small.hot_id_ns;
+    bool ok = hot_ratio <= kFlatRatio;
+    std::printf("get by id, %zu hot keys: %zu slots / %zu slots = %.2fx (%s, limit %.1fx)\n", kHotKeys, large.slots,
+                small.slots, hot_ratio, ok ? "flat" : "NOT FLAT", kFlatRatio);
+    std::printf("uniform keys, %zu / %zu slots: get id %.1fx, get title %.1fx, contains %.1fx, put %.1fx "
+                "(working set outgrows the CPU caches)\n",
+                large.slots, small.slots, large.get_id_ns / small.get_id_ns, large.get_title_ns / small.get_title_ns,
+                large.contains_ns / small.contains_ns, large.put_ns / small.put_ns);
+
+    for (const std::string& name : eviction_policy_names()) {
+        bool policy_ok = check_vetted_puts(name);
+        std::printf("putIfApproved vs put, %-8s %s\n", name.c_str(), policy_ok ? "ok" : "MISMATCH");
+        ok = ok && policy_ok;
+    }
+    bool bytes_ok = check_remeasured_bytes();
+    std::printf("bytesUsed after lazy waveforms fill in and leave: %s\n", bytes_ok ? "ok" : "MISMATCH");
+    ok = ok && bytes_ok;
+    std::printf("%s\n", ok ? "LRUCache check passed" : "LRUCache check FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/**
+ * MissRatioCurve benchmark: time to build the full LRU miss-ratio curve for a
+ * skewed 4M-access trace over 200k titles, exact versus SHARDS sampling, and
+ * the sampled curve's error at a few cache sizes, including sizes below 1/R
+ * (interpolated within the first sampled bucket). Also times one Belady OPT
+ * pass on the sampled stream.
+ */
+#include "BenchUtils.h"
+#include "MissRatioCurve.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t kAccesses = 4000000;
+const size_t kTitles = 200000;
+
+// Power-law popularity: low ids are requested far more often.
+std::vector<std::string> make_trace() {
+    std::vector<std::string> titles;
+    titles.reserve(kTitles);
+    for (size_t i = 0; i < kTitles; ++i)
+        titles.push_back("Bench Track #" + std::to_string(i));
+    bench::Rng rng(42);
+    std::vector<std::string> trace;
+    trace.reserve(kAccesses);
+    for (size_t i = 0; i < kAccesses; ++i) {
+        double u = static_cast<double>(rng.next() >> 11) / 9007199254740992.0;
+        trace.push_back(titles[static_cast<size_t>(std::pow(u, 4.0) * kTitles) % kTitles]);
+    }
+    return trace;
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> trace = make_trace();
+    const size_t sizes[] = {10, 50, 100, 1000, 10000, 50000};
+
+    uint64_t start = bench::now_ns();
+    MissRatioCurve exact(1.0);
+    exact.build(trace);
+    double exact_ms = static_cast<double>(bench::now_ns() - start) / 1e6;
+    std::printf("MissRatioCurve on %zu accesses, %zu distinct titles\n", exact.accesses(), exact.distinctTitles());
+    std::printf("exact build: %.0f ms\n", exact_ms);
+
+    const double rates[] = {0.1, 0.01};
+    for (double rate : rates) {
+        start = bench::now_ns();
+        MissRatioCurve sampled(rate);
+        sampled.build(trace);
+        double ms = static_cast<double>(bench::now_ns() - start) / 1e6;
+        std::printf("\nSHARDS R=%.2f build: %.0f ms (%zu accesses tracked)\n", rate, ms, sampled.sampledAccesses());
+        std::printf("%10s %12s %12s %12s\n", "slots", "exact LRU", "sampled LRU", "abs error");
+        for (size_t size : sizes) {
+            double want = exact.lruMissRatio(size);
+            double got = sampled.lruMissRatio(size);
+            std::printf("%10zu %11.2f%% %11.2f%% %11.2f%%\n", size, 100 * want, 100 * got, 100 * std::fabs(want - got));
+        }
+        start = bench::now_ns();
+        double opt = sampled.optMissRatio(10000);
+        std::printf("OPT @10000 slots: %.2f%% in %.0f ms\n", 100 * opt,
+                    static_cast<double>(bench::now_ns() - start) / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+/**
+ * MP3 frame-header scanner over a directory of generated files: CBR and
+ * untagged VBR (full frame scan), Xing/Info and VBRI headers (early stop),
+ * MPEG-2 streams, a large ID3v2 tag (skipped by seeking) and junk plus an
+ * ID3v1 trailer. Every result is checked against what was written (exit
+ * status 1 on a mismatch); then reports files per second per variant.
+ */
+#include "BenchUtils.h"
+#include "MP3FrameScanner.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const char* const kDirectory = "/tmp/dj_mp3_bench";
+const size_t kFilesPerVariant = 20;
+const double kSeconds = 60.0;
+const int kPasses = 5;
+
+// Bitrate index of `kbps` in the MPEG-1 Layer III table (MPEG-2 for lsf)
+unsigned bitrate_index(unsigned kbps, bool lsf) {
+    const unsigned v1[] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320};
+    const unsigned v2[] = {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160};
+    for (unsigned i = 1; i < 15; ++i)
+        if ((lsf ? v2 : v1)[i] == kbps)
+            return i;
+    return 0;
+}
+
+struct Variant {
+    const char* name;
+    bool lsf;                 // MPEG-2 at 22050 Hz instead of MPEG-1 at 44100 Hz
+    std::vector<unsigned> bitrates;   // cycled per frame; more than one = VBR
+    const char* tag;          // "Xing", "Info", "VBRI" or nullptr
+    size_t id3v2_bytes;       // leading tag size (album art), 0 = none
+    bool junk;                // garbage in the middle and an ID3v1 trailer
+    MP3StreamInfo::Source expected_source;
+};
+
+struct Expected {
+    uint64_t frames;
+    unsigned bitrate_kbps;
+    bool vbr;
+};
+
+void put_be32(std::string& out, uint32_t v) {
+    for (int shift = 24; shift >= 0; shift -= 8)
+        out += static_cast<char>((v >> shift) & 0xFF);
+}
+
+// One Layer III frame with a zeroed body (zero bytes never look like a sync word).
+std::string make_frame(const Variant& v, unsigned kbps, bool pad) {
+    unsigned rate = v.lsf ? 22050 : 44100;
+    size_t bytes = (v.lsf ? 72000 : 144000) * kbps / rate + (pad ? 1 : 0);
+    std::string frame(bytes, '\0');
+    frame[0] = static_cast<char>(0xFF);
+    frame[1] = static_cast<char>(v.lsf ? 0xF3 : 0xFB);
+    frame[2] = static_cast<char>((bitrate_index(kbps, v.lsf) << 4) | (pad ? 2 : 0));
+    frame[3] = 0x00;  // stereo
+    return frame;
+}
+
+Expected write_file(const std::string& path, const Variant& v) {
+    unsigned samples = v.lsf ? 576 : 1152;
+    unsigned rate = v.lsf ? 22050 : 44100;
+    uint64_t frames = static_cast<uint64_t>(kSeconds * rate / samples);
+    std::string audio;
+    for (uint64_t i = 0; i < frames; ++i) {
+        unsigned kbps = v.bitrates[i % v.bitrates.size()];
+        audio += make_frame(v, kbps, i % 3 == 1);
+        if (v.junk && i == frames / 2)
+            audio += std::string(517, '\x55');
+    }
+    std::ofstream out(path.c_str(), std::ios::binary);
+    if (v.id3v2_bytes) {
+        size_t body = v.id3v2_bytes - 10;
+        out.write("ID3\x03\x00\x00", 6);
+        char size[4] = {static_cast<char>((body >> 21) & 0x7F), static_cast<char>((body >> 14) & 0x7F),
+                        static_cast<char>((body >> 7) & 0x7F), static_cast<char>(body & 0x7F)};
+        out.write(size, 4);
+        std::string art(body, '\xFF');   // sync-like bytes: the scanner must not look inside
+        out.write(art.data(), static_cast<std::streamsize>(art.size()));
+    }
+    if (v.tag) {
+        std::string frame = make_frame(v, v.bitrates[0], false);
+        size_t offset = std::string(v.tag) == "VBRI" ? 36 : 4 + (v.lsf ? 17 : 32);
+        std::string tag(v.tag, 4);
+        if (tag == "VBRI") {
+            tag += std::string(6, '\0');
+            put_be32(tag, static_cast<uint32_t>(audio.size()));
+            put_be32(tag, static_cast<uint32_t>(frames));
+        } else {
+            put_be32(tag, 0x7);   // frames, bytes, TOC
+            put_be32(tag, static_cast<uint32_t>(frames));
+            put_be32(tag, static_cast<uint32_t>(audio.size()));
+            tag += std::string(100, '\0');
+        }
+        frame.replace(offset, tag.size(), tag);
+        out.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    }
+    out.write(audio.data(), static_cast<std::streamsize>(audio.size()));
+    if (v.junk)
+        out.write(("TAG" + std::string(125, ' ')).data(), 128);
+
+    Expected e;
+    e.frames = frames;
+    e.vbr = v.bitrates.size() > 1;
+    e.bitrate_kbps = e.vbr ? static_cast<unsigned>(audio.size() * 8 / (frames * samples / double(rate)) / 1000 + 0.5)
+                           : v.bitrates[0];
+    return e;
+}
+
+} // namespace
+
+int main() {
+    std::vector<Variant> variants = {
+        {"CBR 128 (scan)", false, {128}, nullptr, 0, false, MP3StreamInfo::Source::FrameScan},
+        {"CBR 320 + Info + 2MB art", false, {320}, "Info", 2 << 20, false, MP3StreamInfo::Source::Info},
+        {"VBR + Xing TOC", false, {128, 192, 256, 320}, "Xing", 0, false, MP3StreamInfo::Source::Xing},
+        {"VBR + VBRI", false, {96, 160, 224}, "VBRI", 0, false, MP3StreamInfo::Source::VBRI},
+        {"VBR untagged (scan)", false, {112, 192, 256}, nullptr, 0, false, MP3StreamInfo::Source::FrameScan},
+        {"MPEG-2 CBR 64 + junk", true, {64}, nullptr, 0, true, MP3StreamInfo::Source::FrameScan},
+    };
+
+    ::mkdir(kDirectory, 0755);
+    std::vector<std::vector<std::string>> paths(variants.size());
+    std::vector<Expected> expected(variants.size());
+    uint64_t total_bytes = 0;
+    for (size_t v = 0; v < variants.size(); ++v) {
+        for (size_t i = 0; i < kFilesPerVariant; ++i) {
+            paths[v].push_back(std::string(kDirectory) + "/" + std::to_string(v) + "_" + std::to_string(i) + ".mp3");
+            expected[v] = write_file(paths[v].back(), variants[v]);
+            struct stat info;
+            if (::stat(paths[v].back().c_str(), &info) == 0)
+                total_bytes += static_cast<uint64_t>(info.st_size);
+        }
+    }
+    std::printf("%zu files of %.0f s, %.1f MB in %s\n", variants.size() * kFilesPerVariant, kSeconds,
+                total_bytes / 1e6, kDirectory);
+    std::printf("%-26s %12s %14s  %s\n", "", "files/s", "KB read/file", "result");
+
+    MP3FrameScanner scanner;
+    int failures = 0;
+    for (size_t v = 0; v < variants.size(); ++v) {
+        uint64_t read = 0;
+        bool ok = true;
+        uint64_t start = bench::now_ns();
+        for (int pass = 0; pass < kPasses; ++pass) {
+            for (const std::string& path : paths[v]) {
+                ok = scanner.scan(path) && ok;
+                read += scanner.bytes_read();
+            }
+        }
+        double seconds = static_cast<double>(bench::now_ns() - start) / 1e9;
+        const MP3StreamInfo& info = scanner.info();
+        const Expected& e = expected[v];
+        ok = ok && info.frames == e.frames && info.vbr == e.vbr && info.bitrate_kbps == e.bitrate_kbps &&
+             info.source == variants[v].expected_source &&
+             std::fabs(info.duration_seconds - e.frames * (variants[v].lsf ? 576.0 / 22050 : 1152.0 / 44100)) < 1e-9;
+        std::printf("%-26s %12.0f %14.1f  %s (%llu frames, %u kbps%s, %.2f s, %s)\n", variants[v].name,
+                    kPasses * kFilesPerVariant / seconds, read / 1024.0 / (kPasses * kFilesPerVariant),
+                    ok ? "ok" : "FAIL", static_cast<unsigned long long>(info.frames), info.bitrate_kbps,
+                    info.vbr ? " VBR" : "", info.duration_seconds, MP3StreamInfo::source_name(info.source));
+        if (!ok)
+            ++failures;
+    }
+
+    for (const std::vector<std::string>& files : paths)
+        for (const std::string& path : files)
+            std::remove(path.c_str());
+    ::rmdir(kDirectory);
+    std::printf("%s\n", failures ? "MP3 scan check FAILED" : "MP3 scan check passed");
+    return failures ? 1 : 0;
+}
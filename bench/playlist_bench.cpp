@@ -0,0 +1,407 @@
+/**
+ * Playlist storage over 1M entries: totalling durations and iterating the
+ * contiguous Playlist versus the singly-linked node list it replaced (nodes
+ * linked in allocation order, and in shuffled order as after a long
+ * session of interleaved allocations), and the zero-copy view versus the
+ * vector the old getTracks() built; find_track through the TrackId index
+ * versus the linear scan it replaced, and the cost of removals at the
+ * front, middle and back (tombstoned, then compacted by the next positional
+ * read) and of removing 90% of the entries. Positional access, handle stability
+ * across removals, and duplicate titles through removals, copies and
+ * moves are checked; so are the running aggregates (duration, BPM
+ * histogram, min/max/mean BPM, mean quality, per-format counts) against a
+ * recomputation through adds, removals and BPM changes, whose per-poll
+ * cost is compared with walking the playlist. Last, copy-on-write
+ * snapshots of a 100k-entry playlist: the copy, and the first change that
+ * detaches it (exit status 1 on a mismatch).
+ */
+#include "BenchUtils.h"
+#include "MP3Track.h"
+#include "Playlist.h"
+#include "TrackTable.h"
+#include "WAVTrack.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t kTracks = 4096;
+const size_t kEntries = 1000000;
+const int kPasses = 10;
+
+// The node layout Playlist used before
+struct LegacyNode {
+    AudioTrack* track;
+    LegacyNode* next;
+};
+
+int legacy_total_duration(const LegacyNode* head) {
+    int total = 0;
+    for (const LegacyNode* node = head; node; node = node->next)
+        total += node->track->get_duration();
+    return total;
+}
+
+std::vector<AudioTrack*> legacy_get_tracks(const LegacyNode* head) {
+    std::vector<AudioTrack*> tracks;
+    for (const LegacyNode* node = head; node; node = node->next)
+        tracks.push_back(node->track);
+    return tracks;
+}
+
+// Builds the legacy list over `order` (node i holds entry order[i]'s track).
+LegacyNode* build_legacy(std::vector<LegacyNode>& nodes, const std::vector<size_t>& order,
+                         const std::vector<AudioTrack*>& entries) {
+    LegacyNode* head = nullptr;
+    for (size_t i = order.size(); i-- > 0;) {
+        LegacyNode& node = nodes[order[i]];
+        node.track = entries[i];
+        node.next = head;
+        head = &node;
+    }
+    return head;
+}
+
+// What a dashboard polls, computed by walking the playlist as before
+struct Aggregates {
+    int total_duration;
+    int min_bpm;
+    int max_bpm;
+    double mean_bpm;
+    double mean_quality;
+    size_t mp3;
+    size_t wav;
+    size_t other;
+    std::map<int, size_t> histogram;
+};
+
+Aggregates recompute(const Playlist& playlist) {
+    Aggregates a = {0, 0, 0, 0.0, 0.0, 0, 0, 0, std::map<int, size_t>()};
+    double bpm_sum = 0.0;
+    for (AudioTrack* track : playlist) {
+        a.total_duration += track->get_duration();
+        bpm_sum += track->get_bpm();
+        a.mean_quality += track->get_quality_score();
+        a.histogram[track->get_bpm()]++;
+        if (dynamic_cast<const MP3Track*>(track))
+            a.mp3++;
+        else if (dynamic_cast<const WAVTrack*>(track))
+            a.wav++;
+        else
+            a.other++;
+    }
+    if (playlist.size()) {
+        a.min_bpm = a.histogram.begin()->first;
+        a.max_bpm = a.histogram.rbegin()->first;
+        a.mean_bpm = bpm_sum / playlist.size();
+        a.mean_quality /= playlist.size();
+    }
+    return a;
+}
+
+bool aggregates_match(const Playlist& playlist) {
+    Aggregates a = recompute(playlist);
+    return playlist.get_total_duration() == a.total_duration && playlist.min_bpm() == a.min_bpm &&
+           playlist.max_bpm() == a.max_bpm && std::fabs(playlist.mean_bpm() - a.mean_bpm) < 1e-9 &&
+           std::fabs(playlist.mean_quality() - a.mean_quality) < 1e-6 &&
+           playlist.format_count(TrackFormat::MP3) == a.mp3 && playlist.format_count(TrackFormat::WAV) == a.wav &&
+           playlist.other_format_count() == a.other && playlist.bpm_histogram() == a.histogram;
+}
+
+template<typename Fn>
+double ms_per_pass(Fn fn) {
+    uint64_t start = bench::now_ns();
+    for (int pass = 0; pass < kPasses; ++pass)
+        fn();
+    return static_cast<double>(bench::now_ns() - start) / 1e6 / kPasses;
+}
+
+} // namespace
+
+int main() {
+    std::vector<bench::BenchTrack*> tracks;
+    std::vector<AudioTrack*> entries(kEntries);
+    Playlist playlist("Playlist bench");
+    {
+        bench::ScopedSilence quiet;
+        for (size_t i = 0; i < kTracks; ++i)
+            tracks.push_back(new bench::BenchTrack("Playlist bench track " + std::to_string(i)));
+        for (size_t i = 0; i < kEntries; ++i) {
+            entries[i] = tracks[i % kTracks];
+            playlist.add_track(entries[i]);
+        }
+    }
+
+    std::vector<size_t> in_order(kEntries), shuffled(kEntries);
+    for (size_t i = 0; i < kEntries; ++i)
+        in_order[i] = shuffled[i] = i;
+    bench::Rng rng(21);
+    for (size_t i = kEntries - 1; i > 0; --i)
+        std::swap(shuffled[i], shuffled[rng.below(i + 1)]);
+    std::vector<LegacyNode> sequential_nodes(kEntries), shuffled_nodes(kEntries);
+    const LegacyNode* sequential_head = build_legacy(sequential_nodes, in_order, entries);
+    const LegacyNode* shuffled_head = build_legacy(shuffled_nodes, shuffled, entries);
+
+    int expected_total = 0;
+    for (AudioTrack* track : entries)
+        expected_total += track->get_duration();
+    bool ok = playlist.size() == kEntries && playlist.get_total_duration() == expected_total &&
+              legacy_total_duration(shuffled_head) == expected_total;
+    for (size_t i = 0; i < kEntries; i += 9973)
+        ok = ok && playlist[i] == entries[i] && playlist.tracks_view()[i] == entries[i];
+
+    std::printf("%zu entries over %zu tracks, ms per pass\n", kEntries, kTracks);
+    std::printf("%-34s %10s %10s %10s %8s\n", "", "list", "shuffled", "Playlist", "speedup");
+    int sink = 0;
+    double list_ms = ms_per_pass([&] { sink += legacy_total_duration(sequential_head); });
+    double shuffled_ms = ms_per_pass([&] { sink += legacy_total_duration(shuffled_head); });
+    double range_ms = ms_per_pass([&] {
+        for (AudioTrack* track : playlist)
+            sink += track->get_duration();
+    });
+    std::printf("%-34s %10.2f %10.2f %10.2f %7.1fx\n", "total duration by iteration", list_ms, shuffled_ms, range_ms,
+                shuffled_ms / range_ms);
+
+    size_t count = 0;
+    double copy_ms = ms_per_pass([&] { count += legacy_get_tracks(shuffled_head).size(); });
+    double view_ms = ms_per_pass([&] {
+        PlaylistView view = playlist.tracks_view();
+        count += view.slice(kEntries / 2, kEntries).size();
+    });
+    std::printf("%-34s %10s %10.2f %10.4f\n", "getTracks() copy vs tracks_view()", "", copy_ms, view_ms);
+    bench::do_not_optimize(sink);
+    bench::do_not_optimize(count);
+
+    // find_track: linear scan (the old walk, over the contiguous storage) versus the id index.
+    const size_t finds = 1000;
+    std::vector<TrackId> wanted(finds);
+    for (size_t i = 0; i < finds; ++i)
+        wanted[i] = tracks[rng.below(kTracks)]->get_id();
+    uint64_t start = bench::now_ns();
+    for (TrackId id : wanted) {
+        AudioTrack* found = nullptr;
+        for (AudioTrack* track : playlist)
+            if (track->get_id() == id) {
+                found = track;
+                break;
+            }
+        bench::do_not_optimize(found);
+    }
+    double scan_ns = static_cast<double>(bench::now_ns() - start) / finds;
+    start = bench::now_ns();
+    for (size_t pass = 0; pass < 1000; ++pass)
+        for (TrackId id : wanted)
+            bench::do_not_optimize(playlist.find_track(id));
+    double index_ns = static_cast<double>(bench::now_ns() - start) / (finds * 1000);
+    std::printf("%-34s %10s %10.1f %10.1f %7.0fx  (ns per find)\n", "find_track", "", scan_ns, index_ns,
+                scan_ns / index_ns);
+    for (size_t i = 0; i < kTracks; i += 97)
+        ok = ok && playlist.find_track(tracks[i]->get_id()) == tracks[i] &&
+             playlist.position_of(playlist.find_handle(tracks[i]->get_id())) == static_cast<long>(i);
+
+    // Removal keeps the order by leaving a tombstone: O(1) wherever it lands.
+    // The next positional read compacts the gaps in one pass.
+    {
+        Playlist scratch(playlist);
+        scratch.remove_track(scratch.handle_at(0));   // detach the copy outside the timing
+        const size_t removals = 1000;
+        const char* labels[] = {"front", "middle", "back"};
+        std::vector<PlaylistHandle> doomed[3];
+        for (size_t i = 0; i < removals; ++i) {
+            doomed[0].push_back(scratch.handle_at(i));
+            doomed[1].push_back(scratch.handle_at(scratch.size() / 2 + i));
+            doomed[2].push_back(scratch.handle_at(scratch.size() - 1 - i));
+        }
+        std::printf("%-34s", "remove_track(handle), ns each");
+        for (int where = 0; where < 3; ++where) {
+            uint64_t begin = bench::now_ns();
+            for (PlaylistHandle handle : doomed[where])
+                ok = scratch.remove_track(handle) && ok;
+            std::printf(" %s %.0f", labels[where], static_cast<double>(bench::now_ns() - begin) / removals);
+        }
+        uint64_t begin = bench::now_ns();
+        bench::do_not_optimize(scratch[0]);
+        std::printf(", then compaction %.1f ms\n", static_cast<double>(bench::now_ns() - begin) / 1e6);
+        ok = ok && scratch.size() == kEntries - 1 - 3 * removals && aggregates_match(scratch);
+
+        // Removing most of the playlist in random order stays O(1) each:
+        // compaction runs whenever tombstones outnumber the live entries.
+        std::vector<AudioTrack*> before(scratch.begin(), scratch.end());
+        std::vector<PlaylistHandle> handles_before;
+        std::vector<size_t> order;
+        for (size_t i = 0; i < before.size(); ++i) {
+            handles_before.push_back(scratch.handle_at(i));
+            order.push_back(i);
+        }
+        bench::Rng shuffle(3);
+        for (size_t i = order.size(); i > 1; --i)
+            std::swap(order[i - 1], order[shuffle.below(i)]);
+        size_t keep = order.size() / 10;
+        std::vector<char> kept(order.size(), 0);
+        for (size_t i = 0; i < keep; ++i)
+            kept[order[i]] = 1;
+        begin = bench::now_ns();
+        for (size_t i = keep; i < order.size(); ++i)
+            ok = scratch.remove_track(handles_before[order[i]]) && ok;
+        std::printf("%-34s %.0f ns each (%zu removals, random positions)\n", "remove 90%, amortized",
+                    static_cast<double>(bench::now_ns() - begin) / (order.size() - keep), order.size() - keep);
+        ok = ok && scratch.size() == keep && aggregates_match(scratch);
+        size_t position = 0;
+        for (size_t i = 0; i < before.size() && ok; ++i) {
+            if (!kept[i])
+                continue;
+            ok = scratch[position] == before[i] && scratch.position_of(handles_before[i]) == static_cast<long>(position);
+            ++position;
+        }
+    }
+
+    // Handles: remove every third entry of a small playlist and check the rest still resolve.
+    Playlist small("Handle check");
+    std::vector<PlaylistHandle> handles;
+    {
+        bench::ScopedSilence quiet;
+        for (size_t i = 0; i < 300; ++i)
+            handles.push_back(small.add_track(tracks[i]));
+        for (size_t i = 0; i < handles.size(); i += 3)
+            ok = small.remove_track(handles[i]) && ok;
+    }
+    for (size_t i = 0; i < handles.size(); ++i) {
+        bool removed = i % 3 == 0;
+        long position = small.position_of(handles[i]);
+        ok = ok && (removed ? small.get(handles[i]) == nullptr && position == -1
+                            : small.get(handles[i]) == tracks[i] && small[static_cast<size_t>(position)] == tracks[i] &&
+                                  small.handle_at(static_cast<size_t>(position)) == handles[i]);
+    }
+    {
+        bench::ScopedSilence quiet;
+        PlaylistHandle reused = small.add_track(tracks[0]);   // takes a freed slot, new generation
+        ok = ok && small.get(reused) == tracks[0] && small.get(handles[0]) == nullptr && small[small.size() - 1] == tracks[0];
+    }
+
+    // Duplicates: A B A C A. Removing by title takes the first A; find then resolves to the next one.
+    Playlist dups("Duplicate check");
+    AudioTrack* a = tracks[0];
+    std::vector<PlaylistHandle> a_handles;
+    {
+        bench::ScopedSilence quiet;
+        a_handles.push_back(dups.add_track(a));
+        dups.add_track(tracks[1]);
+        a_handles.push_back(dups.add_track(a));
+        dups.add_track(tracks[2]);
+        a_handles.push_back(dups.add_track(a));
+        Playlist copy(dups);
+        copy.remove_track(a->get_title());
+        ok = ok && copy.find_handle(a->get_id()) == a_handles[1] && copy.position_of(a_handles[1]) == 1 &&
+             dups.find_handle(a->get_id()) == a_handles[0];   // the original's index is untouched
+        ok = ok && dups.remove_track(a_handles[1]) && dups.find_handle(a->get_id()) == a_handles[0];
+        dups.remove_track(a->get_title());
+        ok = ok && dups.find_handle(a->get_id()) == a_handles[2] && dups.position_of(a_handles[2]) == 2;
+        Playlist moved(std::move(dups));
+        moved.remove_track(a->get_title());
+        ok = ok && moved.find_track(a->get_id()) == nullptr && moved.size() == 2 &&
+             moved.find_track(tracks[2]->get_id()) == tracks[2];
+        a_handles.push_back(moved.add_track(a));
+        ok = ok && moved.find_handle(a->get_id()) == a_handles.back() && moved.position_of(a_handles.back()) == 2;
+    }
+
+    // Aggregates: a mixed MP3/WAV playlist through adds, removals and BPM changes.
+    std::vector<AudioTrack*> mixed;
+    {
+        bench::ScopedSilence quiet;
+        Playlist set("Aggregate check");
+        std::vector<PlaylistHandle> set_handles;
+        for (int i = 0; i < 60; ++i) {
+            std::vector<std::string> artists(1, "Bench");
+            std::string title = "Aggregate track " + std::to_string(i);
+            if (i % 3 == 2)
+                mixed.push_back(new WAVTrack(title, artists, 200 + i, 120 + i % 17, i % 2 ? 96000 : 44100, 24));
+            else
+                mixed.push_back(new MP3Track(title, artists, 200 + i, 120 + i % 17, 128 + 32 * (i % 7), true));
+            set_handles.push_back(set.add_track(mixed.back()));
+            if (i % 5 == 0)
+                set_handles.push_back(set.add_track(tracks[static_cast<size_t>(i)]));
+        }
+        set_handles.push_back(set.add_track(mixed[7]));   // a duplicate entry
+        ok = ok && aggregates_match(set);
+        for (size_t i = 1; i < set_handles.size(); i += 4)
+            set.remove_track(set_handles[i]);
+        ok = ok && aggregates_match(set);
+        ok = ok && set.set_track_bpm(set_handles.back(), 174) && aggregates_match(set) && set.max_bpm() == 174;
+        mixed[9]->set_bpm(60);   // changed in place, then reported
+        set.refresh_track(mixed[9]);
+        ok = ok && aggregates_match(set) && set.min_bpm() == 60;
+        Playlist copy(set);
+        copy.remove_track(mixed[9]->get_title());
+        ok = ok && aggregates_match(copy) && aggregates_match(set);
+        Playlist moved(std::move(copy));
+        ok = ok && aggregates_match(moved) && copy.get_total_duration() == 0 && copy.bpm_histogram().empty();
+        while (!moved.is_empty())
+            moved.remove_track(moved.handle_at(0));
+        ok = ok && aggregates_match(moved) && moved.mean_quality() == 0.0 && moved.bpm_histogram().empty();
+    }
+
+    // Dashboard poll over the 1M-entry playlist: O(1) queries versus a walk.
+    double walk_ms = ms_per_pass([&] { sink += recompute(playlist).total_duration; });
+    const int polls = 1000000;
+    uint64_t poll_start = bench::now_ns();
+    for (int i = 0; i < polls; ++i) {
+        double value = playlist.get_total_duration() + playlist.min_bpm() + playlist.max_bpm() + playlist.mean_bpm() +
+                       playlist.mean_quality() + playlist.format_count(TrackFormat::MP3) +
+                       playlist.other_format_count() + playlist.bpm_histogram().size();
+        bench::do_not_optimize(value);
+    }
+    double poll_ns = static_cast<double>(bench::now_ns() - poll_start) / polls;
+    std::printf("%-34s %10s %10.2f ms %7.1f ns  (per poll of all aggregates)\n", "aggregates: walk vs running", "",
+                walk_ms, poll_ns);
+    bench::do_not_optimize(sink);
+
+    // Snapshots: copies share the contents until the first change.
+    const size_t snapshot_entries = 100000;
+    Playlist live("Snapshot source");
+    {
+        bench::ScopedSilence quiet;
+        for (size_t i = 0; i < snapshot_entries; ++i)
+            live.add_track(tracks[i % kTracks]);
+    }
+    const int snapshots = 100000;
+    uint64_t snap_start = bench::now_ns();
+    for (int i = 0; i < snapshots; ++i) {
+        Playlist snapshot(live);
+        bench::do_not_optimize(snapshot);
+    }
+    double snapshot_ns = static_cast<double>(bench::now_ns() - snap_start) / snapshots;
+    double detach_ms = ms_per_pass([&] {
+        bench::ScopedSilence quiet;
+        Playlist snapshot(live);
+        snapshot.add_track(tracks[0]);   // first change copies the shared contents
+        bench::do_not_optimize(snapshot);
+    });
+    std::printf("%-34s %10s %10.1f ns %7.2f ms  (100k entries: copy, copy + first add)\n", "copy-on-write snapshot", "",
+                snapshot_ns, detach_ms);
+    {
+        bench::ScopedSilence quiet;
+        PlaylistHandle first = live.handle_at(0);
+        Playlist snapshot(live);
+        ok = ok && snapshot.shares_contents_with(live) && snapshot.get(first) == live[0];
+        snapshot.remove_track(first);
+        ok = ok && !snapshot.shares_contents_with(live) && snapshot.size() == snapshot_entries - 1 &&
+             live.size() == snapshot_entries && live.get(first) == tracks[0] && snapshot.get(first) == nullptr &&
+             snapshot.get_total_duration() + tracks[0]->get_duration() == live.get_total_duration();
+        Playlist assigned("Assigned");
+        assigned = live;
+        live.add_track(tracks[1]);   // the source changes; the assigned copy keeps the snapshot
+        ok = ok && assigned.size() == snapshot_entries && live.size() == snapshot_entries + 1 &&
+             assigned.find_handle(tracks[0]->get_id()) == first && aggregates_match(assigned) && aggregates_match(live);
+    }
+
+    for (AudioTrack* track : mixed)
+        delete track;
+    for (bench::BenchTrack* track : tracks)
+        delete track;
+    std::printf("%s\n", ok ? "Playlist check passed" : "Playlist check FAILED");
+    return ok ? 0 : 1;
+}
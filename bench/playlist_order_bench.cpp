@@ -0,0 +1,158 @@
+/**
+ * PlaylistOptimizer on a 10k-track playlist with 1% of its positions
+ * pinned: the configured (shuffled) order, the nearest-neighbour start
+ * alone (a zero time budget), and the full local search on 1, 2, 4, 8 and
+ * all hardware threads. Each result is checked to be a permutation that
+ * keeps the pinned tracks in place and is no worse than the configured
+ * order or the start, and the orders found must not depend on the thread
+ * count. Last, Playlist::reorder applies an order to a playlist with
+ * duplicate entries: handles, the TrackId index and the aggregates are
+ * checked (exit status 1 on a mismatch).
+ */
+#include "BenchUtils.h"
+#include "Playlist.h"
+#include "PlaylistOptimizer.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t kTracks = 10000;
+const size_t kPinnedEvery = 100;   // 1% of the positions
+const size_t kPlaylistTracks = 500;
+
+// Tempos from a few genre bands, in shuffled order
+std::vector<double> make_tempos(bench::Rng& rng) {
+    const int bands[][2] = {{70, 90}, {118, 130}, {124, 128}, {136, 142}, {160, 180}};
+    std::vector<double> tempos;
+    for (size_t i = 0; i < kTracks; ++i) {
+        const int* band = bands[rng.below(5)];
+        tempos.push_back(band[0] + static_cast<double>(rng.below(static_cast<size_t>(band[1] - band[0]) * 10)) / 10);
+    }
+    return tempos;
+}
+
+bool valid(const PlaylistOrder& result, const PlaylistOrderOptions& options, size_t n) {
+    if (result.order.size() != n)
+        return false;
+    std::vector<char> seen(n, 0);
+    for (size_t position : result.order) {
+        if (position >= n || seen[position])
+            return false;
+        seen[position] = 1;
+    }
+    for (size_t position : options.pinned)
+        if (result.order[position] != position)
+            return false;
+    return result.cost <= result.initial_cost;
+}
+
+void print_row(const char* label, const PlaylistOrder& result, size_t n) {
+    std::printf("%-22s %12.0f %9zu/%zu %8zu %10.1f\n", label, result.cost, result.mixable, n - 1, result.rounds,
+                result.seconds * 1e3);
+}
+
+} // namespace
+
+int main() {
+    bench::Rng rng(25);
+    std::vector<double> tempos = make_tempos(rng);
+    PlaylistOrderOptions options;
+    for (size_t position = kPinnedEvery / 2; position < kTracks; position += kPinnedEvery)
+        options.pinned.push_back(position);
+    options.time_budget_seconds = 30.0;   // long enough to converge; the rounds column shows the work
+    bool ok = true;
+
+    std::printf("PlaylistOptimizer: %zu tracks, %zu pinned, tolerance %.0f BPM, window %zu, hardware threads %u\n",
+                kTracks, options.pinned.size(), options.bpm_tolerance, options.window,
+                std::thread::hardware_concurrency());
+    std::printf("%-22s %12s %13s %8s %10s\n", "order", "cost", "mixable", "rounds", "ms");
+
+    PlaylistOrderOptions start_only = options;
+    start_only.time_budget_seconds = 0.0;
+    PlaylistOrder start = PlaylistOptimizer(start_only).optimize(tempos);
+    PlaylistOrder configured = start;
+    configured.cost = configured.initial_cost;
+    configured.mixable = configured.initial_mixable;
+    configured.rounds = 0;
+    configured.seconds = 0.0;
+    print_row("configured", configured, kTracks);
+    print_row("nearest neighbour", start, kTracks);
+    ok = ok && valid(start, start_only, kTracks) && start.rounds == 0;
+
+    std::vector<size_t> reference;
+    const unsigned thread_counts[] = {1, 2, 4, 8, 0};
+    for (unsigned threads : thread_counts) {
+        options.threads = threads;
+        PlaylistOrder result = PlaylistOptimizer(options).optimize(tempos);
+        char label[32];
+        std::snprintf(label, sizeof(label), threads ? "search, %u threads" : "search, all threads", threads);
+        print_row(label, result, kTracks);
+        ok = ok && valid(result, options, kTracks) && !result.budget_exhausted && result.cost <= start.cost &&
+             result.mixable >= result.initial_mixable;
+        if (reference.empty())
+            reference = result.order;
+        ok = ok && result.order == reference;
+    }
+
+    // Applying an order to a playlist; every fifth entry repeats an earlier track.
+    std::vector<bench::BenchTrack*> tracks;
+    Playlist playlist("Reorder");
+    std::vector<PlaylistHandle> handles;
+    {
+        bench::ScopedSilence quiet;
+        for (size_t i = 0; i < kPlaylistTracks; ++i) {
+            tracks.push_back(new bench::BenchTrack("Order Track #" + std::to_string(i)));
+            tracks.back()->set_bpm(70 + static_cast<int>(rng.below(110)));
+        }
+        for (size_t i = 0; i < kPlaylistTracks; ++i) {
+            AudioTrack* track = i % 5 == 4 ? tracks[rng.below(i)] : tracks[i];
+            handles.push_back(playlist.add_track(track));
+        }
+    }
+    int total_duration = playlist.get_total_duration();
+    double mean_bpm = playlist.mean_bpm();
+    std::map<int, size_t> histogram = playlist.bpm_histogram();
+    PlaylistOrderOptions playlist_options;
+    playlist_options.pinned.push_back(0);
+    PlaylistOrder result = PlaylistOptimizer(playlist_options).optimize(playlist);
+    std::vector<AudioTrack*> before(playlist.begin(), playlist.end());
+    Playlist snapshot(playlist);
+    ok = ok && valid(result, playlist_options, kPlaylistTracks) && playlist.reorder(result.order);
+    for (size_t k = 0; k < kPlaylistTracks; ++k) {
+        size_t from = result.order[k];
+        ok = ok && playlist[k] == before[from] && playlist.position_of(handles[from]) == static_cast<long>(k) &&
+             snapshot[from] == before[from];
+    }
+    for (bench::BenchTrack* track : tracks) {
+        PlaylistHandle first = playlist.find_handle(track->get_id());
+        long expected = -1;
+        for (size_t k = 0; k < kPlaylistTracks && expected < 0; ++k)
+            if (playlist[k] == track)
+                expected = static_cast<long>(k);
+        ok = ok && playlist.position_of(first) == expected;
+    }
+    ok = ok && playlist.get_total_duration() == total_duration && playlist.mean_bpm() == mean_bpm &&
+         playlist.bpm_histogram() == histogram;
+    std::vector<size_t> not_permutation(kPlaylistTracks, 0);
+    ok = ok && !playlist.reorder(not_permutation) && !playlist.reorder(std::vector<size_t>(3, 0)) &&
+         playlist[0] == before[result.order[0]];
+    {
+        bench::ScopedSilence quiet;
+        for (size_t i = 0; i < kPlaylistTracks; i += 7)
+            playlist.remove_track(handles[i]);
+    }
+    for (size_t i = 0; i < kPlaylistTracks; ++i)
+        ok = ok && (playlist.get(handles[i]) == nullptr) == (i % 7 == 0);
+    std::printf("Playlist reorder: %zu entries, mixable %zu -> %zu\n", kPlaylistTracks, result.initial_mixable,
+                result.mixable);
+
+    for (bench::BenchTrack* track : tracks)
+        delete track;
+    std::printf("%s\n", ok ? "Playlist order check passed" : "Playlist order check FAILED");
+    return ok ? 0 : 1;
+}
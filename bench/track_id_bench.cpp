@@ -0,0 +1,194 @@
+/**
+ * TrackId interning: cost of identity lookups with long titles keyed by
+ * string (hash + compare of the full title, as before interning) versus by
+ * the dense 32-bit TrackId, for the controller cache index, a playlist
+ * scan and a policy replay. Then TrackRegistry lookups from 1-8 threads
+ * (title -> id as the string overloads do, and id -> title) against one
+ * mutex-guarded map, as the registry was first built; cloning every track,
+ * or constructing one outside the library, must not intern anything, the
+ * cache must turn away a track without an id, and a playlist must give it
+ * one (exit status 1 otherwise).
+ */
+#include "BenchUtils.h"
+#include "CacheSimulator.h"
+#include "LRUCache.h"
+#include "MP3Track.h"
+#include "Playlist.h"
+#include "TrackRegistry.h"
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const size_t kTracks = 4096;
+const size_t kPlaylist = 512;
+const size_t kOps = 1000000;
+
+double ns_per_op(uint64_t start, size_t ops) {
+    return static_cast<double>(bench::now_ns() - start) / ops;
+}
+
+void report(const char* label, double by_title, double by_id) {
+    std::printf("%-32s %9.1f ns %9.1f ns %7.1fx\n", label, by_title, by_id, by_title / by_id);
+}
+
+// The first registry design: every lookup behind one process-wide mutex.
+class LockedTitleIndex {
+public:
+    explicit LockedTitleIndex(const std::vector<std::string>& titles) : ids(), mutex() {
+        for (size_t i = 0; i < titles.size(); ++i)
+            ids[titles[i]] = static_cast<TrackId>(i);
+    }
+
+    TrackId find(const std::string& title) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = ids.find(title);
+        return it == ids.end() ? INVALID_TRACK_ID : it->second;
+    }
+
+private:
+    std::unordered_map<std::string, TrackId> ids;
+    mutable std::mutex mutex;
+};
+
+// Nanoseconds per lookup across `threads` threads, each doing kOps / threads lookups.
+template<typename Lookup>
+double threaded_ns(size_t threads, const std::vector<size_t>& picks, Lookup lookup) {
+    uint64_t start = bench::now_ns();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&, t]() {
+            for (size_t i = t; i < kOps; i += threads)
+                lookup(picks[i]);
+        }));
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    return ns_per_op(start, kOps);
+}
+
+} // namespace
+
+int main() {
+    bench::ScopedSilence quiet;
+    std::vector<std::string> titles;
+    std::vector<bench::BenchTrack*> tracks;
+    for (size_t i = 0; i < kTracks; ++i) {
+        titles.push_back("Destination (ASOT 2024 Anthem) - Extended Mix #" + std::to_string(i));
+        tracks.push_back(new bench::BenchTrack(titles.back()));
+    }
+    bench::Rng rng(7);
+    std::vector<size_t> picks(kOps);
+    for (size_t i = 0; i < kOps; ++i)
+        picks[i] = rng.below(kTracks);
+
+    std::printf("%zu tracks, %zu-character titles, %zu lookups\n", kTracks, titles[0].size(), kOps);
+    std::printf("%-32s %12s %12s %8s\n", "", "by title", "by TrackId", "speedup");
+
+    // Cache index: a title-keyed hash map, as LRUCache used before, versus the id array.
+    std::unordered_map<std::string, size_t> title_index;
+    for (size_t i = 0; i < kTracks; ++i)
+        title_index[titles[i]] = i;
+    uint64_t start = bench::now_ns();
+    for (size_t i = 0; i < kOps; ++i)
+        bench::do_not_optimize(title_index.find(titles[picks[i]])->second);
+    double map_ns = ns_per_op(start, kOps);
+
+    LRUCache cache(kTracks);
+    for (bench::BenchTrack* track : tracks)
+        cache.put(track->clone());
+    start = bench::now_ns();
+    for (size_t i = 0; i < kOps; ++i)
+        bench::do_not_optimize(cache.get(tracks[picks[i]]->get_id()));
+    double id_get_ns = ns_per_op(start, kOps);
+    start = bench::now_ns();
+    for (size_t i = 0; i < kOps; ++i)
+        bench::do_not_optimize(cache.get(titles[picks[i]]));
+    double title_get_ns = ns_per_op(start, kOps);
+    report("cache index lookup", map_ns, id_get_ns);
+    report("LRUCache::get (title wrapper)", title_get_ns, id_get_ns);
+
+    // Playlist scan: string compare per node versus integer compare per node.
+    Playlist playlist("TrackId bench");
+    for (size_t i = 0; i < kPlaylist; ++i)
+        playlist.add_track(tracks[i]);
+    const size_t scans = kOps / 100;
+    start = bench::now_ns();
+    for (size_t i = 0; i < scans; ++i) {
+        const std::string& wanted = titles[picks[i] % kPlaylist];
+        AudioTrack* found = nullptr;
+        playlist.for_each_track([&](AudioTrack& track) {
+            if (!found && track.get_title() == wanted)
+                found = &track;
+        });
+        bench::do_not_optimize(found);
+    }
+    double scan_title_ns = ns_per_op(start, scans);
+    start = bench::now_ns();
+    for (size_t i = 0; i < scans; ++i)
+        bench::do_not_optimize(playlist.find_track(tracks[picks[i] % kPlaylist]->get_id()));
+    double scan_id_ns = ns_per_op(start, scans);
+    report("Playlist::find_track (512)", scan_title_ns, scan_id_ns);
+
+    // Policy replay: the session's trace replayed by title versus by id.
+    std::vector<TrackId> ids(kTracks);
+    for (size_t i = 0; i < kTracks; ++i)
+        ids[i] = tracks[i]->get_id();
+    CacheSimulator by_title(kTracks / 4, "arc");
+    start = bench::now_ns();
+    for (size_t i = 0; i < kOps; ++i)
+        by_title.access(titles[picks[i]]);
+    double replay_title_ns = ns_per_op(start, kOps);
+    CacheSimulator by_id(kTracks / 4, "arc");
+    start = bench::now_ns();
+    for (size_t i = 0; i < kOps; ++i)
+        by_id.access(ids[picks[i]]);
+    double replay_id_ns = ns_per_op(start, kOps);
+    report("CacheSimulator::access (ARC)", replay_title_ns, replay_id_ns);
+    bool ok = by_title.getHits() == by_id.getHits();
+    if (!ok)
+        std::printf("MISMATCH: %zu vs %zu hits\n", by_title.getHits(), by_id.getHits());
+
+    // Clones carry their id: the registry must not grow.
+    TrackRegistry& registry = TrackRegistry::instance();
+    size_t interned = registry.size();
+    for (bench::BenchTrack* track : tracks)
+        ok = ok && track->clone()->get_id() == track->get_id();
+    ok = ok && registry.size() == interned;
+
+    // A track built outside the library has no id until a playlist needs one.
+    {
+        size_t before = registry.size();
+        PointerWrapper<AudioTrack> stray(new MP3Track("Never Interned Track", std::vector<std::string>(), 200, 120, 320));
+        LRUCache cache(4);
+        ok = ok && stray->get_id() == INVALID_TRACK_ID && registry.size() == before &&
+             !cache.put(stray->clone()) && cache.size() == 0;
+        Playlist playlist("Stray");
+        playlist.add_track(stray.get());
+        ok = ok && stray->get_id() != INVALID_TRACK_ID && registry.size() == before + 1 &&
+             playlist.find_track("Never Interned Track") == stray.get();
+    }
+
+    std::printf("\n%-10s %16s %16s %16s\n", "threads", "one mutex find", "sharded find", "title(id)");
+    LockedTitleIndex locked(titles);
+    const size_t thread_counts[] = {1, 2, 4, 8};
+    for (size_t threads : thread_counts) {
+        double locked_ns = threaded_ns(threads, picks, [&](size_t i) { bench::do_not_optimize(locked.find(titles[i])); });
+        double find_ns = threaded_ns(threads, picks, [&](size_t i) { bench::do_not_optimize(registry.find(titles[i])); });
+        double title_ns = threaded_ns(threads, picks, [&](size_t i) {
+            bench::do_not_optimize(registry.title(ids[i]).size());
+        });
+        std::printf("%-10zu %13.1f ns %13.1f ns %13.1f ns\n", threads, locked_ns, find_ns, title_ns);
+    }
+    for (size_t i = 0; i < kTracks; ++i)
+        ok = ok && registry.find(titles[i]) == ids[i] && registry.title(ids[i]) == titles[i];
+
+    for (bench::BenchTrack* track : tracks)
+        delete track;
+    std::printf("%s\n", ok ? "TrackId check passed" : "TrackId check FAILED");
+    return ok ? 0 : 1;
+}
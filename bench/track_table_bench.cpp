@@ -0,0 +1,126 @@
+/**
+ * Devirtualized track table: scoring, filtering and ranking 1M tracks
+ * through AudioTrack* (one heap object and one virtual call per track)
+ * versus through the contiguous TrackTable (24-byte records, visitor
+ * dispatch inlined into the loop). Both paths must agree exactly.
+ */
+#include "BenchUtils.h"
+#include "MP3Track.h"
+#include "TrackTable.h"
+#include "WAVTrack.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t kTracks = 1000000;
+const size_t kTop = 100;
+const int kRepeats = 10;
+
+const int kBitrates[] = {96, 128, 192, 256, 320};
+const int kSampleRates[] = {22050, 44100, 48000, 96000};
+const int kBitDepths[] = {8, 16, 24, 32};
+
+bool wanted(int bpm, double score) {
+    return bpm >= 124 && bpm <= 130 && score >= 90.0;
+}
+
+double ms_per_pass(uint64_t start) {
+    return static_cast<double>(bench::now_ns() - start) / 1e6 / kRepeats;
+}
+
+void report(const char* label, double virtual_ms, double table_ms) {
+    std::printf("%-22s %10.2f ms %10.2f ms %7.1fx\n", label, virtual_ms, table_ms, virtual_ms / table_ms);
+}
+
+} // namespace
+
+int main() {
+    std::vector<AudioTrack*> tracks;
+    TrackTable table;
+    tracks.reserve(kTracks);
+    table.reserve(kTracks);
+    {
+        bench::ScopedSilence quiet;
+        bench::Rng rng(17);
+        const std::vector<std::string> artists(1, "Bench");
+        for (size_t i = 0; i < kTracks; ++i) {
+            int bpm = 110 + static_cast<int>(rng.below(30));
+            std::string title = "Table Track #" + std::to_string(i);
+            if (rng.below(2))
+                tracks.push_back(new MP3Track(title, artists, 300, bpm, kBitrates[rng.below(5)], rng.below(2) != 0));
+            else
+                tracks.push_back(new WAVTrack(title, artists, 300, bpm, kSampleRates[rng.below(4)],
+                                              kBitDepths[rng.below(4)]));
+            tracks.back()->intern_id();
+            table.add(*tracks.back());
+        }
+    }
+    std::printf("%zu tracks: AudioTrack objects %zu+ bytes each, TrackRecord %zu bytes\n", kTracks,
+                sizeof(MP3Track), sizeof(TrackRecord));
+    std::printf("%-22s %13s %13s %8s\n", "", "virtual", "TrackTable", "speedup");
+
+    std::vector<double> virtual_scores(kTracks), table_scores;
+    uint64_t start = bench::now_ns();
+    for (int r = 0; r < kRepeats; ++r) {
+        for (size_t i = 0; i < kTracks; ++i)
+            virtual_scores[i] = tracks[i]->get_quality_score();
+        bench::do_not_optimize(virtual_scores[0]);
+    }
+    double score_virtual = ms_per_pass(start);
+    start = bench::now_ns();
+    for (int r = 0; r < kRepeats; ++r) {
+        table.quality_scores(table_scores);
+        bench::do_not_optimize(table_scores[0]);
+    }
+    double score_table = ms_per_pass(start);
+    report("score all", score_virtual, score_table);
+
+    std::vector<size_t> virtual_rows, table_rows;
+    start = bench::now_ns();
+    for (int r = 0; r < kRepeats; ++r) {
+        virtual_rows.clear();
+        for (size_t i = 0; i < kTracks; ++i)
+            if (wanted(tracks[i]->get_bpm(), tracks[i]->get_quality_score()))
+                virtual_rows.push_back(i);
+        bench::do_not_optimize(virtual_rows.size());
+    }
+    double filter_virtual = ms_per_pass(start);
+    start = bench::now_ns();
+    for (int r = 0; r < kRepeats; ++r) {
+        table.filter([](const TrackRecord& record) { return wanted(record.bpm(), record.quality_score()); },
+                     table_rows);
+        bench::do_not_optimize(table_rows.size());
+    }
+    double filter_table = ms_per_pass(start);
+    report("filter bpm+quality", filter_virtual, filter_table);
+    bool agree = virtual_rows == table_rows;
+
+    start = bench::now_ns();
+    for (int r = 0; r < kRepeats; ++r) {
+        for (size_t i = 0; i < kTracks; ++i)
+            virtual_scores[i] = tracks[i]->get_quality_score();
+        virtual_rows.resize(kTracks);
+        for (size_t i = 0; i < kTracks; ++i)
+            virtual_rows[i] = i;
+        std::partial_sort(virtual_rows.begin(), virtual_rows.begin() + kTop, virtual_rows.end(),
+                          [&virtual_scores](size_t a, size_t b) {
+            return virtual_scores[a] != virtual_scores[b] ? virtual_scores[a] > virtual_scores[b] : a < b;
+        });
+        virtual_rows.resize(kTop);
+    }
+    double rank_virtual = ms_per_pass(start);
+    start = bench::now_ns();
+    for (int r = 0; r < kRepeats; ++r)
+        table.rank_by_quality(kTop, table_rows);
+    double rank_table = ms_per_pass(start);
+    report("rank top 100", rank_virtual, rank_table);
+    agree = agree && virtual_rows == table_rows && virtual_scores == table_scores;
+    std::printf("results %s\n", agree ? "identical" : "DIFFER");
+
+    for (AudioTrack* track : tracks)
+        delete track;
+    return agree ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+/**
+ * Memory-mapped WAV reader. First writes small files in every supported
+ * sample format (plus LIST/INFO and cue chunks) and checks that WavFile
+ * reads them back, and that a WAVTrack given a file takes its sample rate,
+ * bit depth, duration and detected tempo from it; exits non-zero on any
+ * mismatch. Then compares opening a
+ * large hi-res file by mmap against reading it into memory, and times a
+ * one-second decode from the middle of the mapped file.
+ */
+#include "BenchUtils.h"
+#include "WAVTrack.h"
+#include "WavFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const unsigned kHiResRate = 96000;
+const size_t kHiResSeconds = 360;
+const size_t kCheckFrames = 4801;   // odd, so the data chunk needs a pad byte at 24-bit mono
+
+int g_failures = 0;
+
+void put_u16(std::string& out, uint32_t v) {
+    out += static_cast<char>(v & 0xFF);
+    out += static_cast<char>((v >> 8) & 0xFF);
+}
+
+void put_u32(std::string& out, uint32_t v) {
+    put_u16(out, v & 0xFFFF);
+    put_u16(out, v >> 16);
+}
+
+void put_chunk(std::string& out, const char* id, const std::string& body) {
+    out.append(id, 4);
+    put_u32(out, static_cast<uint32_t>(body.size()));
+    out += body;
+    if (body.size() & 1)
+        out += '\0';
+}
+
+double test_signal(size_t frame, unsigned channel) {
+    return 0.8 * std::sin(0.01 * frame + channel);
+}
+
+const unsigned kBeatRate = 22050;
+const double kBeatBpm = 120.0;
+
+// Decaying noise bursts on every beat over a quiet noise floor
+double beat_signal(size_t frame, unsigned channel) {
+    uint32_t hash = static_cast<uint32_t>(frame * 2654435761u + channel * 40503u);
+    double noise = static_cast<double>((hash >> 8) & 0xFFFF) / 32768.0 - 1.0;
+    size_t period = static_cast<size_t>(kBeatRate * 60.0 / kBeatBpm);
+    return (0.02 + 0.9 * std::exp(-static_cast<double>(frame % period) / (0.04 * kBeatRate))) * noise;
+}
+
+void put_sample(std::string& out, double value, unsigned bits, bool is_float) {
+    if (is_float && bits == 32) {
+        float f = static_cast<float>(value);
+        uint32_t raw;
+        std::memcpy(&raw, &f, 4);
+        put_u32(out, raw);
+    } else if (is_float) {
+        uint64_t raw;
+        std::memcpy(&raw, &value, 8);
+        put_u32(out, static_cast<uint32_t>(raw));
+        put_u32(out, static_cast<uint32_t>(raw >> 32));
+    } else {
+        double scale = std::ldexp(1.0, static_cast<int>(bits) - 1);
+        int64_t q = static_cast<int64_t>(std::floor(value * scale));
+        for (unsigned b = 0; b < bits; b += 8)
+            out += static_cast<char>((q >> b) & 0xFF);
+    }
+}
+
+// Builds a complete RIFF/WAVE image; `extensible` writes WAVE_FORMAT_EXTENSIBLE.
+std::string make_wav(unsigned channels, unsigned rate, unsigned bits, bool is_float, bool extensible, size_t frames,
+                     bool with_metadata, double (*signal)(size_t, unsigned) = test_signal) {
+    unsigned block_align = channels * bits / 8;
+    uint16_t tag = is_float ? 3 : 1;
+    std::string fmt;
+    put_u16(fmt, extensible ? 0xFFFE : tag);
+    put_u16(fmt, channels);
+    put_u32(fmt, rate);
+    put_u32(fmt, rate * block_align);
+    put_u16(fmt, block_align);
+    put_u16(fmt, bits);
+    if (extensible) {
+        put_u16(fmt, 22);
+        put_u16(fmt, bits);
+        put_u32(fmt, 0);
+        put_u16(fmt, tag);
+        fmt.append("\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71", 14);
+    }
+    std::string body("WAVE");
+    put_chunk(body, "fmt ", fmt);
+    if (with_metadata) {
+        std::string info("INFO");
+        put_chunk(info, "INAM", std::string("Bench Tone\0", 11));
+        put_chunk(info, "IART", std::string("Bench\0", 6));
+        put_chunk(body, "LIST", info);
+    }
+    std::string data;
+    data.reserve(frames * block_align);
+    for (size_t i = 0; i < frames; ++i)
+        for (unsigned c = 0; c < channels; ++c)
+            put_sample(data, signal(i, c), bits, is_float);
+    put_chunk(body, "data", data);
+    if (with_metadata) {
+        std::string cue;
+        put_u32(cue, 2);
+        for (uint32_t id = 1; id <= 2; ++id) {
+            put_u32(cue, id);
+            put_u32(cue, 0);
+            cue.append("data", 4);
+            put_u32(cue, 0);
+            put_u32(cue, 0);
+            put_u32(cue, id * 1000);
+        }
+        put_chunk(body, "cue ", cue);
+    }
+    std::string file("RIFF");
+    put_u32(file, static_cast<uint32_t>(body.size()));
+    return file + body;
+}
+
+void write_file(const std::string& path, const std::string& bytes) {
+    std::ofstream out(path.c_str(), std::ios::binary);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+void check_format(const char* label, unsigned channels, unsigned bits, bool is_float, bool extensible) {
+    const std::string path = "/tmp/dj_wav_check.wav";
+    write_file(path, make_wav(channels, 48000, bits, is_float, extensible, kCheckFrames, true));
+    WavFile file;
+    bool ok = file.open(path);
+    double worst = 0.0;
+    if (ok) {
+        const PcmView& pcm = file.pcm();
+        ok = pcm.frames() == kCheckFrames && pcm.channels() == channels && pcm.bits_per_sample() == bits &&
+             pcm.is_float() == is_float && file.sample_rate() == 48000 && file.cue_points().size() == 2 &&
+             file.cue_points()[1].sample_offset == 2000 && file.info().count("INAM") &&
+             file.info().at("INAM") == "Bench Tone";
+        std::vector<double> decoded(kCheckFrames);
+        for (unsigned c = 0; c < channels && ok; ++c) {
+            pcm.decode(0, kCheckFrames, c, decoded.data());
+            for (size_t i = 0; i < kCheckFrames; ++i)
+                worst = std::max(worst, std::fabs(decoded[i] - test_signal(i, c)));
+        }
+        double tolerance = is_float ? (bits == 32 ? 1e-7 : 0.0) : std::ldexp(1.0, 1 - static_cast<int>(bits));
+        ok = ok && worst <= tolerance;
+    }
+    std::printf("%-26s %s (max error %.3g)%s%s\n", label, ok ? "ok  " : "FAIL", worst,
+                file.error().empty() ? "" : ": ", file.error().c_str());
+    if (!ok)
+        ++g_failures;
+    std::remove(path.c_str());
+}
+
+// Configured as 300 s of 44.1 kHz/24-bit at 128 BPM; the file says otherwise.
+void check_track() {
+    const std::string path = "/tmp/dj_wav_track.wav";
+    const size_t seconds = 20;
+    write_file(path, make_wav(2, kBeatRate, 16, false, false, kBeatRate * seconds, false, beat_signal));
+    bool ok;
+    double tempo;
+    {
+        bench::ScopedSilence quiet;
+        WAVTrack track("WAV Check Track", std::vector<std::string>(1, "Bench"), 300, 128, 44100, 24, path);
+        track.load();
+        track.analyze_beatgrid();
+        tempo = track.get_tempo();
+        ok = track.get_sample_rate() == static_cast<int>(kBeatRate) && track.get_bit_depth() == 16 &&
+             track.get_duration() == static_cast<int>(seconds) && std::fabs(tempo - kBeatBpm) < 0.5;
+    }
+    std::printf("%-26s %s (%d s of %u Hz, detected %.2f BPM)\n", "WAVTrack from file", ok ? "ok  " : "FAIL",
+                static_cast<int>(seconds), kBeatRate, tempo);
+    if (!ok)
+        ++g_failures;
+    std::remove(path.c_str());
+}
+
+double ms_since(uint64_t start) {
+    return static_cast<double>(bench::now_ns() - start) / 1e6;
+}
+
+} // namespace
+
+int main() {
+    check_format("16-bit PCM stereo", 2, 16, false, false);
+    check_format("24-bit PCM mono", 1, 24, false, false);
+    check_format("24-bit extensible stereo", 2, 24, false, true);
+    check_format("32-bit PCM stereo", 2, 32, false, false);
+    check_format("32-bit float stereo", 2, 32, true, false);
+    check_format("64-bit float mono", 1, 64, true, false);
+    check_track();
+
+    const std::string small_path = "/tmp/dj_wav_small.wav";
+    const std::string large_path = "/tmp/dj_wav_large.wav";
+    write_file(small_path, make_wav(2, kHiResRate, 24, false, false, kHiResRate, false));
+    write_file(large_path, make_wav(2, kHiResRate, 24, false, false, kHiResRate * kHiResSeconds, false));
+
+    WavFile small, large;
+    uint64_t start = bench::now_ns();
+    small.open(small_path);
+    double small_open_ms = ms_since(start);
+    start = bench::now_ns();
+    large.open(large_path);
+    double large_open_ms = ms_since(start);
+
+    start = bench::now_ns();
+    std::vector<char> copy;
+    {
+        std::ifstream in(large_path.c_str(), std::ios::binary | std::ios::ate);
+        copy.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(copy.data(), static_cast<std::streamsize>(copy.size()));
+    }
+    double read_ms = ms_since(start);
+    bench::do_not_optimize(copy[copy.size() / 2]);
+    copy.clear();
+    copy.shrink_to_fit();
+
+    std::vector<double> second(kHiResRate);
+    start = bench::now_ns();
+    large.pcm().decode(large.pcm().frames() / 2, kHiResRate, 0, second.data());
+    double decode_ms = ms_since(start);
+
+    std::printf("96 kHz/24-bit stereo, 1 s file (%.1f MB): mmap open %.3f ms\n", small.file_size() / 1e6,
+                small_open_ms);
+    std::printf("96 kHz/24-bit stereo, %zu s file (%.1f MB): mmap open %.3f ms, read into memory %.1f ms\n",
+                kHiResSeconds, large.file_size() / 1e6, large_open_ms, read_ms);
+    std::printf("decode 1 s from the middle of the mapped file: %.2f ms\n", decode_ms);
+
+    std::remove(small_path.c_str());
+    std::remove(large_path.c_str());
+    std::printf("%s\n", g_failures ? "WAV format check FAILED" : "WAV format check passed");
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * Compact waveform storage: bytes per sample, encode cost, decode throughput
+ * (scalar versus SSE2/AVX2 conversion kernels) and quantization error for
+ * each WaveformFormat on a 1M-sample buffer.
+ */
+#include "BenchUtils.h"
+#include "WaveformBuffer.h"
+#include "WaveformPool.h"
+#include "WaveformRandom.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const size_t kSamples = 1 << 20;
+const int kRepeats = 10;
+
+template<typename Fn>
+double best_ms(Fn fn) {
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < kRepeats; ++r) {
+        uint64_t start = bench::now_ns();
+        fn();
+        best = std::min(best, bench::now_ns() - start);
+    }
+    return static_cast<double>(best) / 1e6;
+}
+
+} // namespace
+
+int main() {
+    std::vector<double> source(kSamples);
+    WaveformRandom::fill(source.data(), kSamples, 99);
+    // Shape the noise with a slow envelope, so per-block scales matter.
+    for (size_t i = 0; i < kSamples; ++i)
+        source[i] *= 0.05 + 0.95 * std::fabs(std::sin(i * 1e-4));
+    std::vector<double> decoded(kSamples);
+
+    std::vector<const WaveformKernels::Table*> tables(1, &WaveformKernels::scalar());
+    if (WaveformKernels::sse2()) tables.push_back(WaveformKernels::sse2());
+    if (WaveformKernels::avx2()) tables.push_back(WaveformKernels::avx2());
+
+    std::printf("Waveform formats on %zu samples (best of %d)\n", kSamples, kRepeats);
+    std::printf("%-8s %9s %7s %10s %10s  %s\n", "format", "B/sample", "ratio", "encode ms", "SNR dB", "decode ms");
+    const WaveformFormat formats[] = {WaveformFormat::Float64, WaveformFormat::Float32,
+                                      WaveformFormat::Int16, WaveformFormat::Int8};
+    for (WaveformFormat format : formats) {
+        double encode_ms = best_ms([&]() {
+            WaveformBuffer buffer(source.data(), kSamples, format);
+            bench::do_not_optimize(buffer);
+        });
+        WaveformBuffer buffer(source.data(), kSamples, format);
+        double bytes_per_sample = static_cast<double>(buffer.storage_bytes()) / kSamples;
+
+        buffer.decode(0, kSamples, decoded.data());
+        double signal = 0.0, noise = 0.0;
+        for (size_t i = 0; i < kSamples; ++i) {
+            signal += source[i] * source[i];
+            noise += (source[i] - decoded[i]) * (source[i] - decoded[i]);
+        }
+        char snr[16];
+        if (noise > 0.0)
+            std::snprintf(snr, sizeof(snr), "%.1f", 10.0 * std::log10(signal / noise));
+        else
+            std::snprintf(snr, sizeof(snr), "exact");
+
+        std::printf("%-8s %9.3f %6.1fx %10.2f %10s ", WaveformBuffer::format_name(format), bytes_per_sample,
+                    8.0 / bytes_per_sample, encode_ms, snr);
+        for (const WaveformKernels::Table* table : tables) {
+            double ms = best_ms([&]() {
+                buffer.decode(0, kSamples, decoded.data(), *table);
+                bench::do_not_optimize(decoded[kSamples / 2]);
+            });
+            std::printf(" %s %.2f", table->name, ms);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
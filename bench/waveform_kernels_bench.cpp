@@ -0,0 +1,99 @@
+/**
+ * WaveformKernels micro-benchmark: each kernel on a 1M-sample buffer with the
+ * scalar, SSE2 and AVX2 tables (those the CPU supports), reporting time per
+ * call, speedup over scalar and the largest deviation from the scalar result.
+ */
+#include "BenchUtils.h"
+#include "WaveformKernels.h"
+#include "WaveformPool.h"
+#include "WaveformRandom.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const size_t kSamples = 1 << 20;
+const int kRepeats = 20;
+
+struct Result {
+    double ns;
+    double value;
+};
+
+template<typename Fn>
+Result time_kernel(Fn fn) {
+    Result result = {0.0, 0.0};
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < kRepeats; ++r) {
+        uint64_t start = bench::now_ns();
+        result.value = fn();
+        best = std::min(best, bench::now_ns() - start);
+    }
+    result.ns = static_cast<double>(best);
+    return result;
+}
+
+void run_kernel(const char* name, const std::vector<const WaveformKernels::Table*>& tables,
+                double (*kernel)(const WaveformKernels::Table&)) {
+    std::printf("%-18s", name);
+    double scalar_ns = 0.0, scalar_value = 0.0;
+    for (const WaveformKernels::Table* table : tables) {
+        Result r = time_kernel([&]() { return kernel(*table); });
+        if (table == tables.front()) {
+            scalar_ns = r.ns;
+            scalar_value = r.value;
+        }
+        double deviation = std::fabs(r.value - scalar_value) / std::max(1e-300, std::fabs(scalar_value));
+        std::printf("  %s %8.0f us x%4.1f (dev %.0e)", table->name, r.ns / 1e3, scalar_ns / r.ns, deviation);
+    }
+    std::printf("\n");
+}
+
+const double* g_data = nullptr;
+
+double k_rms(const WaveformKernels::Table& t) {
+    return WaveformKernels::stats(g_data, kSamples, t).rms;
+}
+double k_peak(const WaveformKernels::Table& t) {
+    return t.peak_abs(g_data, kSamples);
+}
+double k_crest(const WaveformKernels::Table& t) {
+    return WaveformKernels::stats(g_data, kSamples, t).crest_factor;
+}
+double k_zcr(const WaveformKernels::Table& t) {
+    return static_cast<double>(t.zero_crossings(g_data, kSamples));
+}
+double k_envelope(const WaveformKernels::Table& t) {
+    std::vector<double> env = WaveformKernels::energy_envelope(g_data, kSamples, 1024, t);
+    return env[env.size() / 2];
+}
+double k_minmax(const WaveformKernels::Table& t) {
+    std::vector<WaveformMinMax> mm = WaveformKernels::min_max_downsample(g_data, kSamples, 1920, t);
+    return mm[mm.size() / 2].max - mm[mm.size() / 2].min;
+}
+
+} // namespace
+
+int main() {
+    double* data = WaveformPool::instance().allocate(kSamples);
+    WaveformRandom::fill(data, kSamples, 1234);
+    g_data = data;
+
+    std::vector<const WaveformKernels::Table*> tables(1, &WaveformKernels::scalar());
+    if (WaveformKernels::sse2()) tables.push_back(WaveformKernels::sse2());
+    if (WaveformKernels::avx2()) tables.push_back(WaveformKernels::avx2());
+    std::printf("Waveform kernels on %zu samples (best of %d), active: %s\n",
+                kSamples, kRepeats, WaveformKernels::active().name);
+
+    run_kernel("rms", tables, k_rms);
+    run_kernel("peak", tables, k_peak);
+    run_kernel("crest factor", tables, k_crest);
+    run_kernel("zero crossings", tables, k_zcr);
+    run_kernel("energy env/1024", tables, k_envelope);
+    run_kernel("min/max 1920 px", tables, k_minmax);
+
+    WaveformPool::instance().release(data, kSamples);
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * WaveformPool benchmark: allocate/fill/free churn of waveform-sized buffers,
+ * as produced by clone/evict cycles (a clone writes every sample), through
+ * the pool versus plain new[]/delete[] and versus posix_memalign()/free(), the
+ * way to keep the pool's 64-byte alignment without it. Sizes straddle the size classes, so
+ * the slack column shows what rounding up costs in memory. Also verifies the
+ * 64-byte alignment and that no request above 256 bytes wastes more than a
+ * quarter of itself (exit status 1 otherwise), and prints the pool counters.
+ */
+#include "BenchUtils.h"
+#include "WaveformPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace {
+
+const size_t kBytesPerRound = size_t(1) << 31;   // samples written per column, in bytes
+const size_t kLive = 64;                         // buffers alive at once (cache + decks)
+const int kPasses = 3;                           // timings are the best pass
+const double kMaxSlack = 0.25;
+const size_t kMinSlackSamples = 33;              // first request above the 256-byte linear classes
+
+template<typename Alloc, typename Free>
+double churn(size_t samples, Alloc alloc, Free release) {
+    size_t rounds = std::max<size_t>(kBytesPerRound / (samples * sizeof(double)), 4 * kLive);
+    double best = 0.0;
+    for (int pass = 0; pass < kPasses; ++pass) {
+        std::vector<double*> live(kLive, nullptr);
+        bench::Rng rng(7);
+        uint64_t start = bench::now_ns();
+        for (size_t i = 0; i < rounds; ++i) {
+            size_t slot = rng.below(kLive);
+            if (live[slot])
+                release(live[slot], samples);
+            live[slot] = alloc(samples);
+            std::fill(live[slot], live[slot] + samples, static_cast<double>(i));
+        }
+        double ns = static_cast<double>(bench::now_ns() - start) / rounds;
+        best = pass == 0 ? ns : std::min(best, ns);
+        for (double* block : live)
+            if (block)
+                release(block, samples);
+    }
+    return best;
+}
+
+// Largest (class - request) / request from kMinSlackSamples up to max_bytes;
+// below that the 64-byte minimum class dominates.
+double worst_slack(size_t max_bytes) {
+    double worst = 0.0;
+    for (size_t samples = kMinSlackSamples; samples * sizeof(double) <= max_bytes; samples += 1 + samples / 64) {
+        double requested = static_cast<double>(samples * sizeof(double));
+        worst = std::max(worst, (WaveformPool::blockBytes(samples) - requested) / requested);
+    }
+    return worst;
+}
+
+} // namespace
+
+int main() {
+    WaveformPool& pool = WaveformPool::instance();
+    std::printf("Allocate+fill+free churn, %zu live buffers, ns per round (best of %d)\n", kLive, kPasses);
+    std::printf("%10s %12s %12s %12s %9s %8s %10s\n", "samples", "new[] ns", "memalign ns", "pool ns", "pool/new",
+                "slack", "aligned");
+    const size_t sizes[] = {1000, 1100, 10000, 13000, 100000, 140000};
+    bool ok = true;
+    for (size_t samples : sizes) {
+        double heap_ns = churn(samples,
+            [](size_t n) { return new double[n]; },
+            [](double* p, size_t) { delete[] p; });
+        double memalign_ns = churn(samples,
+            [](size_t n) {
+                void* p = nullptr;
+                if (posix_memalign(&p, WaveformPool::ALIGNMENT, n * sizeof(double)) != 0)
+                    throw std::bad_alloc();
+                return static_cast<double*>(p);
+            },
+            [](double* p, size_t) { std::free(p); });
+        bool aligned = true;
+        double pool_ns = churn(samples,
+            [&](size_t n) {
+                double* p = pool.allocate(n);
+                aligned = aligned && reinterpret_cast<uintptr_t>(p) % WaveformPool::ALIGNMENT == 0;
+                return p;
+            },
+            [&](double* p, size_t n) { pool.release(p, n); });
+        double requested = static_cast<double>(samples * sizeof(double));
+        double slack = (WaveformPool::blockBytes(samples) - requested) / requested;
+        std::printf("%10zu %12.1f %12.1f %12.1f %8.2fx %7.1f%% %10s\n", samples, heap_ns, memalign_ns, pool_ns,
+                    pool_ns / heap_ns, slack * 100, aligned ? "yes" : "NO");
+        ok = ok && aligned;
+    }
+    double worst = worst_slack(WaveformPool::MAX_POOLED_BYTES);
+    ok = ok && worst <= kMaxSlack;
+    std::printf("Worst class slack, %zu B to %zu MiB: %.1f%% (limit %.0f%%)\n", kMinSlackSamples * sizeof(double),
+                WaveformPool::MAX_POOLED_BYTES >> 20, worst * 100, kMaxSlack * 100);
+    WaveformPool::Stats stats = pool.stats();
+    std::printf("Pool: %llu hits, %llu misses, %zu bytes outstanding, %zu bytes pooled\n",
+                static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+                stats.bytes_outstanding, stats.bytes_pooled);
+    std::printf("%s\n", ok ? "WaveformPool check passed" : "WaveformPool check FAILED");
+    return ok ? 0 : 1;
+}
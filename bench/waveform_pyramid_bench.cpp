@@ -0,0 +1,95 @@
+/**
+ * Zoomable overviews: 100 widths (64 to 32768 columns) over a 10M-sample
+ * waveform, drawn by reducing the samples each time versus from the shared
+ * WaveformPyramid. Columns narrower than 4 * BASE_BLOCK samples take the
+ * pyramid's exact sample path, timed separately at 100000 columns.
+ */
+#include "BenchUtils.h"
+#include "WaveformBuffer.h"
+#include "WaveformPyramid.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const size_t kSamples = 10000000;
+const size_t kWidths = 100;
+const size_t kFineWidth = 100000;
+
+// What a redraw costs without the pyramid: one pass over the samples.
+void reduce_samples(const double* data, size_t count, size_t width, std::vector<WaveformColumn>& columns) {
+    const WaveformKernels::Table& kernels = WaveformKernels::active();
+    width = std::min(width, count);
+    columns.resize(width);
+    for (size_t p = 0; p < width; ++p) {
+        size_t begin = p * count / width;
+        size_t length = (p + 1) * count / width - begin;
+        double lo, hi;
+        kernels.min_max(data + begin, length, &lo, &hi);
+        columns[p] = WaveformColumn(lo, hi, std::sqrt(kernels.sum_squares(data + begin, length) / length));
+    }
+}
+
+double ms_since(uint64_t start) {
+    return static_cast<double>(bench::now_ns() - start) / 1e6;
+}
+
+} // namespace
+
+int main() {
+    std::vector<size_t> widths;
+    for (size_t i = 0; i < kWidths; ++i)
+        widths.push_back(static_cast<size_t>(64.0 * std::pow(512.0, static_cast<double>(i) / (kWidths - 1))));
+
+    const WaveformFormat formats[] = {WaveformFormat::Float64, WaveformFormat::Int16};
+    for (WaveformFormat format : formats) {
+        WaveformBuffer buffer(kSamples, 2024, format);
+        std::vector<double> samples(kSamples);
+        buffer.decode(0, kSamples, samples.data());
+
+        uint64_t start = bench::now_ns();
+        const WaveformPyramid& pyramid = buffer.pyramid();
+        double build_ms = ms_since(start);
+
+        std::vector<WaveformColumn> exact, fast;
+        start = bench::now_ns();
+        for (size_t width : widths) {
+            reduce_samples(samples.data(), kSamples, width, exact);
+            bench::do_not_optimize(exact[0]);
+        }
+        double reduce_ms = ms_since(start);
+
+        start = bench::now_ns();
+        for (size_t width : widths) {
+            pyramid.overview(width, fast);
+            bench::do_not_optimize(fast[0]);
+        }
+        double pyramid_ms = ms_since(start);
+
+        start = bench::now_ns();
+        pyramid.overview(kFineWidth, fast);
+        double fine_ms = ms_since(start);
+
+        // Column edges snap to pyramid blocks, so columns cover slightly different samples.
+        double worst = 0.0;
+        for (size_t width : widths) {
+            reduce_samples(samples.data(), kSamples, width, exact);
+            pyramid.overview(width, fast);
+            for (size_t p = 0; p < width; ++p)
+                worst = std::max(worst, std::fabs(exact[p].rms - fast[p].rms) / std::max(exact[p].rms, 1e-12));
+        }
+
+        std::printf("%s, %zu samples: pyramid %zu levels, %.1f MB (%.1f%% of samples), built in %.1f ms\n",
+                    WaveformBuffer::format_name(format), kSamples, pyramid.levels(),
+                    pyramid.memory_bytes() / 1e6, 100.0 * pyramid.memory_bytes() / buffer.storage_bytes(),
+                    build_ms);
+        std::printf("  %zu widths: reduce samples %.1f ms (%.2f ms/query), pyramid %.2f ms (%.3f ms/query), %.0fx\n",
+                    kWidths, reduce_ms, reduce_ms / kWidths, pyramid_ms, pyramid_ms / kWidths,
+                    reduce_ms / pyramid_ms);
+        std::printf("  %zu columns (sample path): %.2f ms\n", kFineWidth, fine_ms);
+        std::printf("  max relative RMS difference from exact columns: %.2f%%\n", 100.0 * worst);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "BeatDetector.h"
+#include "WaveformKernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Process-wide cache of waveform analysis results, keyed by content
+ *
+ * Every trip of a track through the library, the controller cache and a
+ * deck works on a fresh clone, and each clone would otherwise rerun beat
+ * detection and waveform statistics. Results are stored here under
+ * AudioTrack::content_hash() (title, artists, duration and the waveform
+ * itself), so any clone or duplicate of the same content gets them without
+ * touching its samples.
+ *
+ * save()/load() persist the table as text. Generated waveforms hash by
+ * their seed, so persisted entries only match in later runs that use the
+ * same waveform_seed.
+ * All operations are thread-safe.
+ */
+class AnalysisCache {
+public:
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        size_t entries;
+    };
+
+    /**
+     * @brief Process-wide cache used by AudioTrack
+     */
+    static AnalysisCache& instance();
+
+    AnalysisCache(const AnalysisCache&) = delete;
+    AnalysisCache& operator=(const AnalysisCache&) = delete;
+
+    bool find_beat_grid(uint64_t key, BeatGrid& out);
+    void store_beat_grid(uint64_t key, const BeatGrid& grid);
+
+    bool find_stats(uint64_t key, WaveformStats& out);
+    void store_stats(uint64_t key, const WaveformStats& stats);
+
+    /**
+     * @brief Write every entry to a text file (one entry per line)
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * @brief Merge entries from a file written by save()
+     * @return false if the file cannot be read; malformed lines are skipped
+     */
+    bool load(const std::string& path);
+
+    void clear();
+    Stats stats() const;
+
+    // ========== CONTENT HASHING ==========
+
+    /**
+     * @brief Fold a 64-bit value into a running hash
+     */
+    static uint64_t combine(uint64_t hash, uint64_t value);
+
+    static uint64_t hash_string(uint64_t hash, const std::string& text);
+
+    /**
+     * @brief Hash raw bytes, 8 at a time
+     */
+    static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size);
+
+private:
+    struct Entry {
+        BeatGrid beat_grid;
+        WaveformStats stats;
+        bool has_beat_grid;
+        bool has_stats;
+
+        Entry() : beat_grid(), stats(), has_beat_grid(false), has_stats(false) {}
+    };
+
+    std::unordered_map<uint64_t, Entry> entries;
+    mutable std::mutex mutex;
+    uint64_t hits;
+    uint64_t misses;
+
+    AnalysisCache();
+};
@@ -2,6 +2,11 @@
 
 #include <string>
 #include "PointerWrapper.h"
+#include "WaveformBuffer.h"
+#include "WaveformPyramid.h"
+#include "BeatDetector.h"
+#include "TrackRegistry.h"
+#include <map>
 #include <memory>
 #include <vector>
 /**
@@ -15,10 +20,24 @@
  *   available for compatibility checks; results may be cached per instance.
  * - clone(): used at the cache→mixer boundary; mixer always receives a polymorphic clone
  *   and owns it; the cache retains its own copy.
+ * - The waveform is a shared, copy-on-write WaveformBuffer: copies and clones share it,
+ *   so cloning costs O(metadata) regardless of waveform size. It is generated lazily
+ *   on first read (WaveformRandom::seed makes it reproducible).
  * 
  */
 class AudioTrack {
 private:
+    // Memoized waveform analysis; dropped whenever the samples change
+    mutable WaveformStats waveform_stats;
+    mutable bool waveform_stats_ready;
+    mutable std::map<size_t, std::vector<double>> envelope_memo;          // window -> envelope
+    mutable std::map<size_t, std::vector<WaveformMinMax>> overview_memo;  // buckets -> overview
+    BeatGrid beat_grid;     // detected tempo/phase; reset with the memo above
+    mutable uint64_t content_key;       // AnalysisCache key, valid if content_key_ready
+    mutable bool content_key_ready;
+    TrackId track_id;   // TrackRegistry id of title (INVALID_TRACK_ID until intern_id()); the key caches and playlists compare
+
+    void invalidate_analysis();
     void clear();
     void copy_from(const AudioTrack& other);
     void move_from(AudioTrack&& other);
@@ -28,9 +47,41 @@ protected:
     std::vector<std::string> artists;
     int duration_seconds;
     int bpm;  // beats per minute for mixing
-    double* waveform_data;  // Dynamic array for audio analysis
+    std::shared_ptr<WaveformBuffer> waveform;  // Samples for audio analysis, shared by clones
     size_t waveform_size;   // Size of the waveform array
 
+    /**
+     * Heap bytes reachable from this track (string buffers plus the whole
+     * waveform_footprint()), excluding the object itself. Derived classes
+     * add sizeof(*this) in memory_footprint().
+     */
+    size_t heap_footprint() const;
+
+    /**
+     * Runs BeatDetector once per instance and stores the result on the track.
+     * The source is analysis_window() if the track provides one, else the
+     * waveform (taken to span duration_seconds). Results are shared
+     * process-wide through AnalysisCache, so clones and duplicates of the
+     * same content only analyze once.
+     * Waveforms too coarse to resolve a tempo yield an unreliable grid; the
+     * generated 1000-sample waveforms of config-only tracks always are, so
+     * those keep their tagged BPM.
+     */
+    const BeatGrid& detect_beat_grid();
+
+    /**
+     * Audio for beat detection at its real sample rate, starting at the
+     * beginning of the track (e.g. decoded from a mapped file). Returns
+     * false, the default, to analyze the waveform instead.
+     */
+    virtual bool analysis_window(std::vector<double>& samples, double& sample_rate) const;
+
+    /**
+     * Replace the configured duration with one measured from the file.
+     * Drops analysis that assumed the old duration (content hash, beat grid).
+     */
+    void set_duration(int seconds);
+
 public:
     /**
      * Constructor - initializes basic track information
@@ -50,6 +101,7 @@ public:
     /**
      * TODO: Implement copy constructor
      * HINT: Deep copy the waveform_data array
+     * (The waveform buffer is shared instead; see get_mutable_waveform_data.)
      */
     AudioTrack(const AudioTrack& other);
 
@@ -104,13 +156,119 @@ public:
 
     /**
      * Function to get a copy of the waveform data
+     * Converts compact formats back to double (SIMD).
      */
     void get_waveform_copy(double* buffer, size_t buffer_size) const;
+
+    /**
+     * Read-only view of the waveform samples (nullptr if there are none,
+     * or if they are stored in a compact format; use get_waveform_copy then)
+     */
+    const double* get_waveform_data() const;
+
+    /**
+     * Writable waveform samples. Copies the buffer first if it is shared
+     * with another track (copy-on-write), so other clones are unaffected.
+     * A compact waveform is expanded back to Float64 first.
+     */
+    double* get_mutable_waveform_data();
+
+    /**
+     * Storage format of the samples (Float64 unless configured otherwise).
+     * Changing it re-encodes this track's waveform (lazily, if it has not
+     * been generated yet) and drops earlier analysis; clones keep theirs.
+     */
+    WaveformFormat get_waveform_format() const;
+    void set_waveform_format(WaveformFormat format);
+
+    size_t get_waveform_size() const { return waveform_size; }
+
+    // ========== WAVEFORM ANALYSIS (SIMD, memoized per instance) ==========
+
+    /**
+     * RMS, peak, crest factor and zero-crossing rate of the waveform.
+     * Computed on first call with WaveformKernels::active() (or taken from
+     * AnalysisCache), then cached on the instance.
+     */
+    const WaveformStats& get_waveform_stats() const;
+
+    /**
+     * Mean energy of each consecutive `window`-sample block (cached per window)
+     */
+    const std::vector<double>& get_energy_envelope(size_t window) const;
+
+    /**
+     * Min/max of `buckets` equal slices of the waveform (cached per bucket count)
+     */
+    const std::vector<WaveformMinMax>& get_min_max_overview(size_t buckets) const;
+
+    /**
+     * Min/max/RMS columns for a `width`-pixel overview, in O(width) from the
+     * waveform's shared WaveformPyramid (built on first call). Meant for
+     * redraws at arbitrary zoom; reuse `columns` to avoid reallocating.
+     */
+    void get_waveform_overview(size_t width, std::vector<WaveformColumn>& columns) const;
+
+    /**
+     * Hash of title, artists, duration and waveform content (not the tagged
+     * BPM, which sync changes); the AnalysisCache key. Memoized; clones inherit it.
+     */
+    uint64_t content_hash() const;
+
+    /**
+     * Result of the last beat detection (analyzed == false if none ran yet)
+     */
+    const BeatGrid& get_beat_grid() const { return beat_grid; }
+
+    /**
+     * Tempo used for mixing: the detected BPM when reliable, else the tagged one
+     */
+    double get_tempo() const;
+
+    /**
+     * Time-stretch to a new tempo: updates the tagged BPM (rounded to the
+     * nearest whole BPM) and rescales the detected beat grid, if any.
+     */
+    void set_tempo(double target_bpm);
+
+    /**
+     * Bytes this track occupies in memory: the object itself, the heap
+     * storage of its strings and the whole waveform buffer (see
+     * heap_footprint). Used for byte-budgeted caching.
+     */
+    virtual size_t memory_footprint() const;
+
+    /**
+     * Bytes of the waveform buffer in full: the buffer object, its pyramid
+     * and, once generated (buffers are lazy), the pool block holding the
+     * samples (WaveformPool::blockBytes, not just the bytes requested). Clones share one
+     * buffer, so a cache holding several of them charges this once per
+     * get_waveform_buffer() and re-measures it as the buffer fills in.
+     */
+    size_t waveform_footprint() const;
+
+    /**
+     * The waveform buffer this track shares with its clones, for identity
+     * only (nullptr if there is none)
+     */
+    const WaveformBuffer* get_waveform_buffer() const { return waveform.get(); }
     
     // ========== ACCESSOR FUNCTIONS ==========
-    std::string get_title() const { return title; }
+    // Title and artists are returned by reference, so lookups never copy them.
+    const std::string& get_title() const { return title; }
+    TrackId get_id() const { return track_id; }
+
+    /**
+     * Give the track its TrackRegistry id, interning the title if it has
+     * none yet, and return it. Constructing a track does not intern: library
+     * tracks get their id in DJLibraryService::buildLibrary and a Playlist
+     * assigns one on add_track; every other track keeps INVALID_TRACK_ID, so
+     * short-lived tracks never grow the registry.
+     */
+    TrackId intern_id();
+
     int get_bpm() const { return bpm; }
     int get_duration() const { return duration_seconds; }
-    std::vector<std::string> get_artists() const { return artists; }
+    const std::vector<std::string>& get_artists() const { return artists; }
     void set_bpm(int new_bpm) { bpm = new_bpm; }
 };
\ No newline at end of file
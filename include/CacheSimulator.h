@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CacheSlot.h"
+#include "EvictionPolicy.h"
+#include "PointerWrapper.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Key-only replay of an eviction policy
+ *
+ * Mirrors LRUCache's slot/index/free-list bookkeeping but stores track ids
+ * instead of tracks, so a recorded access stream can be replayed against
+ * any policy without cloning, loading or logging. Used to compare policies
+ * on the exact workload a session produced.
+ */
+class CacheSimulator {
+private:
+    std::vector<CacheSlot> slots;               // policy metadata only; never hold tracks
+    std::vector<TrackId> keys;                  // id held by each slot
+    std::vector<size_t> charged;                // bytes charged to each slot
+    std::vector<size_t> index;                  // TrackId -> slot (npos if absent)
+    std::vector<size_t> free_slots;
+    PointerWrapper<EvictionPolicy> policy;
+    size_t byte_budget;
+    size_t bytes_used;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+
+public:
+    /**
+     * @param capacity Number of slots
+     * @param policy_name Policy to replay (see make_eviction_policy); unknown
+     *        names fall back to LRU
+     * @param byte_budget Byte limit as in LRUCache::set_byte_budget (0 = none)
+     */
+    CacheSimulator(size_t capacity, const std::string& policy_name, size_t byte_budget = 0);
+
+    CacheSimulator(const CacheSimulator&) = delete;
+    CacheSimulator& operator=(const CacheSimulator&) = delete;
+
+    /**
+     * @brief Replay one access (lookup, then insert on miss)
+     * @param bytes Footprint charged if the key is inserted
+     * @return true on hit
+     */
+    bool access(TrackId key, size_t bytes = 0);
+
+    /**
+     * @brief Same, by title (interned, so titles outside the library work too)
+     */
+    bool access(const std::string& title, size_t bytes = 0);
+
+    size_t getHits() const { return hits; }
+    size_t getMisses() const { return misses; }
+    size_t getEvictions() const { return evictions; }
+    double hitRatio() const;
+    const char* policyName() const { return policy->name(); }
+};
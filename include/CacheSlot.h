@@ -7,7 +7,7 @@
 
 /**
  * @brief Single Cache Entry with LRU Metadata (Single Responsibility)
- * 
+ *
  * Represents one slot in the DJ controller's limited memory.
  * Separates cache slot management from the larger cache algorithm,
  * following SRP and making the design easier to test and maintain.
@@ -16,50 +16,103 @@
  * - Each slot holds exactly one cached track instance owned by the controller.
  * - access() updates last_access_time to reflect MRU/LRU policy.
  * - clear() releases ownership; callers log evictions as needed.
+ * - prev/next thread an intrusive list through the slot array, so the owning
+ *   cache's eviction policy can touch and evict in O(1) without a side structure.
+ * - segment/frequency/key_hash are scratch fields owned by that policy (which
+ *   list the slot is on, use count, admission-sketch hash).
  */
 class CacheSlot {
 private:
     PointerWrapper<AudioTrack> track;    // The cached track
     uint64_t last_access_time;           // For LRU algorithm
     bool occupied;                       // Is this slot in use?
+    size_t prev;                         // Neighbour towards list head (npos if head)
+    size_t next;                         // Neighbour towards list tail (npos if tail)
+    uint8_t segment;                     // Policy list the slot is linked on
+    uint32_t frequency;                  // Policy use counter
+    uint64_t key_hash;                   // Policy hash of the cached title
+    size_t bytes;                        // Memory charged to the cache for the track alone
+    const WaveformBuffer* shared;        // Waveform charged once per cache, not per slot
 
 public:
+    /**
+     * @brief Sentinel index for "no neighbour" in the recency list
+     */
+    static const size_t npos;
+
     /**
      * @brief Construct empty cache slot
      */
     CacheSlot();
-    
+    CacheSlot(const CacheSlot&) = delete;
+    CacheSlot& operator=(const CacheSlot&) = delete;
+    CacheSlot(CacheSlot&&) = default;
+    CacheSlot& operator=(CacheSlot&&) = default;
+
     /**
      * @brief Store a track in this slot
      * @param track_ptr Track to store (transfers ownership)
      * @param access_time Current access timestamp
+     * @param charged_bytes Footprint charged against the cache's byte budget
      */
-    void store(PointerWrapper<AudioTrack> track_ptr, uint64_t access_time);
-    
+    void store(PointerWrapper<AudioTrack> track_ptr, uint64_t access_time, size_t charged_bytes = 0);
+
     /**
      * @brief Access the track (updates LRU timestamp)
      * @param access_time Current access timestamp
      * @return Raw pointer to track (does not transfer ownership)
      */
     AudioTrack* access(uint64_t access_time);
-    
+
     /**
      * @brief Clear this slot (removes track)
      */
     void clear();
-    
+
     /**
      * @brief Check if slot is occupied
      */
     bool isOccupied() const { return occupied; }
-    
+
     /**
      * @brief Get last access time for LRU comparison
      */
     uint64_t getLastAccessTime() const { return last_access_time; }
-    
+
     /**
      * @brief Get track without updating access time
      */
     AudioTrack* getTrack() const { return track.get(); }
-};
\ No newline at end of file
+
+    /**
+     * @brief Bytes charged for the stored track (0 when empty)
+     */
+    size_t getBytes() const { return bytes; }
+    void setBytes(size_t charged_bytes) { bytes = charged_bytes; }
+
+    /**
+     * @brief Waveform buffer the owning cache charged separately (nullptr if none)
+     */
+    const WaveformBuffer* getSharedBuffer() const { return shared; }
+    void setSharedBuffer(const WaveformBuffer* buffer) { shared = buffer; }
+
+    /**
+     * @brief Release the track without destroying it (slot becomes empty)
+     */
+    PointerWrapper<AudioTrack> take();
+
+    // ========== INTRUSIVE POLICY METADATA ==========
+    size_t getPrev() const { return prev; }
+    size_t getNext() const { return next; }
+    void setPrev(size_t idx) { prev = idx; }
+    void setNext(size_t idx) { next = idx; }
+    uint8_t getSegment() const { return segment; }
+    void setSegment(uint8_t seg) { segment = seg; }
+    uint32_t getFrequency() const { return frequency; }
+    void setFrequency(uint32_t freq) { frequency = freq; }
+    uint64_t getKeyHash() const { return key_hash; }
+    void setKeyHash(uint64_t hash) { key_hash = hash; }
+
+private:
+    void resetMetadata();
+};
@@ -4,11 +4,13 @@
 #include "LRUCache.h"
 #include "CacheSlot.h"
 #include "PointerWrapper.h"
+#include <functional>
 #include <string>
 
 /**
  * Service responsible for managing the controller's memory (cache)
- * Cache capacity is fixed, and the tracks are managed with LRU policy.
+ * Cache capacity is fixed, and the tracks are managed with LRU policy
+ * unless another eviction policy is configured (controller_cache_policy).
  * On HIT: touch MRU (most recently used); on MISS: insert; if full, evict LRU.
  * - Mixer always receives a polymorphic clone; cache retains its copy.
  */
@@ -22,6 +24,13 @@ public:
     // Output: An integer indicating the result: 1 for HIT, 0 for MISS without eviction, -1 for MISS with eviction.
     int loadTrackToCache(AudioTrack& track);
 
+    // Contract: Load a track ahead of demand without disturbing entries needed sooner
+    // Input: A reference to an AudioTrack, and a predicate that approves (true) or vetoes
+    //        each cached track (by id) that would have to be evicted to make room for it.
+    // Output: 1 if already cached (recency untouched), 0 loaded without eviction,
+    //         -1 loaded with eviction, -2 skipped (a victim was vetoed or the track never fits).
+    int prefetchTrackToCache(AudioTrack& track, const std::function<bool(TrackId)>& can_evict);
+
 
     // Contract: Display cache status (LRU order and occupancy)
     // - Intended for debugging and interactive inspection
@@ -33,6 +42,34 @@ public:
      * @note This function is meant for a single usage. don't call it more then once.
      */
     void set_cache_size(size_t new_size);
+
+    /**
+     * @brief Set the cache memory budget.
+     * @param bytes Budget in bytes; 0 limits the cache by slot count only.
+     */
+    void set_cache_bytes(size_t bytes);
+
+    /**
+     * @brief Select the cache eviction policy by config name.
+     * @param policy_name One of lru, lfu, 2q, arc, tinylfu.
+     * @return false (and keep the current policy) if the name is unknown.
+     */
+    bool set_cache_policy(const std::string& policy_name);
+
+    /**
+     * @brief Display name of the active eviction policy.
+     */
+    const char* get_cache_policy_name() const { return cache.policy_name(); }
+
+    /**
+     * @brief Get the cache capacity in slots.
+     */
+    size_t get_cache_capacity() const { return cache.capacity(); }
+
+    /**
+     * @brief Get the cache memory budget in bytes (0 if unlimited).
+     */
+    size_t get_cache_byte_budget() const { return cache.byteBudget(); }
     /**
      * @brief Get a track from the cache by its title.
      * @param track_title The title of the track to retrieve.
@@ -40,6 +77,11 @@ public:
      */
     AudioTrack* getTrackFromCache(const std::string& track_title);
 
+    /**
+     * @brief Get a track from the cache by its TrackId (no string hashing).
+     */
+    AudioTrack* getTrackFromCache(TrackId track_id);
+
 private:
     LRUCache cache;
 };
@@ -4,6 +4,7 @@
 #include "Playlist.h"
 #include "AudioTrack.h"
 #include "SessionFileParser.h"
+#include "TrackTable.h"
 #include <vector>
 #include <string>
 
@@ -14,7 +15,7 @@
 class DJLibraryService {
 public:
     DJLibraryService(const Playlist& playlist);
-    DJLibraryService(): playlist(), library(){}
+    DJLibraryService(): playlist(), library(), track_table(){}
     
     ~DJLibraryService();
 
@@ -44,6 +45,7 @@ public:
      * The library retains ownership of the track.
      */
     AudioTrack* findTrack(const std::string& track_title);
+    AudioTrack* findTrack(TrackId track_id);
 
     /**
      * @brief Get a vector of all track titles in the current playlist.
@@ -51,9 +53,26 @@ public:
      */
     std::vector<std::string> getTrackTitles() const;
 
+    /**
+     * @brief TrackIds of the current playlist, in playlist order.
+     */
+    std::vector<TrackId> getTrackIds() const;
+
+    /**
+     * @brief TrackIds of the library, in library order (config index i is element i - 1).
+     */
+    std::vector<TrackId> getLibraryTrackIds() const;
+
+    /**
+     * @brief Devirtualized mirror of the library, row i = library track i,
+     * for ranking and filtering the whole library in batch.
+     */
+    const TrackTable& getTrackTable() const { return track_table; }
+
 private:
     Playlist playlist;
     std::vector<AudioTrack*> library;  // Library of all tracks (owned)
+    TrackTable track_table;            // Value-type copy of library, same order
 };
 
 #endif // DJLIBRARYSERVICE_H
@@ -6,6 +6,7 @@
 #include "SessionFileParser.h"
 #include "ConfigurationManager.h"
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 /**
@@ -38,7 +39,11 @@ private:
     // Configuration and session state
     ConfigurationManager config_manager;
     SessionConfig session_config;
-    std::vector<std::string> track_titles;
+    std::vector<TrackId> track_ids;  // current playlist, in play order
+    std::vector<std::pair<TrackId, size_t>> access_trace;  // controller lookups (id, footprint)
+    size_t playlist_trace_begin;  // first access_trace entry of the current playlist
+    std::vector<std::vector<size_t>> id_positions;  // TrackId -> indices in track_ids
+    std::unordered_set<TrackId> prefetched;  // prefetched into the cache, not yet demanded
     bool play_all;
     // Session statistics
     struct SessionStats {
@@ -46,6 +51,9 @@ private:
         size_t cache_hits = 0;
         size_t cache_misses = 0;
         size_t cache_evictions = 0;
+        size_t prefetch_loads = 0;
+        size_t prefetch_hits = 0;       // demand hits served by a prefetched entry
+        size_t prefetch_evictions = 0;
         size_t deck_loads_a = 0;
         size_t deck_loads_b = 0;
         size_t transitions = 0;
@@ -82,6 +90,15 @@ public:
      * - Output: An integer indicating a HIT (1) or MISS (0).
      */
     int load_track_to_controller(const std::string& track_name);
+    int load_track_to_controller(TrackId track_id);
+
+    /**
+     * Contract: Prefetch the next controller_prefetch_depth titles after a position.
+     * - Input: index in track_ids of the track just played.
+     * - Never evicts a cached track whose next use comes before the prefetched one;
+     *   stops at the first title that cannot be admitted under that rule.
+     */
+    void prefetch_upcoming(size_t position);
 
     /**
      * Contract: Load a cached track into a mixer deck (instant-transition model)
@@ -89,12 +106,22 @@ public:
      * - Output: true on success; false if not found in cache or clone fails
      */
     bool load_track_to_mixer_deck(const std::string& track_title);
+    bool load_track_to_mixer_deck(TrackId track_id);
 
     /**
      * Contract: Orchestrate the DJ performance simulation
      */
     void simulate_dj_performance();
 
+    /**
+     * Contract: Offline cache sizing (tool mode, no tracks are loaded)
+     * - Input: trace file with one title per line, or "" to derive the access
+     *   stream from the configured playlists in play-all order; sample rate
+     *   for SHARDS in (0, 1], or <= 0 to pick one from the trace length.
+     * - Output: prints LRU and Belady-optimal miss ratios per cache size.
+     */
+    void run_cache_sizing(const std::string& trace_path, double sample_rate);
+
 
     // ========== STATUS & DISPLAY METHODS ==========
 
@@ -120,4 +147,30 @@ private:
      * @brief Print final session summary with statistics
      */
     void print_session_summary() const;
+
+    /**
+     * @brief Print the active policy's hit ratio and, if
+     * controller_compare_policies is set, a replay of the current playlist's
+     * cache lookups under every available eviction policy
+     */
+    void print_cache_policy_comparison() const;
+
+    /**
+     * @brief Index of the next occurrence of track_id in track_ids after position,
+     * or track_ids.size() if it does not occur again
+     */
+    size_t next_use(TrackId track_id, size_t position) const;
+
+    /**
+     * @brief Titles the controller would be asked for when every configured
+     * playlist is played in order (play-all mode), as the built library
+     * resolved them (titles may come from ID3 tags)
+     */
+    std::vector<std::string> playlist_access_stream() const;
+
+    /**
+     * @brief Write the recorded controller lookups, one title per line
+     * @return false if the file cannot be written
+     */
+    bool save_access_trace(const std::string& path) const;
 };
\ No newline at end of file
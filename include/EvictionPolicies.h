@@ -0,0 +1,141 @@
+#pragma once
+
+#include "EvictionPolicy.h"
+#include "FrequencySketch.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Least Recently Used: one recency list, evict its tail
+ */
+class LRUPolicy : public EvictionPolicy {
+private:
+    SlotList recency;
+
+public:
+    LRUPolicy() : recency() {}
+    const char* name() const override { return "LRU"; }
+    void reset(size_t capacity) override;
+    void onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId key) override;
+    void onHit(std::vector<CacheSlot>& slots, size_t idx) override;
+    void onRemove(std::vector<CacheSlot>& slots, size_t idx, TrackId key, bool evicted) override;
+    size_t victim(const std::vector<CacheSlot>& slots) const override;
+    void forEachVictim(const std::vector<CacheSlot>& slots, TrackId key, const VictimVisitor& visit) const override;
+};
+
+/**
+ * @brief Least Frequently Used with LRU tie-breaking
+ *
+ * One recency list per use count; counts saturate at MAX_FREQUENCY so the
+ * bucket array is fixed and a victim is found in bounded time.
+ */
+class LFUPolicy : public EvictionPolicy {
+private:
+    static const uint32_t MAX_FREQUENCY = 255;
+    std::vector<SlotList> buckets;   // buckets[f] holds slots used f times
+    uint32_t min_frequency;          // lowest possibly non-empty bucket
+
+public:
+    LFUPolicy();
+    const char* name() const override { return "LFU"; }
+    void reset(size_t capacity) override;
+    void onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId key) override;
+    void onHit(std::vector<CacheSlot>& slots, size_t idx) override;
+    void onRemove(std::vector<CacheSlot>& slots, size_t idx, TrackId key, bool evicted) override;
+    size_t victim(const std::vector<CacheSlot>& slots) const override;
+    void forEachVictim(const std::vector<CacheSlot>& slots, TrackId key, const VictimVisitor& visit) const override;
+};
+
+/**
+ * @brief 2Q (Johnson & Shasha): FIFO probation queue, LRU main queue and a
+ * ghost history of titles evicted from probation. Only titles seen again
+ * while still in the history are promoted, so a one-off scan cannot flush
+ * the main queue.
+ */
+class TwoQueuePolicy : public EvictionPolicy {
+private:
+    enum Segment { A1_IN = 1, A_MAIN = 2 };
+    SlotList a1_in;
+    SlotList a_main;
+    GhostList a1_out;
+    size_t kin;    // target size of a1_in
+    size_t kout;   // capacity of a1_out
+
+public:
+    TwoQueuePolicy();
+    const char* name() const override { return "2Q"; }
+    void reset(size_t capacity) override;
+    void onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId key) override;
+    void onHit(std::vector<CacheSlot>& slots, size_t idx) override;
+    void onRemove(std::vector<CacheSlot>& slots, size_t idx, TrackId key, bool evicted) override;
+    size_t victim(const std::vector<CacheSlot>& slots) const override;
+    void forEachVictim(const std::vector<CacheSlot>& slots, TrackId key, const VictimVisitor& visit) const override;
+};
+
+/**
+ * @brief Adaptive Replacement Cache (Megiddo & Modha)
+ *
+ * T1 holds titles seen once recently, T2 titles seen at least twice; B1/B2
+ * remember what was evicted from each. A hit in a ghost list shifts the
+ * target size p of T1 towards whichever side would have kept it.
+ */
+class ARCPolicy : public EvictionPolicy {
+private:
+    enum Segment { T1 = 1, T2 = 2 };
+    SlotList t1;
+    SlotList t2;
+    GhostList b1;
+    GhostList b2;
+    size_t capacity;
+    size_t p;                 // target size of t1
+    bool pending_in_b2;       // incoming title is in b2 (affects victim choice)
+
+    void trimGhosts();
+    size_t targetFor(TrackId key, bool& in_b2) const;
+
+public:
+    ARCPolicy();
+    const char* name() const override { return "ARC"; }
+    void reset(size_t capacity) override;
+    void prepareInsert(TrackId key) override;
+    void onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId key) override;
+    void onHit(std::vector<CacheSlot>& slots, size_t idx) override;
+    void onRemove(std::vector<CacheSlot>& slots, size_t idx, TrackId key, bool evicted) override;
+    size_t victim(const std::vector<CacheSlot>& slots) const override;
+    void forEachVictim(const std::vector<CacheSlot>& slots, TrackId key, const VictimVisitor& visit) const override;
+};
+
+/**
+ * @brief W-TinyLFU (Einziger, Friedman & Manes)
+ *
+ * New titles enter a small LRU window (~1% of capacity). The main area is
+ * segmented LRU (probation + protected). When space is needed the window's
+ * oldest entry competes with the main area's victim, and the one with the
+ * lower FrequencySketch estimate is evicted.
+ *
+ * The sketch counts each access once: lookups in recordAccess(), and
+ * inserts only when no lookup of the same key preceded them (prefetches).
+ */
+class TinyLFUPolicy : public EvictionPolicy {
+private:
+    enum Segment { WINDOW = 1, PROBATION = 2, PROTECTED = 3 };
+    SlotList window;
+    SlotList probation;
+    SlotList protected_main;
+    FrequencySketch sketch;
+    size_t window_capacity;
+    size_t protected_capacity;
+    TrackId last_recorded;   // key of the last recordAccess(), until the next prepareInsert()
+
+public:
+    TinyLFUPolicy();
+    const char* name() const override { return "W-TinyLFU"; }
+    void reset(size_t capacity) override;
+    void recordAccess(TrackId key) override;
+    void prepareInsert(TrackId key) override;
+    void onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId key) override;
+    void onHit(std::vector<CacheSlot>& slots, size_t idx) override;
+    void onRemove(std::vector<CacheSlot>& slots, size_t idx, TrackId key, bool evicted) override;
+    size_t victim(const std::vector<CacheSlot>& slots) const override;
+    void forEachVictim(const std::vector<CacheSlot>& slots, TrackId key, const VictimVisitor& visit) const override;
+};
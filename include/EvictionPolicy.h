@@ -0,0 +1,149 @@
+#pragma once
+
+#include "CacheSlot.h"
+#include "PointerWrapper.h"
+#include "TrackRegistry.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Intrusive doubly-linked list threaded through CacheSlot::prev/next
+ *
+ * Owns no memory: it only records head, tail and length, and relinks slots
+ * of the vector it is handed. A slot may be on at most one list at a time.
+ */
+class SlotList {
+private:
+    size_t head;
+    size_t tail;
+    size_t count;
+
+public:
+    SlotList();
+
+    void pushFront(std::vector<CacheSlot>& slots, size_t idx);
+    void remove(std::vector<CacheSlot>& slots, size_t idx);
+    void moveToFront(std::vector<CacheSlot>& slots, size_t idx);
+
+    size_t front() const { return head; }
+    size_t back() const { return tail; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void reset();
+};
+
+/**
+ * @brief Bounded MRU-ordered set of recently evicted track ids (ARC/2Q history)
+ */
+class GhostList {
+private:
+    std::list<TrackId> order;
+    std::unordered_map<TrackId, std::list<TrackId>::iterator> lookup;
+
+public:
+    GhostList() : order(), lookup() {}
+
+    bool contains(TrackId key) const { return lookup.count(key) != 0; }
+    void pushFront(TrackId key);
+    void erase(TrackId key);
+    void popBack();
+    size_t size() const { return lookup.size(); }
+    bool empty() const { return lookup.empty(); }
+    void clear();
+};
+
+/**
+ * @brief Eviction strategy plugged into LRUCache
+ *
+ * The cache owns the slots, the id index and the free list; the policy
+ * only decides ordering. It is told about every insert, hit and removal and
+ * is asked which occupied slot to give up when space is needed. All
+ * bookkeeping lives in the slots' intrusive fields, so the shipped policies
+ * are O(1) per operation.
+ *
+ * Call order for a miss: recordAccess(key) (from the lookup), prepareInsert(key),
+ * then victim()/onRemove(..., true) as many times as needed, then onInsert().
+ * A cache that must vet its victims first walks them with forEachVictim(),
+ * which changes nothing, and only then calls prepareInsert() and evicts.
+ */
+class EvictionPolicy {
+public:
+    /**
+     * @brief Called with a slot index; returns false to stop the walk
+     */
+    typedef std::function<bool(size_t)> VictimVisitor;
+
+    virtual ~EvictionPolicy() {}
+
+    /**
+     * @brief Short display name ("LRU", "ARC", ...)
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Forget all state; the cache now has `capacity` empty slots
+     */
+    virtual void reset(size_t capacity) = 0;
+
+    /**
+     * @brief A lookup of `key` happened (hit or miss)
+     */
+    virtual void recordAccess(TrackId key) { (void)key; }
+
+    /**
+     * @brief `key` missed and is about to be inserted; victims are chosen next
+     */
+    virtual void prepareInsert(TrackId key) { (void)key; }
+
+    /**
+     * @brief A slot was filled with `key`
+     */
+    virtual void onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId key) = 0;
+
+    /**
+     * @brief The entry in `idx` was hit
+     */
+    virtual void onHit(std::vector<CacheSlot>& slots, size_t idx) = 0;
+
+    /**
+     * @brief The entry in `idx` is leaving the cache
+     * @param evicted true when it was chosen by victim(), false on clear()
+     */
+    virtual void onRemove(std::vector<CacheSlot>& slots, size_t idx,
+                          TrackId key, bool evicted) = 0;
+
+    /**
+     * @brief Slot to evict next, or CacheSlot::npos if nothing is cached
+     */
+    virtual size_t victim(const std::vector<CacheSlot>& slots) const = 0;
+
+    /**
+     * @brief Visit occupied slots in the order victim() would give them up
+     * if `key` were about to be inserted and each visited slot were evicted
+     * in turn. Read-only: prepareInsert(key) has not been called yet.
+     */
+    virtual void forEachVictim(const std::vector<CacheSlot>& slots, TrackId key,
+                               const VictimVisitor& visit) const = 0;
+};
+
+/**
+ * @brief Create a policy by config name: lru, lfu, 2q, arc or tinylfu
+ * @return Empty wrapper if the name is not recognised
+ */
+PointerWrapper<EvictionPolicy> make_eviction_policy(const std::string& name);
+
+/**
+ * @brief Config names accepted by make_eviction_policy, in display order
+ */
+const std::vector<std::string>& eviction_policy_names();
+
+/**
+ * @brief Stable 64-bit hash of a cache key
+ */
+uint64_t hash_cache_key(const std::string& key);
+uint64_t hash_cache_key(TrackId key);
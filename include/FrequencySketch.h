@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Approximate access-frequency counter for cache admission (TinyLFU)
+ *
+ * A count-min sketch of 4-bit saturating counters, four rows packed into
+ * 64-bit words. Memory is O(capacity) regardless of how many distinct
+ * titles are seen. Once the number of recorded accesses reaches a sample
+ * window (10x capacity) every counter is halved, so the sketch tracks
+ * recent popularity rather than all-time totals.
+ */
+class FrequencySketch {
+private:
+    std::vector<uint64_t> table;   // 16 four-bit counters per word
+    size_t mask;                   // table.size() - 1 (power of two)
+    size_t additions;              // increments since the last reset
+    size_t sample_size;            // additions that trigger aging
+
+public:
+    /**
+     * @brief Size the sketch for a cache of the given capacity
+     */
+    explicit FrequencySketch(size_t capacity = 16);
+
+    /**
+     * @brief Resize (and clear) the sketch for a new capacity
+     */
+    void ensureCapacity(size_t capacity);
+
+    /**
+     * @brief Record one access of the key with this hash
+     */
+    void increment(uint64_t key_hash);
+
+    /**
+     * @brief Estimated recent access count (0-15)
+     */
+    uint32_t frequency(uint64_t key_hash) const;
+
+    /**
+     * @brief Forget all counts
+     */
+    void clear();
+
+private:
+    size_t indexOf(uint64_t hash, int row) const;
+    void halve();
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Index entry for one ID3v2 frame (payload not decoded)
+ */
+struct ID3Frame {
+    char id[5];         // e.g. "TIT2", NUL-terminated
+    uint16_t flags;     // format flags as stored (version-specific layout)
+    uint32_t size;      // stored payload bytes, after the 10-byte frame header
+    uint64_t offset;    // file offset of the payload
+    size_t inline_at;   // payload copy in the tag's inline store, or NOT_INLINE
+};
+
+/**
+ * @brief APIC header fields; the image itself is read by ID3v2Tag::read_picture
+ */
+struct ID3Picture {
+    std::string mime;
+    uint8_t type;              // 3 = front cover
+    std::string description;
+    size_t image_offset;       // start of the image within the decoded frame
+    size_t image_bytes;        // image size (an upper bound for unsynchronised frames)
+
+    ID3Picture() : mime(), type(0), description(), image_offset(0), image_bytes(0) {}
+};
+
+/**
+ * @brief Lazy ID3v2.3/2.4 tag reader
+ *
+ * read() takes the tag header and the frame index only: frame headers are
+ * walked with a few windowed reads, and the payloads of small frames
+ * (text, up to INLINE_FRAME_BYTES) are kept. Larger frames such as APIC
+ * are skipped by offset, so embedded images are never read, copied or
+ * kept; the file is not held open afterwards.
+ *
+ * Frames are decoded only when asked: text() / text_values() convert
+ * ISO-8859-1, UTF-16 and UTF-8 to UTF-8; picture_info() reads just the
+ * APIC header and read_picture() the image bytes.
+ *
+ * Handled: extended headers, v2.4 per-frame unsynchronisation, data-length
+ * indicators and grouping bytes. A v2.3 tag with tag-wide
+ * unsynchronisation has to be read whole to find its frames (and again to
+ * decode one of its large frames). Compressed or
+ * encrypted frames are indexed but not decoded. ID3v2.2 is not supported.
+ */
+class ID3v2Tag {
+public:
+    static const size_t INLINE_FRAME_BYTES = 1024;
+    static const size_t NOT_INLINE = static_cast<size_t>(-1);
+
+    ID3v2Tag();
+
+    /**
+     * @brief Index the tag at the start of `path`
+     * @return true if a tag was indexed; false if there is none (error()
+     * empty) or the file is unreadable or the tag malformed (error() set)
+     */
+    bool read(const std::string& path);
+
+    bool present() const { return major_version != 0; }
+    int version() const { return major_version; }
+    uint64_t tag_bytes() const { return total_bytes; }
+    uint64_t bytes_read() const { return read_bytes; }   // by read(), i.e. to build the index
+    const std::vector<ID3Frame>& frames() const { return index; }
+    const std::string& error() const { return last_error; }
+
+    /**
+     * @brief First frame with the given four-character id, or nullptr
+     */
+    const ID3Frame* find(const char* id) const;
+
+    /**
+     * @brief Values of a text frame (T***), as UTF-8; empty if absent
+     * v2.4 separates values with NUL; v2.3 TPE1-TPE4/TCOM/TEXT/TOLY/TOPE use "/".
+     */
+    std::vector<std::string> text_values(const char* id) const;
+
+    /**
+     * @brief Text frame values joined with "/" ("" if absent)
+     */
+    std::string text(const char* id) const;
+
+    std::string title() const { return text("TIT2"); }
+    std::vector<std::string> artists() const { return text_values("TPE1"); }
+
+    /**
+     * @brief TBPM rounded to an integer, 0 if absent or unparsable
+     */
+    int bpm() const;
+
+    /**
+     * @brief Header of the first APIC frame (reads at most ~1 KiB of it)
+     */
+    bool picture_info(ID3Picture& picture) const;
+
+    /**
+     * @brief The image bytes of the APIC frame described by `picture`
+     */
+    bool read_picture(const ID3Picture& picture, std::vector<uint8_t>& image) const;
+
+private:
+    std::string file_path;
+    int major_version;
+    uint8_t tag_flags;
+    uint64_t total_bytes;
+    std::vector<ID3Frame> index;
+    std::string inline_store;   // concatenated payloads of small frames
+    std::string last_error;
+    uint64_t read_bytes;
+
+    bool fail(const std::string& message);
+
+    /**
+     * Decoded payload of `frame` (grouping/length prefixes stripped,
+     * unsynchronisation undone), at most `limit` bytes. `full_size` gets the
+     * whole decoded size (an upper bound for unsynchronised frames) and
+     * `prefix` the stored bytes skipped before the data.
+     */
+    bool frame_data(const ID3Frame& frame, size_t limit, std::string& out, size_t& full_size,
+                    size_t& prefix) const;
+    bool read_at(uint64_t offset, size_t count, std::string& out) const;
+    bool read_at(uint64_t offset, size_t count, uint8_t* out) const;
+};
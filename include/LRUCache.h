@@ -2,91 +2,170 @@
 
 #include "CacheSlot.h"
 #include "AudioTrack.h"
+#include "EvictionPolicy.h"
 #include "PointerWrapper.h"
 #include <vector>
+#include <functional>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <unordered_map>
 
 /**
  * @brief LRU Cache Implementation
- * 
+ *
  * Manages limited-capacity cache with Least Recently Used eviction policy.
  * This class has one responsibility: implementing efficient LRU caching logic.
  * It's decoupled from file I/O, UI concerns, and mixing operations.
- * 
+ *
  * Phase 4 usage contract:
  * - Used by DJControllerService with fixed capacity in this assignment.
  * - get() marks entries MRU by updating their access time.
  * - put() inserts as MRU and evicts true LRU when full.
+ *
+ * Complexity: lookup indexes a TrackId -> slot array directly (no hashing;
+ * the string overloads resolve the title through TrackRegistry first), and eviction
+ * order is kept in doubly-linked lists threaded through the slots themselves
+ * (CacheSlot::prev/next). contains/get/put/evictLRU are all O(1).
+ *
+ * The eviction order is a pluggable EvictionPolicy (strategy). LRU is the
+ * default; set_policy() swaps in LFU, 2Q, ARC or W-TinyLFU, in which case
+ * "LRU" in the method names below means "the policy's victim".
+ *
+ * Besides the slot count, the cache can enforce a byte budget
+ * (set_byte_budget). Each entry is charged its AudioTrack::memory_footprint()
+ * less the waveform; waveform buffers are charged once per buffer, however
+ * many cached entries share it, and released with the last of them. put()
+ * keeps evicting until the new entry fits both limits. An entry is
+ * re-measured whenever it is touched (lazy waveforms fill in after the
+ * insert, copy-on-write can swap the buffer), so growth seen on a hit is
+ * reclaimed by the next insert.
  */
 class LRUCache {
 private:
     std::vector<CacheSlot> slots;
+    std::vector<size_t> index;                      // TrackId -> slot index (npos if absent)
+    size_t occupied;
+    std::vector<size_t> free_slots;                 // unoccupied slot indices
+    PointerWrapper<EvictionPolicy> policy;
     size_t max_size;
+    size_t byte_budget;                             // 0 = slot count only
+    size_t bytes_used;
+    struct SharedCharge {
+        size_t holders;   // cached entries pointing at the buffer
+        size_t bytes;     // its waveform_footprint(), charged once
+    };
+    std::unordered_map<const WaveformBuffer*, SharedCharge> shared_charges;
     uint64_t access_counter;
+    std::atomic<uint64_t>* shared_clock;            // optional cross-cache clock
 
 public:
     /**
      * @brief Construct LRU cache with specified capacity
      * @param capacity Maximum number of tracks to cache
+     * @param clock Optional shared access clock. When set, access times are
+     *        drawn from it so several caches (e.g. shards) can compare LRU age.
      */
-    explicit LRUCache(size_t capacity);
-    
+    explicit LRUCache(size_t capacity, std::atomic<uint64_t>* clock = nullptr);
+
+    LRUCache(const LRUCache&) = delete;
+    LRUCache& operator=(const LRUCache&) = delete;
+
     /**
      * @brief Check if cache contains a track
      * @param track_id Track identifier to search for
      * @return true if track is in cache
      */
-    bool contains(const std::string& track_id) const;
-    
+    bool contains(TrackId track_id) const;
+    bool contains(const std::string& title) const;
+
     /**
      * @brief Get a track from cache (updates LRU order)
      * @param track_id Track identifier
      * @return Raw pointer to track, or nullptr if not found
-     * 
+     *
      * This method updates access time, moving the track to
      * "most recently used" position in LRU algorithm.
      */
-    AudioTrack* get(const std::string& track_id);
-    
+    AudioTrack* get(TrackId track_id);
+    AudioTrack* get(const std::string& title);
+
     /**
      * @brief Put a track into cache (handles eviction if full)
      * @param track Track to cache (transfers ownership).
      * @return true if an eviction occurred, false otherwise.
-     * 
+     * @throws std::runtime_error if the cache runs out of victims before the
+     *         entry fits (a bookkeeping bug; never a silent drop)
+     *
      * If cache is full, automatically evicts the least recently
-     * used track before storing the new one.
+     * used track before storing the new one. With a byte budget, eviction
+     * continues until the new entry fits. A track that can never be stored
+     * (see fits()) or has no id (INVALID_TRACK_ID: never interned, so no
+     * lookup could find it) is rejected up front: not stored, returns false.
      */
     bool put(PointerWrapper<AudioTrack> track);
-    
+
     /**
      * @brief Manually evict the least recently used track
      * @return true if a track was evicted
      */
     bool evictLRU();
-    
+
+    /**
+     * @brief Put a track only if every entry it would displace may go
+     * @param track Track to cache (transfers ownership; dropped if not stored)
+     * @param can_evict Asked about each victim's id, in eviction order
+     * @return Number of entries evicted, or -1 if the track was not stored
+     *         (already cached, no id, never fits, or a victim was refused)
+     *
+     * All victims are vetted before the first is evicted, so a refusal
+     * leaves the cache and the policy exactly as they were.
+     */
+    int putIfApproved(PointerWrapper<AudioTrack> track, const std::function<bool(TrackId)>& can_evict);
+
+    /**
+     * @brief Access time of the least recently used entry
+     * @return Timestamp of the LRU slot, or UINT64_MAX if the cache is empty
+     */
+    uint64_t lruAccessTime() const;
+
     /**
      * @brief Get current cache usage
      * @return Number of occupied slots
      */
     size_t size() const;
-    
+
     /**
      * @brief Get maximum cache capacity
      */
     size_t capacity() const { return max_size; }
-    
+
     /**
      * @brief Check if cache is full
      */
     bool isFull() const { return size() >= max_size; }
-    
+
+    /**
+     * @brief Bytes currently charged to cached entries
+     */
+    size_t bytesUsed() const { return bytes_used; }
+
+    /**
+     * @brief Byte budget, or 0 if only the slot count is enforced
+     */
+    size_t byteBudget() const { return byte_budget; }
+
+    /**
+     * @brief Whether an entry of this footprint can ever be admitted
+     */
+    bool fits(size_t bytes) const { return max_size > 0 && (byte_budget == 0 || bytes <= byte_budget); }
+
     /**
      * @brief Clear all cache entries
      */
     void clear();
-    
+
     /**
      * @brief Display cache status with LRU information
      */
@@ -96,23 +175,103 @@ public:
      * This method should be used only once.
      */
     void set_capacity(size_t capacity);
+
+    /**
+     * @brief Limit the total footprint of cached entries
+     * @param bytes Budget in bytes; 0 disables the byte limit
+     *
+     * Entries that no longer fit are evicted, oldest first.
+     */
+    void set_byte_budget(size_t bytes);
+
+    /**
+     * @brief Replace the eviction policy
+     * @param new_policy Policy to use (transfers ownership); ignored if empty
+     *
+     * Cached entries are kept and re-registered with the new policy in
+     * access-time order.
+     */
+    void set_policy(PointerWrapper<EvictionPolicy> new_policy);
+
+    /**
+     * @brief Display name of the active eviction policy
+     */
+    const char* policy_name() const { return policy->name(); }
 private:
     /**
      * @brief Find slot containing specific track
      * @param track_id Track identifier
      * @return Slot index, or max_size if not found
      */
-    size_t findSlot(const std::string& track_id) const;
-    
+    size_t findSlot(TrackId track_id) const;
+
     /**
      * @brief Find the least recently used slot
      * @return Slot index of LRU entry
      */
     size_t findLRUSlot() const;
-    
+
     /**
      * @brief Find first empty slot
      * @return Slot index, or max_size if cache is full
      */
     size_t findEmptySlot() const;
-};
\ No newline at end of file
+
+    /**
+     * @brief Mark a slot as used and notify the policy
+     * @return The cached track
+     */
+    AudioTrack* touch(size_t idx);
+
+    /**
+     * @brief Whether `bytes` more fit in a free slot within the byte budget
+     */
+    bool hasRoomFor(size_t bytes) const;
+
+    /**
+     * @brief Bytes inserting `track` would add: its own, plus its waveform
+     * unless a cached entry already carries that buffer
+     */
+    size_t chargeFor(const AudioTrack& track) const;
+
+    /**
+     * @brief Fill a free slot with `track` (the caller made room) and notify the policy
+     */
+    void insert(PointerWrapper<AudioTrack> track);
+
+    /**
+     * @brief Charge the slot's waveform buffer, if no other entry already does
+     */
+    void chargeShared(size_t idx);
+
+    /**
+     * @brief Drop the slot's hold on its buffer; the last holder releases the bytes
+     */
+    void releaseShared(size_t idx);
+
+    /**
+     * @brief Bring the slot's charges up to date with its track
+     */
+    void remeasure(size_t idx);
+
+    /**
+     * @brief Evict the occupied slot `idx` and tell the policy
+     */
+    void evictSlot(size_t idx);
+
+    /**
+     * @brief Next access timestamp (shared clock if configured)
+     */
+    uint64_t nextTick();
+
+    /**
+     * @brief Reset index, free list and policy for the current slots
+     */
+    void resetBookkeeping();
+
+    /**
+     * @brief Empty the cache and rebuild it with the current capacity/policy,
+     * re-inserting the most recently used entries that still fit
+     */
+    void rebuild();
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Stream properties of an MPEG audio file, from its frame headers
+ */
+struct MP3StreamInfo {
+    enum class Source : uint8_t { FrameScan, Xing, Info, VBRI };
+
+    int mpeg_version;       // 1, 2, or 25 for MPEG-2.5
+    int layer;              // 1, 2 or 3
+    unsigned sample_rate;
+    unsigned channels;
+    unsigned bitrate_kbps;  // average over the stream when vbr
+    bool vbr;
+    uint64_t frames;        // audio frames (an Xing/Info/VBRI frame is not counted)
+    double duration_seconds;
+    Source source;          // where frames and duration came from
+    bool has_toc;           // Xing seek table present
+    uint64_t audio_offset;  // first frame, after any ID3v2 tag
+    uint64_t audio_bytes;
+    uint64_t id3v2_bytes;   // size of a leading ID3v2 tag (skipped, never read)
+
+    MP3StreamInfo();
+
+    static const char* source_name(Source source);
+};
+
+/**
+ * @brief Streaming MP3 frame-header scanner
+ *
+ * Finds bitrate, sample rate, exact duration and VBR status without
+ * decoding audio. The file is read front to back in large blocks (with a
+ * sequential-access hint to the kernel); a leading ID3v2 tag is skipped
+ * with a seek, so album art is never read.
+ *
+ * If the first frame is a Xing/Info or VBRI header carrying a frame
+ * count, the scan stops there: the duration is exact and only one block
+ * was read. Otherwise every frame header is visited, which handles CBR,
+ * untagged VBR and files with garbage between frames (the scanner
+ * resynchronizes, requiring two consecutive valid headers).
+ * Free-format streams are not supported.
+ */
+class MP3FrameScanner {
+public:
+    static const size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+    explicit MP3FrameScanner(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+    /**
+     * @brief Scan `path`
+     * @return false with error() set if the file cannot be read or holds no MPEG audio frames
+     */
+    bool scan(const std::string& path);
+
+    const MP3StreamInfo& info() const { return stream; }
+    const std::string& error() const { return last_error; }
+
+    /**
+     * @brief Bytes actually read by the last scan (tags skipped by seeking are not counted)
+     */
+    uint64_t bytes_read() const { return total_read; }
+
+private:
+    std::vector<uint8_t> buffer;
+    MP3StreamInfo stream;
+    std::string last_error;
+    uint64_t total_read;
+};
@@ -2,6 +2,9 @@
 #define MP3TRACK_H
 
 #include "AudioTrack.h"
+#include "ID3v2Tag.h"
+#include "MP3FrameScanner.h"
+#include <memory>
 
 /**
  * MP3Track - Represents an MP3 audio file with lossy compression
@@ -13,18 +16,32 @@
  * - analyze_beatgrid(): run immediately after load() in this assignment for compatibility checks.
  * - get_quality_score(): derived from bitrate (e.g., normalized by 320kbps).
  * - clone(): return a deep polymorphic copy used by the mixer; source remains unchanged.
+ *
+ * A track given a file path scans that file's frame headers on load()
+ * (MP3FrameScanner) and takes its bitrate and duration from the file;
+ * clones made afterwards share the result. Its ID3v2 tag is indexed the
+ * same way (ID3v2Tag): only the frame index is read, frames are decoded
+ * when asked and album art is never loaded. Without a path, the configured
+ * values are used as-is.
  */
 class MP3Track : public AudioTrack {
 private:
     int bitrate;        // Compression level: 128, 192, 320 kbps (higher = better quality)
     bool has_id3_tags;  // Whether file contains ID3 metadata (artist, album, etc.)
+    std::string file_path;                          // .mp3 on disk, "" = metadata only
+    std::shared_ptr<const MP3StreamInfo> stream_info;  // from the first successful scan
+    std::shared_ptr<const ID3v2Tag> id3_tag;           // frame index, read once, shared by clones
+
+    bool scan_file(std::string& error);
+    void read_tag();
 
 public:
     /**
      * Constructor for MP3Track
      */
     MP3Track(const std::string& title, const std::vector<std::string>& artists, 
-             int duration, int bpm, int bitrate, bool has_tags = true);
+             int duration, int bpm, int bitrate, bool has_tags = true,
+             const std::string& file_path = "");
 
     // ========== TODO: IMPLEMENT VIRTUAL FUNCTIONS ==========
 
@@ -52,9 +69,46 @@ public:
      */
     PointerWrapper<AudioTrack> clone() const override;
 
+    /**
+     * Object size plus waveform and string storage
+     */
+    size_t memory_footprint() const override;
+
+    /**
+     * Score for the given parameters, without a track object. Defined
+     * inline so TrackTable's devirtualized scoring matches this class exactly.
+     */
+    static double quality_score(int bitrate, bool has_id3_tags) {
+        double score = (bitrate / 320.0) * 100.0;
+        if (has_id3_tags)
+            score += 5.0;
+        if (bitrate < 128)
+            score -= 10.0;
+        if (score < 0.0) score = 0.0;
+        else if (score > 100.0) score = 100.0;
+        return score;
+    }
+
     // Getters
     int get_bitrate() const { return bitrate; }
     bool has_tags() const { return has_id3_tags; }
+    const std::string& get_file_path() const { return file_path; }
+
+    /**
+     * Frame-header scan of the file (nullptr until load() has scanned one)
+     */
+    const MP3StreamInfo* get_stream_info() const { return stream_info.get(); }
+
+    /**
+     * Indexed ID3v2 tag of the file (nullptr until read by load() or set)
+     */
+    const ID3v2Tag* get_id3_tag() const { return id3_tag.get(); }
+
+    /**
+     * Adopt a tag already read from file_path (e.g. during library import),
+     * so load() does not read it again
+     */
+    void set_id3_tag(const std::shared_ptr<const ID3v2Tag>& tag);
 };
 
 #endif // MP3TRACK_H
\ No newline at end of file
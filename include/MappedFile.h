@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file (POSIX mmap)
+ *
+ * Opening costs the same for any file size: nothing is read until a page
+ * is first touched, and untouched pages never leave the disk. The bytes
+ * stay valid until the object is closed or destroyed, so parsers can hand
+ * out pointers into the file instead of copying.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map `path`, replacing any earlier mapping
+     * @return false with error() set if the file cannot be opened or mapped
+     */
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return mapped; }
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+    const std::string& path() const { return file_path; }
+    const std::string& error() const { return last_error; }
+
+    /**
+     * @brief Hint that [offset, offset + count) will be read front to back
+     * (larger readahead); a no-op if the kernel ignores it
+     */
+    void advise_sequential(size_t offset, size_t count) const;
+
+private:
+    const uint8_t* bytes;   // nullptr for an empty file
+    size_t length;
+    bool mapped;
+    std::string file_path;
+    std::string last_error;
+};
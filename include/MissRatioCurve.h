@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Offline miss-ratio curve for sizing the controller cache
+ *
+ * Builds the LRU miss ratio for every cache size from one pass over a title
+ * access stream, instead of rerunning the session once per candidate size.
+ *
+ * - LRU: Mattson stack distances. LRU is a stack algorithm, so a reference
+ *   with reuse distance d hits in every cache of size >= d. Distances are
+ *   counted with a Fenwick tree over access times, O(N log N) overall.
+ * - SHARDS: with sample_rate R < 1 only titles whose hash falls below R are
+ *   tracked (spatial sampling), and their distances are scaled by 1/R. The
+ *   first bucket absorbs the difference between the expected and the actual
+ *   number of sampled references (SHARDS-adj). A sampled distance d covers
+ *   full distances ((d - 1) / R, d / R], so sizes between those bounds are
+ *   interpolated linearly within the bucket; below 1/R slots everything
+ *   rests on the first bucket and the estimate is coarse.
+ * - OPT: Belady's algorithm (evict the title reused furthest in the future)
+ *   on the same (sampled) stream, giving a lower bound on the miss ratio any
+ *   policy could reach at that size. Sampled, the cache shrinks to size * R
+ *   slots, interpolated between the neighbouring whole slot counts.
+ */
+class MissRatioCurve {
+private:
+    double sample_rate;
+    size_t total_accesses;              // references in the full trace
+    std::vector<uint32_t> sampled;      // interned ids of sampled references
+    size_t distinct_sampled;
+    std::vector<double> histogram;      // histogram[d] = sampled refs with stack distance d
+    double sampled_weight;              // expected sampled references (N * R)
+
+    /**
+     * @brief Belady miss ratio of the sampled stream with exactly `slots` slots
+     */
+    double optSampledMissRatio(size_t slots) const;
+
+public:
+    /**
+     * @param rate Fraction of titles to track, in (0, 1]; 1 is exact
+     */
+    explicit MissRatioCurve(double rate = 1.0);
+
+    /**
+     * @brief Sampling rate that keeps roughly max_tracked references
+     */
+    static double auto_sample_rate(size_t accesses, size_t max_tracked = 1000000);
+
+    /**
+     * @brief Compute stack distances for a trace (replaces previous results)
+     */
+    void build(const std::vector<std::string>& trace);
+
+    /**
+     * @brief LRU miss ratio for a cache of the given number of slots
+     */
+    double lruMissRatio(size_t cache_size) const;
+
+    /**
+     * @brief Belady-optimal miss ratio for a cache of the given number of slots
+     * O(N log size) per call (two passes when sampling falls between slot counts).
+     */
+    double optMissRatio(size_t cache_size) const;
+
+    size_t accesses() const { return total_accesses; }
+    size_t sampledAccesses() const { return sampled.size(); }
+    double sampleRate() const { return sample_rate; }
+
+    /**
+     * @brief Distinct titles in the trace (estimated when sampling)
+     */
+    size_t distinctTitles() const;
+};
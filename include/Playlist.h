@@ -2,12 +2,19 @@
 #define PLAYLIST_H
 
 #include "AudioTrack.h"
+#include <cstddef>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
+enum class TrackFormat : uint8_t;   // TrackTable.h
+
 /**
  * ⚠️  WARNING: THIS CLASS HAS INTENTIONAL MEMORY LEAKS! ⚠️
- * 
+ *
  * This is Phase 1 of the assignment - students must identify and fix all memory leaks.
  * @todo Implement proper memory management to prevent leaks.
  * @note In phase 4, the library service should provide canonical ownership semantics
@@ -15,34 +22,181 @@
  * clear ownership and safe iteration without leaks.
  */
 
-struct PlaylistNode {
-    AudioTrack* track;
-    PlaylistNode* next;
+/**
+ * @brief Stable reference to one playlist entry
+ *
+ * Stays valid while the entry is in the playlist, whatever else is added
+ * or removed; once the entry is removed the handle goes stale and every
+ * lookup with it fails (slots are reused with a new generation).
+ */
+struct PlaylistHandle {
+    uint32_t slot;
+    uint32_t generation;
+
+    PlaylistHandle() : slot(UINT32_MAX), generation(0) {}
+    PlaylistHandle(uint32_t slot, uint32_t generation) : slot(slot), generation(generation) {}
+
+    bool operator==(const PlaylistHandle& other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const PlaylistHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Read-only, non-owning range of playlist tracks in playlist order
+ *
+ * A pair of pointers into the playlist's storage: no copy is made.
+ * Invalidated by any change to the playlist.
+ */
+class PlaylistView {
+public:
+    typedef AudioTrack* const* const_iterator;
+
+    PlaylistView() : first(nullptr), last(nullptr) {}
+    PlaylistView(const_iterator first, const_iterator last) : first(first), last(last) {}
 
-    PlaylistNode(AudioTrack* t) : track(t), next(nullptr) {}
-    ~PlaylistNode() = default;
+    const_iterator begin() const { return first; }
+    const_iterator end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    AudioTrack* operator[](size_t position) const { return first[position]; }
+
+    /**
+     * @brief Sub-range [position, position + count), clamped to this view
+     */
+    PlaylistView slice(size_t position, size_t count) const;
+
+private:
+    const_iterator first;
+    const_iterator last;
 };
 
+/**
+ * @brief Ordered, non-owning list of tracks
+ *
+ * Tracks are kept contiguously in insertion order, so appending, positional
+ * access and iteration are O(1) per track with no pointer chasing. Each
+ * entry also gets a PlaylistHandle through a slot table (slot -> position,
+ * position -> slot): lookups by handle are O(1) and survive other
+ * insertions and removals.
+ *
+ * Removal is amortized O(1) and keeps the order: the entry is left as a
+ * tombstone (a null track) and the storage is compacted lazily, in one
+ * O(n) pass that closes every gap at once. That pass runs when tombstones
+ * outnumber live entries (so each removal pays O(1) of it), or before the
+ * next read that needs dense positions: operator[], begin()/end() and the
+ * views, position_of and handle_at. A batch of removals therefore costs
+ * O(1) each plus one compaction; alternating a removal with a positional
+ * read pays a compaction each time. Lookups by handle or TrackId, size(),
+ * the aggregates and for_each_track skip tombstones and never compact.
+ * Compacting leaves the logical contents unchanged, so const reads may do
+ * it, even on a block shared with copies.
+ *
+ * find_track and remove_track go through a TrackId index kept up to date
+ * by add_track/remove_track: per id, the slots holding that track are
+ * chained (both ways) in playlist order, so duplicates resolve to the
+ * first entry. Finding and unlinking are O(1), however many duplicates.
+ * The index refers to slots, not positions, so removals and compaction do
+ * not touch it beyond unlinking the removed slot, and copies/moves carry it
+ * over as is.
+ *
+ * Running aggregates (total duration, BPM histogram and min/max/mean, mean
+ * quality score, per-format counts) are updated on every add and remove,
+ * so the queries are O(1). Each slot remembers the values it contributed,
+ * so a removal subtracts exactly what was added. A track changed in place
+ * must be reported: set_track_bpm() does so for BPM, refresh_track() for
+ * anything else (e.g. a duration measured on load).
+ *
+ * Copies are copy-on-write: all of the above lives in one Contents block
+ * shared between copies, so copying a playlist of any size is O(1) and
+ * a copy that is only read never allocates. The first add, remove or
+ * track update on a shared block copies it (as WaveformBuffer does for
+ * samples). Handles stay valid in both copies up to that point and
+ * remain valid in each copy for the entries it still holds.
+ */
 class Playlist {
 private:
-    PlaylistNode* head;
+    static const uint32_t NO_SLOT = UINT32_MAX;
+
+    static const int64_t QUALITY_SCALE = 1000000;   // quality sums are kept in fixed point, so they stay exact
+
+    struct Slot {
+        uint32_t position;      // index into tracks, or NO_SLOT when free
+        uint32_t generation;    // bumped on removal so old handles go stale
+        uint32_t next_same;     // next slot with the same TrackId, or NO_SLOT
+        uint32_t prev_same;     // previous slot with the same TrackId, or NO_SLOT
+        // What this entry contributed to the aggregates
+        int duration;
+        int bpm;
+        uint8_t format;         // TrackFormat, or FORMAT_OTHER
+        int64_t quality;        // quality score * QUALITY_SCALE
+    };
+    static const uint8_t FORMAT_OTHER = 2;
+    struct IdChain {
+        uint32_t first;         // slots holding one TrackId, in playlist order
+        uint32_t last;
+    };
+
+    // Everything but the name; shared between copies until one changes
+    struct Contents {
+        std::vector<AudioTrack*> tracks;   // playlist order; nullptr marks a removed entry
+        std::vector<uint32_t> slot_of;     // parallel to tracks (NO_SLOT for removed entries)
+        size_t holes;                      // removed entries not compacted away yet
+        std::vector<Slot> slots;
+        std::vector<uint32_t> free_slots;
+        std::vector<IdChain> by_id;        // indexed by TrackId
+
+        // Running aggregates over all entries
+        int64_t total_duration;
+        int64_t bpm_sum;
+        int64_t quality_sum;
+        std::array<size_t, 3> format_counts;   // by TrackFormat, then other
+        std::map<int, size_t> bpm_counts;      // BPM -> entries
+
+        Contents();
+
+        void erase_at(size_t position);
+        void compact();
+        void link_id(TrackId id, uint32_t slot);
+        void unlink_id(TrackId id, uint32_t slot);
+        uint32_t first_slot(TrackId id) const;
+        void count_in(uint32_t slot);
+        void count_out(uint32_t slot);
+        void refresh(const AudioTrack* track);
+    };
+
+    std::shared_ptr<Contents> contents;
     std::string playlist_name;
-    int track_count;
 
-    void clear_nodes();
-    void copy_nodes_from(const Playlist& other);
-    void move_nodes_from(Playlist&& other);
+    // One empty block shared by every empty or moved-from playlist
+    static const std::shared_ptr<Contents>& empty_contents();
+
+    /**
+     * The contents, made exclusive to this playlist first (copied if shared)
+     */
+    Contents& mutable_contents();
+
+    /**
+     * Close the gaps left by removals, before a read that needs dense positions
+     */
+    void compact() const {
+        if (contents->holes)
+            contents->compact();
+    }
+
+    /**
+     * Slot of the live entry behind `handle`, or NO_SLOT if it is stale
+     */
+    uint32_t live_slot(PlaylistHandle handle) const;
 
 public:
-    // Copy Constructor (Deep Copy of nodes, shallow copy of track pointers)
+    // Copy Constructor (O(1): shares the contents until either side changes)
     Playlist(const Playlist& other);
-    
+
     // Copy Assignment Operator
     Playlist& operator=(const Playlist& other);
 
     // Move Constructor
     Playlist(Playlist&& other) noexcept;
-    
+
     // Move Assignment Operator
     Playlist& operator=(Playlist&& other) noexcept;
     /**
@@ -56,17 +210,34 @@ public:
     ~Playlist();
 
     /**
-     * Add a track to the playlist
-     * @param track Pointer to AudioTrack to add
+     * Append a track to the end of the playlist
+     * @param track Pointer to AudioTrack to add; given a TrackId
+     *        (AudioTrack::intern_id) if it has none, so lookups find it
+     * @return Handle of the new entry (a default, invalid handle if track is null)
      */
-    void add_track(AudioTrack* track);
+    PlaylistHandle add_track(AudioTrack* track);
 
     /**
-     * Remove a track by title
+     * Remove a track by title (the first entry with that title)
      * @param title Title of the track to remove
+     * Found in O(1); removing is amortized O(1) (see the class comment).
      */
     void remove_track(const std::string& title);
 
+    /**
+     * @brief Remove the entry behind `handle`, in amortized O(1)
+     * @return false if the handle is stale
+     */
+    bool remove_track(PlaylistHandle handle);
+
+    /**
+     * @brief Rearrange the entries: the entry at position order[k] moves to
+     * position k (see PlaylistOptimizer). Handles stay valid and aggregates
+     * are unchanged; duplicates of a track are re-chained in the new order.
+     * @return false, changing nothing, if order is not a permutation of the positions
+     */
+    bool reorder(const std::vector<size_t>& order);
+
     /**
      * Display all tracks in the playlist
      */
@@ -76,7 +247,8 @@ public:
      * Get playlist statistics
      * @return Number of tracks in the playlist
      */
-    int get_track_count() const { return track_count; }
+    int get_track_count() const { return static_cast<int>(size()); }
+    size_t size() const { return contents->tracks.size() - contents->holes; }
     const std::string& get_name() const { return playlist_name; }
 
     /**
@@ -86,23 +258,118 @@ public:
      */
     AudioTrack* find_track(const std::string& title) const;
 
+    /**
+     * @brief Find a track by TrackId (the first entry if it is in the playlist more than once)
+     */
+    AudioTrack* find_track(TrackId id) const;
+
+    /**
+     * @brief Handle of the first entry with TrackId `id`, or an invalid handle
+     */
+    PlaylistHandle find_handle(TrackId id) const;
+
     /**
      * Check if playlist is empty
      */
-    bool is_empty() const { return head == nullptr; }
+    bool is_empty() const { return size() == 0; }
+
+    /**
+     * Total duration of all tracks in seconds (O(1), kept up to date)
+     */
+    int get_total_duration() const { return static_cast<int>(contents->total_duration); }
+
+    /**
+     * @brief Lowest / highest BPM in the playlist, 0 if empty
+     */
+    int min_bpm() const { return contents->bpm_counts.empty() ? 0 : contents->bpm_counts.begin()->first; }
+    int max_bpm() const { return contents->bpm_counts.empty() ? 0 : contents->bpm_counts.rbegin()->first; }
+
+    /**
+     * @brief Mean BPM / mean quality score over the entries, 0 if empty
+     */
+    double mean_bpm() const;
+    double mean_quality() const;
+
+    /**
+     * @brief Entries per BPM value, ascending
+     */
+    const std::map<int, size_t>& bpm_histogram() const { return contents->bpm_counts; }
+
+    /**
+     * @brief Entries of the given format; other_format_count() counts
+     * tracks that are neither MP3Track nor WAVTrack
+     */
+    size_t format_count(TrackFormat format) const;
+    size_t other_format_count() const { return contents->format_counts[FORMAT_OTHER]; }
+
+    /**
+     * @brief Set the BPM of the track behind `handle` and update the
+     * aggregates for every entry of this playlist sharing that track
+     * @return false if the handle is stale
+     */
+    bool set_track_bpm(PlaylistHandle handle, int new_bpm);
+
+    /**
+     * @brief Re-read duration, BPM and quality of `track` after it was
+     * changed in place (its entries in this playlist only; copies of the
+     * playlist share the track but keep their own aggregates)
+     */
+    void refresh_track(const AudioTrack* track);
+
+    /**
+     * @brief Track at `position` (0-based, playlist order); no bounds check
+     */
+    AudioTrack* operator[](size_t position) const {
+        compact();
+        return contents->tracks[position];
+    }
+
+    /**
+     * @brief Track behind `handle`, or nullptr if the handle is stale
+     */
+    AudioTrack* get(PlaylistHandle handle) const;
+
+    /**
+     * @brief Current position of the entry behind `handle`, or -1 if stale
+     */
+    long position_of(PlaylistHandle handle) const;
+
+    /**
+     * @brief Handle of the entry at `position`
+     */
+    PlaylistHandle handle_at(size_t position) const;
+
+    /**
+     * @brief All tracks in playlist order, without copying
+     */
+    PlaylistView tracks_view() const { return PlaylistView(begin(), end()); }
+
+    PlaylistView::const_iterator begin() const {
+        compact();
+        return contents->tracks.data();
+    }
+    PlaylistView::const_iterator end() const {
+        compact();
+        return contents->tracks.data() + contents->tracks.size();
+    }
 
     /**
-     * Calculate total duration of all tracks
+     * @brief Whether this playlist's contents are currently shared with a copy
      */
-    int get_total_duration() const;
+    bool shares_contents_with(const Playlist& other) const { return contents == other.contents; }
 
     /**
-     * Get all tracks as a vector
+     * Call fn(AudioTrack&) on every track in playlist order
      */
-    std::vector<AudioTrack*> getTracks() const;
+    template<typename Fn>
+    void for_each_track(Fn fn) const {
+        for (AudioTrack* track : contents->tracks)
+            if (track)
+                fn(*track);
+    }
 
 };
 
 
 
-#endif // PLAYLIST_H
\ No newline at end of file
+#endif // PLAYLIST_H
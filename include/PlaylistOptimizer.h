@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Playlist.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Settings of PlaylistOptimizer
+ */
+struct PlaylistOrderOptions {
+    double bpm_tolerance;        // a transition within this is mixable (as MixingEngineService::can_mix_tracks)
+    double unmixable_penalty;    // cost added per transition beyond the tolerance
+    double slowdown_weight;      // cost per BPM of a tempo drop; a rise costs 1 per BPM
+    std::vector<size_t> pinned;  // positions whose track must not move
+    double time_budget_seconds;
+    unsigned threads;            // 0 = one per hardware thread
+    size_t window;               // positions per parallel work region
+
+    PlaylistOrderOptions();
+};
+
+/**
+ * @brief A play order found by PlaylistOptimizer
+ */
+struct PlaylistOrder {
+    std::vector<size_t> order;   // order[k] = current position of the track to play k-th
+    double initial_cost;         // of the current order
+    double cost;
+    size_t initial_mixable;      // mixable adjacent pairs in the current order
+    size_t mixable;
+    size_t rounds;               // parallel local-search rounds run
+    bool budget_exhausted;       // stopped by the time budget, not by convergence
+    double seconds;
+
+    PlaylistOrder();
+};
+
+/**
+ * @brief Reorders a playlist for smooth tempo transitions
+ *
+ * The order is an open asymmetric TSP path over the tracks' tempos
+ * (AudioTrack::get_tempo). A transition costs its BPM change, with drops
+ * weighted by slowdown_weight, plus unmixable_penalty when it exceeds
+ * bpm_tolerance; the default penalty dominates, so the number of mixable
+ * transitions is maximized first and total BPM movement second.
+ *
+ * A nearest-neighbour tour (from the slowest track, with pinned positions
+ * kept in place) is improved by first-improvement local search: 2-opt
+ * segment reversals and Or-opt moves of 1-3 tracks within runs of unpinned
+ * positions, and exchanges of two unpinned tracks. The work is split into
+ * windows of `window` positions whose shared border positions stay fixed;
+ * the windows are searched in parallel, and alternate rounds shift the
+ * borders by half a window so tracks can travel across them. The result
+ * does not depend on the thread count. The search ends when two
+ * consecutive rounds find nothing or the time budget runs out.
+ */
+class PlaylistOptimizer {
+public:
+    explicit PlaylistOptimizer(const PlaylistOrderOptions& options = PlaylistOrderOptions());
+
+    /**
+     * @brief Best order found for the tracks of `playlist`; apply it with Playlist::reorder
+     */
+    PlaylistOrder optimize(const Playlist& playlist) const;
+
+    /**
+     * @brief Same, over plain tempos (tempos[i] = tempo of the track at position i)
+     */
+    PlaylistOrder optimize(const std::vector<double>& tempos) const;
+
+    double transition_cost(double from_bpm, double to_bpm) const;
+    bool mixable(double from_bpm, double to_bpm) const;
+
+    const PlaylistOrderOptions& options() const { return settings; }
+
+private:
+    PlaylistOrderOptions settings;
+};
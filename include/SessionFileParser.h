@@ -21,6 +21,7 @@ struct SessionConfig {
         int bpm;
         int extra_param1;        // bitrate for MP3, sample_rate for WAV
         int extra_param2;        // has_tags for MP3, bit_depth for WAV
+        std::string file_path;   // optional audio file on disk, "" = none
         
         TrackInfo() 
             : type(""), 
@@ -29,18 +30,30 @@ struct SessionConfig {
               duration_seconds(0), 
               bpm(0), 
               extra_param1(0), 
-              extra_param2(0) {}
+              extra_param2(0),
+              file_path("") {}
     };
     
     std::vector<TrackInfo> library_tracks;
     
     // Cache settings
     int controller_cache_size;
+    size_t controller_cache_bytes;         // memory budget, 0 = slot count only
+    std::string controller_cache_policy;   // lru, lfu, 2q, arc or tinylfu
+    int controller_prefetch_depth;         // upcoming tracks to load ahead, 0 = off
+    std::string controller_trace_file;     // where to record the cache access stream, "" = off
+    bool controller_compare_policies;      // replay each playlist's lookups under every policy
+    
+    // Waveform generation (0 = nondeterministic)
+    unsigned long long waveform_seed;
+    std::string waveform_format;           // float64, float32, int16 or int8
+    std::string analysis_cache_file;       // persisted AnalysisCache, "" = in-memory only
     
     // Mixing settings
     int default_crossfade_time;
     int bpm_tolerance;
     bool auto_sync;
+    int playlist_order_budget_ms;          // reorder loaded playlists for smooth BPM, 0 = keep order
     
     // Playlists - name mapped to list of track indices
     std::map<std::string, std::vector<int>> playlists;
@@ -49,9 +62,18 @@ struct SessionConfig {
           version(""), 
           library_tracks(), 
           controller_cache_size(8), 
+          controller_cache_bytes(0),
+          controller_cache_policy("lru"),
+          controller_prefetch_depth(0),
+          controller_trace_file(""),
+          controller_compare_policies(false),
+          waveform_seed(0),
+          waveform_format("float64"),
+          analysis_cache_file(""),
           default_crossfade_time(5), 
           bpm_tolerance(10), 
           auto_sync(true), 
+          playlist_order_budget_ms(0),
           playlists() {}
 };
 
@@ -98,8 +120,17 @@ public:
      * library_track_1=MP3,title,{artist1;artist2;},duration,bpm,bitrate,has_tags
      * library_track_2=WAV,title,{artist1;artist2;},duration,bpm,sample_rate,bit_depth
      * controller_cache_size=8
+     * controller_cache_bytes=0
+     * controller_cache_policy=lru
+     * controller_prefetch_depth=0
+     * controller_trace_file=bin/cache_trace.txt
+     * controller_compare_policies=false
+     * waveform_seed=42
+     * waveform_format=int16
+     * analysis_cache_file=bin/analysis_cache.txt
      * bpm_tolerance=10
      * auto_sync=true
+     * playlist_order_budget_ms=0
      * playlistname=1,2,3
      */
     static bool parse_config_file(const std::string& config_path, SessionConfig& config);
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "LRUCache.h"
+#include "AudioTrack.h"
+#include "PointerWrapper.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Thread-safe, sharded variant of LRUCache
+ *
+ * Lets several decks and a background preloader use the controller cache at
+ * the same time. Titles are hashed onto independent shards, each an LRUCache
+ * guarded by its own mutex, so threads touching different shards never
+ * contend.
+ *
+ * Eviction is global but approximate: all shards stamp accesses from one
+ * shared atomic clock, and when the total entry count exceeds capacity a few
+ * shards are sampled and the one holding the oldest LRU entry gives it up.
+ * At most one shard lock is held at any time, so there is no lock ordering to
+ * get wrong.
+ *
+ * Unlike LRUCache there is no get() returning a raw pointer: another thread
+ * could evict the entry as soon as the shard lock is released. Callers either
+ * run code under the lock with withTrack(), or take their own clone.
+ *
+ * Standalone prototype: nothing in the session uses it. DJControllerService
+ * is single-threaded and keeps the plain LRUCache, and this class has no
+ * eviction policy choice (shards are always LRU) and no byte budget. It is
+ * exercised only by bench/concurrent_cache_bench.cpp, which compares it with
+ * one LRUCache behind a mutex.
+ */
+class ShardedLRUCache {
+private:
+    struct Shard {
+        mutable std::mutex lock;
+        LRUCache cache;
+
+        Shard(size_t capacity, std::atomic<uint64_t>* clock) : lock(), cache(capacity, clock) {}
+    };
+
+    std::vector<PointerWrapper<Shard>> shards;
+    std::atomic<uint64_t> clock;     // shared access clock for all shards
+    std::atomic<size_t> entries;     // total entries across shards
+    size_t max_size;
+
+public:
+    /**
+     * @brief Default number of shards
+     */
+    static const size_t DEFAULT_SHARDS = 16;
+
+    /**
+     * @brief Construct a sharded cache
+     * @param capacity Maximum number of tracks across all shards
+     * @param shard_count Number of independently locked shards
+     */
+    explicit ShardedLRUCache(size_t capacity, size_t shard_count = DEFAULT_SHARDS);
+
+    ShardedLRUCache(const ShardedLRUCache&) = delete;
+    ShardedLRUCache& operator=(const ShardedLRUCache&) = delete;
+
+    /**
+     * @brief Check if cache contains a track (does not update LRU order)
+     */
+    bool contains(TrackId track_id) const;
+    bool contains(const std::string& title) const;
+
+    /**
+     * @brief Run fn(AudioTrack&) on a cached track under its shard lock
+     * @return true if the track was cached (and fn ran), false on miss
+     *
+     * Counts as an access: the track becomes most recently used.
+     * fn must not call back into this cache.
+     */
+    template<typename Fn>
+    bool withTrack(TrackId track_id, Fn fn) {
+        Shard& shard = shardFor(track_id);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        AudioTrack* track = shard.cache.get(track_id);
+        if (!track)
+            return false;
+        fn(*track);
+        return true;
+    }
+    template<typename Fn>
+    bool withTrack(const std::string& title, Fn fn) {
+        return withTrack(TrackRegistry::instance().find(title), fn);
+    }
+
+    /**
+     * @brief Get a private clone of a cached track (updates LRU order)
+     * @return Clone owned by the caller, or an empty wrapper on miss
+     */
+    PointerWrapper<AudioTrack> getCopy(TrackId track_id);
+    PointerWrapper<AudioTrack> getCopy(const std::string& title);
+
+    /**
+     * @brief Put a track into the cache
+     * @param track Track to cache (transfers ownership)
+     * @return true if this call caused an eviction, false otherwise
+     */
+    bool put(PointerWrapper<AudioTrack> track);
+
+    /**
+     * @brief Get current number of cached tracks (approximate under concurrency)
+     */
+    size_t size() const { return entries.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get maximum cache capacity
+     */
+    size_t capacity() const { return max_size; }
+
+    /**
+     * @brief Get number of shards
+     */
+    size_t shardCount() const { return shards.size(); }
+
+    /**
+     * @brief Clear all shards
+     */
+    void clear();
+
+    /**
+     * @brief Display per-shard occupancy
+     */
+    void displayStatus() const;
+
+private:
+    size_t shardIndex(TrackId track_id) const;
+    Shard& shardFor(TrackId track_id) const;
+
+    /**
+     * @brief Evict the approximately-oldest entry across shards
+     * @param hint Shard index to start sampling from
+     * @return true if an entry was evicted
+     */
+    bool evictApproxLRU(size_t hint);
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Dense integer identity of a track title
+ *
+ * Ids are handed out 0, 1, 2, ... in first-seen order, so they can index
+ * arrays directly. Equal titles share an id, matching the title-keyed
+ * identity the services used before.
+ */
+typedef uint32_t TrackId;
+
+const TrackId INVALID_TRACK_ID = 0xFFFFFFFFu;
+
+/**
+ * @brief Process-wide title <-> TrackId interning table
+ *
+ * Tracks are interned explicitly (AudioTrack::intern_id), not on
+ * construction: the session does it once per track in
+ * DJLibraryService::buildLibrary (so library tracks get the lowest ids), and
+ * Playlist::add_track for tracks from elsewhere. Copies, moves and clones
+ * carry the id along and never come back here. The cache, playlist and session then
+ * compare and hash 32-bit ids instead of full titles; their string
+ * overloads are thin wrappers that look the title up here once.
+ *
+ * Titles are never removed, so an id stays valid for the life of the
+ * process. All operations are thread-safe, with no process-wide lock on
+ * the lookup paths: title -> id is split over SHARDS maps with a mutex
+ * each (keyed by the title's hash, so a lookup hashes the title once), and
+ * id -> title is a table of atomic pointers read without locking (it grows
+ * in chunks of doubling size, so published entries never move).
+ */
+class TrackRegistry {
+public:
+    static TrackRegistry& instance();
+
+    TrackRegistry(const TrackRegistry&) = delete;
+    TrackRegistry& operator=(const TrackRegistry&) = delete;
+
+    /**
+     * @brief Id of `title`, assigning the next free one on first sight
+     */
+    TrackId intern(const std::string& title);
+
+    /**
+     * @brief Id of `title`, or INVALID_TRACK_ID if it was never interned
+     */
+    TrackId find(const std::string& title) const;
+
+    /**
+     * @brief Title of `id` (empty for unknown ids); the reference stays valid
+     */
+    const std::string& title(TrackId id) const;
+
+    /**
+     * @brief Number of interned titles (one past the highest id)
+     */
+    size_t size() const;
+
+    /**
+     * @brief Pre-size the table for `additional` more titles
+     */
+    void reserve(size_t additional);
+
+private:
+    static const size_t SHARDS = 16;
+    static const size_t FIRST_CHUNK = 1024;   // chunk k holds FIRST_CHUNK << k ids
+    static const size_t MAX_CHUNKS = 23;      // enough for every TrackId below INVALID_TRACK_ID
+
+    struct Entry {
+        const std::string* title;
+        TrackId id;
+    };
+    // The keys are already hashes
+    struct HashKey {
+        size_t operator()(size_t hash) const { return hash; }
+    };
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_multimap<size_t, Entry, HashKey> ids;   // std::hash of the title -> entries
+        std::deque<std::string> titles;                         // never moved once added
+
+        Shard() : mutex(), ids(), titles() {}
+
+        const Entry* find(size_t hash, const std::string& title) const;
+    };
+
+    typedef std::atomic<const std::string*> TitleSlot;   // into a shard's titles
+
+    Shard shards[SHARDS];
+    std::atomic<TitleSlot*> chunks[MAX_CHUNKS];
+    std::atomic<TrackId> next_id;
+    std::mutex growth;   // serializes chunk allocation only
+
+    TrackRegistry();
+    ~TrackRegistry();
+
+    Shard& shard_for(size_t hash) { return shards[(hash >> 32) % SHARDS]; }
+    const Shard& shard_for(size_t hash) const { return shards[(hash >> 32) % SHARDS]; }
+
+    /**
+     * @brief Slot of `id` in the title table, or nullptr if its chunk is not allocated yet
+     */
+    TitleSlot* title_slot(TrackId id) const;
+
+    /**
+     * @brief Chunk `k` of the title table, allocated on first use
+     */
+    TitleSlot* chunk(size_t k);
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "MP3Track.h"
+#include "TrackRegistry.h"
+#include "WAVTrack.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Format-specific parameters of an MP3 track
+ */
+struct MP3Params {
+    int bitrate;
+    bool has_id3_tags;
+};
+
+/**
+ * @brief Format-specific parameters of a WAV track
+ */
+struct WAVParams {
+    int sample_rate;
+    int bit_depth;
+};
+
+enum class TrackFormat : uint8_t { MP3, WAV };
+
+/**
+ * @brief Value-type track: shared metadata plus a tagged union of the
+ * MP3/WAV parameters (24 bytes, no vtable, no heap)
+ *
+ * MP3Track and WAVTrack are the only AudioTrack formats, so the set is
+ * closed and a branch on the tag replaces the virtual call. Operations are
+ * visitors with one operator() per parameter struct; visit() picks the
+ * overload at compile time, so both bodies inline into the caller's loop.
+ * The title (and artists, waveform, analysis) stay on the AudioTrack; a
+ * record refers to it by TrackId.
+ */
+class TrackRecord {
+public:
+    static TrackRecord mp3(TrackId id, int duration_seconds, int bpm, int bitrate, bool has_id3_tags);
+    static TrackRecord wav(TrackId id, int duration_seconds, int bpm, int sample_rate, int bit_depth);
+
+    TrackId id() const { return track_id; }
+    int duration() const { return duration_seconds; }
+    int bpm() const { return beats_per_minute; }
+    TrackFormat format() const { return tag; }
+
+    /**
+     * @brief Call visitor(MP3Params) or visitor(WAVParams) depending on the tag
+     */
+    template<typename Visitor>
+    auto visit(Visitor&& visitor) const -> decltype(visitor(std::declval<const MP3Params&>())) {
+        if (tag == TrackFormat::MP3)
+            return visitor(params.mp3);
+        return visitor(params.wav);
+    }
+
+    /**
+     * @brief Same score as the matching MP3Track/WAVTrack::get_quality_score
+     */
+    double quality_score() const;
+
+private:
+    union Params {
+        MP3Params mp3;
+        WAVParams wav;
+    };
+
+    TrackId track_id;
+    int duration_seconds;
+    int beats_per_minute;
+    TrackFormat tag;
+    Params params;
+
+    TrackRecord(TrackId id, int duration, int bpm, TrackFormat format);
+};
+
+/**
+ * @brief Visitor computing the format's quality score (see TrackRecord::visit)
+ */
+struct QualityScore {
+    double operator()(const MP3Params& p) const { return MP3Track::quality_score(p.bitrate, p.has_id3_tags); }
+    double operator()(const WAVParams& p) const { return WAVTrack::quality_score(p.sample_rate, p.bit_depth); }
+};
+
+inline double TrackRecord::quality_score() const {
+    return visit(QualityScore());
+}
+
+/**
+ * @brief Contiguous, devirtualized mirror of a track collection
+ *
+ * An array of TrackRecords for batch work over a library (scoring, ranking,
+ * filtering) without pointer chasing or virtual calls. Row i mirrors the
+ * i-th track added; it is a snapshot, so later changes to the AudioTrack
+ * (e.g. set_bpm) are not reflected. The polymorphic AudioTrack API is
+ * unchanged and remains the owner of each track.
+ */
+class TrackTable {
+public:
+    TrackTable() : records() {}
+
+    /**
+     * @brief Append a record mirroring `track`
+     * @return false (nothing added) if track is neither an MP3Track nor a WAVTrack
+     */
+    bool add(const AudioTrack& track);
+    void add(const TrackRecord& record) { records.push_back(record); }
+
+    void reserve(size_t count) { records.reserve(count); }
+    void clear() { records.clear(); }
+    size_t size() const { return records.size(); }
+    bool empty() const { return records.empty(); }
+    const TrackRecord& operator[](size_t row) const { return records[row]; }
+
+    /**
+     * @brief scores[i] = quality score of row i (scores is resized and reused)
+     */
+    void quality_scores(std::vector<double>& scores) const;
+
+    /**
+     * @brief Rows of the `count` best-scoring records, best first (ties by row)
+     */
+    void rank_by_quality(size_t count, std::vector<size_t>& rows) const;
+
+    /**
+     * @brief Rows whose record satisfies pred(const TrackRecord&), in order
+     */
+    template<typename Pred>
+    void filter(Pred pred, std::vector<size_t>& rows) const {
+        rows.clear();
+        for (size_t i = 0; i < records.size(); ++i)
+            if (pred(records[i]))
+                rows.push_back(i);
+    }
+
+private:
+    std::vector<TrackRecord> records;
+};
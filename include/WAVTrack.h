@@ -1,61 +1,114 @@
-#ifndef WAVTRACK_H
-#define WAVTRACK_H
-
-#include "AudioTrack.h"
-
-/**
- * WAVTrack - Represents a WAV audio file with high-quality uncompressed audio
- * WAV files store raw audio data without compression, providing maximum quality
- * Students must implement all virtual functions from AudioTrack
- * 
- * Phase 4 contracts:
- * - load(): simulate deck preparation for WAV (often faster due to no decompression).
- * - analyze_beatgrid(): run immediately after load() in this assignment; can be more precise.
- * - get_quality_score(): derived from sample_rate and bit_depth (higher => better).
- * - clone(): return a deep polymorphic copy used by the mixer; source remains unchanged.
- * - get_quality_score(): function of sample_rate and bit_depth (both higher -> better).
- */
-class WAVTrack : public AudioTrack {
-private:
-    int sample_rate;    // Samples per second: 44100 (CD), 48000 (pro), 96000+ (hi-res)
-    int bit_depth;      // Bits per sample: 16 (CD), 24 (pro), 32 (float)
-
-public:
-    /**
-     * Constructor for WAVTrack
-     */
-    WAVTrack(const std::string& title, const std::vector<std::string>& artists, 
-             int duration, int bpm, int sample_rate, int bit_depth);
-
-    // ========== TODO: IMPLEMENT VIRTUAL FUNCTIONS ==========
-
-    /**
-     * TODO: Implement load function for WAV files
-     * HINT: WAV files are uncompressed, so loading might be faster
-     */
-    void load() override;
-
-    /**
-     * TODO: Implement beat grid analysis for WAV
-     * HINT: Uncompressed audio allows more precise beat detection
-     */
-    void analyze_beatgrid() override;
-
-    /**
-     * TODO: Implement quality score calculation
-     * HINT: Use sample rate and bit depth for quality (both higher = better)
-     */
-    double get_quality_score() const override;
-
-    /**
-     * TODO: Implement clone function
-     * HINT: Return a unique_ptr to a new WAVTrack with same properties
-     */
-    PointerWrapper<AudioTrack> clone() const override;
-
-    // Getters
-    int get_sample_rate() const { return sample_rate; }
-    int get_bit_depth() const { return bit_depth; }
-};
-
+#ifndef WAVTRACK_H
+#define WAVTRACK_H
+
+#include "AudioTrack.h"
+#include "WavFile.h"
+#include <memory>
+
+/**
+ * WAVTrack - Represents a WAV audio file with high-quality uncompressed audio
+ * WAV files store raw audio data without compression, providing maximum quality
+ * Students must implement all virtual functions from AudioTrack
+ * 
+ * Phase 4 contracts:
+ * - load(): simulate deck preparation for WAV (often faster due to no decompression).
+ * - analyze_beatgrid(): run immediately after load() in this assignment; can be more precise.
+ * - get_quality_score(): derived from sample_rate and bit_depth (higher => better).
+ * - clone(): return a deep polymorphic copy used by the mixer; source remains unchanged.
+ * - get_quality_score(): function of sample_rate and bit_depth (both higher -> better).
+ *
+ * A track given a file path memory-maps that .wav on load() and exposes its
+ * samples zero-copy through get_pcm(); clones share the mapping. The file's
+ * sample rate, bit depth and duration replace the configured ones, and beat
+ * detection runs on the first ANALYSIS_SECONDS of its decoded samples.
+ * Without a path (or if the file cannot be parsed) load() only reports an
+ * estimate.
+ */
+class WAVTrack : public AudioTrack {
+private:
+    int sample_rate;    // Samples per second: 44100 (CD), 48000 (pro), 96000+ (hi-res)
+    int bit_depth;      // Bits per sample: 16 (CD), 24 (pro), 32 (float)
+    std::string file_path;                  // .wav on disk, "" = metadata only
+    std::shared_ptr<const WavFile> wav_file;  // mapped on first load(), shared by clones
+
+    bool map_file();
+
+protected:
+    /**
+     * Mono mixdown of the mapped file's first ANALYSIS_SECONDS
+     */
+    bool analysis_window(std::vector<double>& samples, double& rate) const override;
+
+public:
+    static const int ANALYSIS_SECONDS = 60;
+
+    /**
+     * Constructor for WAVTrack
+     */
+    WAVTrack(const std::string& title, const std::vector<std::string>& artists, 
+             int duration, int bpm, int sample_rate, int bit_depth,
+             const std::string& file_path = "");
+
+    // ========== TODO: IMPLEMENT VIRTUAL FUNCTIONS ==========
+
+    /**
+     * TODO: Implement load function for WAV files
+     * HINT: WAV files are uncompressed, so loading might be faster
+     */
+    void load() override;
+
+    /**
+     * TODO: Implement beat grid analysis for WAV
+     * HINT: Uncompressed audio allows more precise beat detection
+     */
+    void analyze_beatgrid() override;
+
+    /**
+     * TODO: Implement quality score calculation
+     * HINT: Use sample rate and bit depth for quality (both higher = better)
+     */
+    double get_quality_score() const override;
+
+    /**
+     * TODO: Implement clone function
+     * HINT: Return a unique_ptr to a new WAVTrack with same properties
+     */
+    PointerWrapper<AudioTrack> clone() const override;
+
+    /**
+     * Object size plus waveform and string storage
+     */
+    size_t memory_footprint() const override;
+
+    /**
+     * Score for the given parameters, without a track object. Defined
+     * inline so TrackTable's devirtualized scoring matches this class exactly.
+     */
+    static double quality_score(int sample_rate, int bit_depth) {
+        double score = 70.0;
+        if (sample_rate >= 44100)
+            score += 10.0;
+        if (sample_rate >= 96000)
+            score += 5.0;
+        if (bit_depth >= 16)
+            score += 10.0;
+        if (bit_depth >= 24)
+            score += 5.0;
+        return score < 100.0 ? score : 100.0;
+    }
+
+    // Getters
+    int get_sample_rate() const { return sample_rate; }
+    int get_bit_depth() const { return bit_depth; }
+    const std::string& get_file_path() const { return file_path; }
+
+    /**
+     * Samples of the mapped file, read in place (nullptr until load() has
+     * mapped a file). The view stays valid as long as this track or any
+     * clone of it is alive.
+     */
+    const PcmView* get_pcm() const { return wav_file ? &wav_file->pcm() : nullptr; }
+    const WavFile* get_wav_file() const { return wav_file.get(); }
+};
+
 #endif // WAVTRACK_H
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Zero-copy view of interleaved PCM frames inside a mapped file
+ *
+ * Supports 16/24/32-bit signed integer and 32/64-bit IEEE float samples,
+ * little-endian as stored in WAV files. Nothing is decoded up front;
+ * sample() and decode() convert on demand to doubles in [-1, 1), so only
+ * the pages actually read are faulted in. Valid while the owning WavFile
+ * is alive.
+ */
+class PcmView {
+public:
+    PcmView();
+    PcmView(const uint8_t* bytes, size_t frames, unsigned channels, unsigned bits_per_sample,
+            bool is_float, size_t block_align);
+    PcmView(const PcmView&) = default;
+    PcmView& operator=(const PcmView&) = default;
+
+    bool empty() const { return frame_count == 0; }
+    size_t frames() const { return frame_count; }
+    unsigned channels() const { return channel_count; }
+    unsigned bits_per_sample() const { return bits; }
+    bool is_float() const { return floating; }
+    size_t bytes_per_frame() const { return frame_bytes; }
+
+    /**
+     * @brief Raw little-endian sample bytes (frames() * bytes_per_frame())
+     */
+    const uint8_t* data() const { return pcm; }
+    size_t size_bytes() const { return frame_count * frame_bytes; }
+
+    /**
+     * @brief Sample of `channel` in `frame`, scaled to [-1, 1)
+     */
+    double sample(size_t frame, unsigned channel) const;
+
+    /**
+     * @brief Decode `count` frames of one channel starting at `first`
+     * into out[0..count); the range is clamped to the view.
+     * @return frames written
+     */
+    size_t decode(size_t first, size_t count, unsigned channel, double* out) const;
+
+private:
+    const uint8_t* pcm;
+    size_t frame_count;
+    unsigned channel_count;
+    unsigned bits;
+    bool floating;
+    size_t frame_bytes;
+};
+
+/**
+ * @brief Cue point from a WAV `cue ` chunk
+ */
+struct WavCuePoint {
+    uint32_t id;
+    uint32_t sample_offset;   // frame index into the data chunk
+};
+
+/**
+ * @brief Memory-mapped RIFF/WAVE file
+ *
+ * open() maps the file and walks its chunk headers: `fmt ` (PCM, IEEE
+ * float and WAVE_FORMAT_EXTENSIBLE), `data`, `LIST`/INFO text tags and
+ * `cue ` markers; other chunks are skipped. Only the headers are touched,
+ * so opening a multi-gigabyte file takes the same time as a small one,
+ * and the samples are exposed in place through pcm().
+ *
+ * A data chunk whose declared size runs past the end of the file (common
+ * for recordings that were never finalized) is truncated to what exists.
+ */
+class WavFile {
+public:
+    WavFile();
+
+    WavFile(const WavFile&) = delete;
+    WavFile& operator=(const WavFile&) = delete;
+
+    /**
+     * @brief Map and parse `path`
+     * @return false with error() describing the problem if the file is
+     * missing, not RIFF/WAVE, or in an unsupported sample format
+     */
+    bool open(const std::string& path);
+
+    const PcmView& pcm() const { return samples; }
+    unsigned sample_rate() const { return rate; }
+    double duration_seconds() const;
+
+    /**
+     * @brief LIST/INFO tags by four-character id (e.g. INAM title, IART artist)
+     */
+    const std::map<std::string, std::string>& info() const { return info_tags; }
+    const std::vector<WavCuePoint>& cue_points() const { return cues; }
+
+    size_t file_size() const { return file.size(); }
+    const std::string& path() const { return file.path(); }
+    const std::string& error() const { return last_error; }
+
+private:
+    MappedFile file;
+    PcmView samples;
+    unsigned rate;
+    std::map<std::string, std::string> info_tags;
+    std::vector<WavCuePoint> cues;
+    std::string last_error;
+
+    bool fail(const std::string& message);
+    bool parse_format(const uint8_t* chunk, size_t size, unsigned& channels, unsigned& bits,
+                      bool& is_float, size_t& block_align);
+    void parse_list(const uint8_t* chunk, size_t size);
+    void parse_cue(const uint8_t* chunk, size_t size);
+};
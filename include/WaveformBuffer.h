@@ -0,0 +1,166 @@
+#pragma once
+
+#include "WaveformKernels.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Sample storage format of a WaveformBuffer
+ *
+ * Int16 and Int8 are quantized per block of WaveformBuffer::BLOCK_SAMPLES
+ * samples, each block scaled by its own peak (stored as a float).
+ * Bytes per sample: 8, 4, ~2.03 and ~1.02.
+ */
+enum class WaveformFormat { Float64, Float32, Int16, Int8 };
+
+class WaveformPyramid;
+
+/**
+ * @brief Waveform samples shared by an AudioTrack and its clones
+ *
+ * Waveform data is written once and only read afterwards, so clones share
+ * one buffer through a std::shared_ptr instead of deep-copying it. A track
+ * that wants to write goes through AudioTrack::get_mutable_waveform_data(),
+ * which copies the buffer first if anyone else still holds it
+ * (copy-on-write).
+ *
+ * Generated waveforms are lazy: the buffer only remembers its size and a
+ * WaveformRandom seed until the first read, which allocates and fills it
+ * exactly once (thread-safe). Tracks whose samples are never read never
+ * allocate them. Storage comes from WaveformPool, so it is 64-byte aligned
+ * and recycled rather than freed.
+ *
+ * Samples may be kept in a compact format; data() then returns nullptr and
+ * readers use decode(), which converts back to double with the SIMD kernels.
+ *
+ * pyramid() builds a min/max/RMS WaveformPyramid on first use; it lives as
+ * long as the buffer, so every clone draws overviews from the same one.
+ *
+ * mutable_data() must only be used by the sole owner of the buffer.
+ */
+class WaveformBuffer {
+private:
+    mutable void* storage;     // pool block: samples, then per-block scales
+    size_t count;
+    uint64_t seed;
+    WaveformFormat format;
+    bool generated;     // samples are WaveformRandom::fill(count, seed), encoded in format
+    mutable std::once_flag materialize_once;
+    mutable std::atomic<bool> materialized;
+    mutable std::mutex pyramid_mutex;
+    mutable std::unique_ptr<const WaveformPyramid> pyramid_memo;
+    mutable std::atomic<bool> pyramid_ready;
+
+    void materialize() const;
+    void allocate_storage() const;
+    void encode(const double* source) const;
+    const float* block_scales() const;
+    void drop_pyramid();
+
+    static size_t storage_words(size_t count, WaveformFormat format);
+
+public:
+    static const size_t BLOCK_SAMPLES = 256;
+
+    /**
+     * @brief Format used by AudioTrack for newly created waveforms
+     */
+    static void set_default_format(WaveformFormat format);
+    static WaveformFormat default_format();
+
+    /**
+     * @brief "float64", "float32", "int16" or "int8"
+     */
+    static const char* format_name(WaveformFormat format);
+    static bool parse_format(const std::string& name, WaveformFormat& out);
+
+    /**
+     * @brief Lazily generated noise waveform
+     * @param sample_count Number of samples
+     * @param noise_seed Seed passed to WaveformRandom::fill on first read
+     * @param storage_format How the samples are kept once generated
+     */
+    WaveformBuffer(size_t sample_count, uint64_t noise_seed,
+                   WaveformFormat storage_format = WaveformFormat::Float64);
+
+    /**
+     * @brief Allocate a buffer holding a copy of existing samples
+     */
+    WaveformBuffer(const double* source, size_t sample_count,
+                   WaveformFormat storage_format = WaveformFormat::Float64);
+
+    /**
+     * @brief Re-encode another buffer's samples in a different format
+     * An untouched generated source stays lazy: only the seed is carried over.
+     */
+    WaveformBuffer(const WaveformBuffer& source, WaveformFormat storage_format);
+
+    ~WaveformBuffer();
+
+    WaveformBuffer(const WaveformBuffer&) = delete;
+    WaveformBuffer& operator=(const WaveformBuffer&) = delete;
+
+    /**
+     * @brief The samples as doubles; nullptr unless the format is Float64
+     */
+    const double* data() const {
+        if (format != WaveformFormat::Float64)
+            return nullptr;
+        if (!materialized.load(std::memory_order_acquire))
+            materialize();
+        return static_cast<const double*>(storage);
+    }
+    double* mutable_data() {
+        if (format != WaveformFormat::Float64)
+            return nullptr;
+        data();
+        drop_pyramid();
+        generated = false;
+        return static_cast<double*>(storage);
+    }
+
+    /**
+     * @brief Convert samples [first, first + n) to double, in any format
+     */
+    void decode(size_t first, size_t n, double* out,
+                const WaveformKernels::Table& kernels = WaveformKernels::active()) const;
+
+    size_t size() const { return count; }
+    WaveformFormat getFormat() const { return format; }
+
+    /**
+     * @brief Bytes of sample storage (including block scales) once materialized
+     */
+    size_t storage_bytes() const { return storage_words(count, format) * sizeof(double); }
+
+    /**
+     * @brief Bytes the pool block holding the storage occupies (its size class)
+     */
+    size_t allocated_bytes() const;
+
+    /**
+     * @brief Whether the samples have been allocated yet
+     */
+    bool isMaterialized() const { return materialized.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 64-bit hash of the samples
+     * Untouched generated buffers hash their (size, seed, format) without
+     * being materialized; anything else hashes the stored bytes.
+     */
+    uint64_t content_hash() const;
+
+    /**
+     * @brief Overview pyramid of the samples, built on first call (thread-safe)
+     */
+    const WaveformPyramid& pyramid() const;
+
+    /**
+     * @brief Heap bytes of the pyramid, 0 until pyramid() has been called
+     */
+    size_t pyramid_bytes() const;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Summary statistics of a waveform
+ */
+struct WaveformStats {
+    double rms;                  // root mean square amplitude
+    double peak;                 // max |sample|
+    double crest_factor;         // peak / rms (0 for silence)
+    double zero_crossing_rate;   // sign changes per adjacent sample pair
+
+    WaveformStats() : rms(0.0), peak(0.0), crest_factor(0.0), zero_crossing_rate(0.0) {}
+};
+
+/**
+ * @brief Lowest and highest sample of one overview bucket
+ */
+struct WaveformMinMax {
+    double min;
+    double max;
+
+    WaveformMinMax() : min(0.0), max(0.0) {}
+    WaveformMinMax(double lo, double hi) : min(lo), max(hi) {}
+};
+
+/**
+ * @brief Vectorized waveform analysis kernels with runtime dispatch
+ *
+ * Four primitive loops (sum of squares, peak |x|, zero crossings, min/max),
+ * the radix-2 FFT butterfly used by BeatDetector and the float32 / int16 /
+ * int8 to double conversions used by compact WaveformBuffers exist in
+ * scalar, SSE2 and AVX2 flavours. active() picks the widest one the
+ * CPU supports, once, at first use; the AVX2 variants are compiled with a
+ * function-level target attribute, so no global -mavx2 flag is needed and the
+ * binary still runs on older x86-64 machines. Other architectures get the
+ * scalar table only.
+ *
+ * Loads are unaligned: WaveformPool blocks are 64-byte aligned, but windows
+ * and buckets may start anywhere inside them. Vector sums use several
+ * accumulators, so they can differ from the scalar sum in the last bits.
+ */
+class WaveformKernels {
+public:
+    struct Table {
+        const char* name;
+        double (*sum_squares)(const double* data, size_t count);
+        double (*peak_abs)(const double* data, size_t count);
+        size_t (*zero_crossings)(const double* data, size_t count);
+        void (*min_max)(const double* data, size_t count, double* lo, double* hi);
+        // b' = a - w*b, a' = a + w*b on split complex arrays, element-wise
+        void (*butterflies)(double* ar, double* ai, double* br, double* bi,
+                            const double* wr, const double* wi, size_t count);
+        // out[i] = src[i] (float32) or src[i] * scale (quantized)
+        void (*decode_f32)(const float* src, size_t count, double* out);
+        void (*decode_i16)(const int16_t* src, size_t count, double scale, double* out);
+        void (*decode_i8)(const int8_t* src, size_t count, double scale, double* out);
+    };
+
+    /**
+     * @brief Best table for this CPU
+     */
+    static const Table& active();
+
+    static const Table& scalar();
+
+    /**
+     * @brief SSE2 / AVX2 tables, or nullptr if the CPU (or build target) lacks them
+     */
+    static const Table* sse2();
+    static const Table* avx2();
+
+    /**
+     * @brief RMS, peak, crest factor and zero-crossing rate in one call
+     */
+    static WaveformStats stats(const double* data, size_t count, const Table& kernels = active());
+
+    /**
+     * @brief Mean energy (mean of squares) of each consecutive window
+     * The last window may be shorter.
+     */
+    static std::vector<double> energy_envelope(const double* data, size_t count, size_t window,
+                                               const Table& kernels = active());
+
+    /**
+     * @brief Min/max of each of `buckets` equal slices (for overview drawing)
+     */
+    static std::vector<WaveformMinMax> min_max_downsample(const double* data, size_t count, size_t buckets,
+                                                         const Table& kernels = active());
+};
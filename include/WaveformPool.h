@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Size-class pool for waveform sample buffers
+ *
+ * Clone/evict churn through the controller cache and the mixer decks keeps
+ * allocating and freeing same-sized waveform buffers. The pool rounds each
+ * request up to a size class and keeps freed blocks on a per-class free
+ * list for reuse instead of returning them to malloc. Classes are multiples
+ * of 64 bytes up to 256, then four per octave (1.25, 1.5, 1.75 and 2 times a
+ * power of two), so a request above 256 bytes wastes at most a quarter of
+ * itself; owners report blockBytes() as their footprint. Every block is 64-byte aligned, so
+ * SIMD kernels may use aligned loads on waveform data.
+ *
+ * Requests above MAX_POOLED_BYTES are still aligned but bypass the free
+ * lists. trim() hands all cached blocks back to the system.
+ * All operations are thread-safe.
+ */
+class WaveformPool {
+public:
+    static const size_t ALIGNMENT = 64;
+    static const size_t MAX_POOLED_BYTES = size_t(1) << 26;   // 64 MiB
+
+    struct Stats {
+        uint64_t hits;                 // allocations served from a free list
+        uint64_t misses;               // allocations that went to the system
+        size_t bytes_outstanding;      // bytes (by size class) currently handed out
+        size_t bytes_pooled;           // bytes sitting on free lists
+    };
+
+    /**
+     * @brief Process-wide pool used by WaveformBuffer
+     */
+    static WaveformPool& instance();
+
+    ~WaveformPool();
+
+    WaveformPool(const WaveformPool&) = delete;
+    WaveformPool& operator=(const WaveformPool&) = delete;
+
+    /**
+     * @brief Get a 64-byte aligned block for the given number of samples
+     * @return nullptr if sample_count is 0
+     */
+    double* allocate(size_t sample_count);
+
+    /**
+     * @brief Return a block obtained from allocate() with the same sample_count
+     */
+    void release(double* block, size_t sample_count);
+
+    /**
+     * @brief Free every block on the free lists
+     */
+    void trim();
+
+    /**
+     * @brief Bytes actually held by a block of sample_count samples (its size class)
+     */
+    static size_t blockBytes(size_t sample_count);
+
+    Stats stats() const;
+
+private:
+    std::vector<std::vector<void*>> free_lists;   // indexed by classIndex()
+    mutable std::mutex mutex;
+    Stats counters;
+
+    WaveformPool();
+
+    static size_t classIndex(size_t bytes, size_t& class_bytes);
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "WaveformKernels.h"
+#include <cstddef>
+#include <vector>
+
+class WaveformBuffer;
+
+/**
+ * @brief Min, max and RMS of the samples behind one overview column
+ */
+struct WaveformColumn {
+    double min;
+    double max;
+    double rms;
+
+    WaveformColumn() : min(0.0), max(0.0), rms(0.0) {}
+    WaveformColumn(double lo, double hi, double root_mean_square) : min(lo), max(hi), rms(root_mean_square) {}
+};
+
+/**
+ * @brief Multi-resolution min/max/energy summary of a WaveformBuffer
+ *
+ * Level 0 summarizes blocks of BASE_BLOCK samples; each further level halves
+ * the block count by merging pairs, up to a single block. Entries are
+ * floats, so all levels together take about 24 bytes per BASE_BLOCK samples
+ * (under 5% of float64 storage).
+ *
+ * overview() answers any width in O(width): it reads the coarsest level
+ * whose blocks are at most a quarter of a column, so each column merges
+ * 4 to 8 entries. Column edges are rounded to that level's block edges (off by
+ * less than a quarter column). When a column spans fewer than
+ * 4 * BASE_BLOCK samples the exact path reads the samples directly, which
+ * is still O(width) work.
+ *
+ * Built once per buffer by WaveformBuffer::pyramid() and shared by every
+ * track holding that buffer. Read-only after construction, so concurrent
+ * queries are safe.
+ */
+class WaveformPyramid {
+public:
+    static const size_t BASE_BLOCK = 64;
+
+    /**
+     * @brief Summarize every sample of `source` (decoding compact formats)
+     */
+    explicit WaveformPyramid(const WaveformBuffer& source,
+                             const WaveformKernels::Table& table = WaveformKernels::active());
+
+    WaveformPyramid(const WaveformPyramid&) = delete;
+    WaveformPyramid& operator=(const WaveformPyramid&) = delete;
+
+    /**
+     * @brief Fill `columns` with `width` columns spanning the whole waveform
+     * width is clamped to the sample count; `columns` is reused, so redraws
+     * into the same vector do not allocate.
+     */
+    void overview(size_t width, std::vector<WaveformColumn>& columns) const;
+
+    size_t levels() const { return level_data.size(); }
+
+    /**
+     * @brief Heap bytes held by all levels
+     */
+    size_t memory_bytes() const;
+
+private:
+    struct Level {
+        size_t block;                 // samples per entry
+        std::vector<float> min;
+        std::vector<float> max;
+        std::vector<float> energy;    // sum of squares
+
+        Level() : block(0), min(), max(), energy() {}
+    };
+
+    const WaveformBuffer& samples;
+    const WaveformKernels::Table& kernels;
+    std::vector<Level> level_data;
+
+    void exact_overview(size_t width, std::vector<WaveformColumn>& columns) const;
+};
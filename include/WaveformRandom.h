@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fast, seedable noise source for placeholder waveforms
+ *
+ * Replaces the per-track std::random_device + std::mt19937: each thread owns
+ * a splitmix64 stream that hands out one 64-bit seed per track, and the
+ * samples themselves are produced later, on first read, by xoshiro256+
+ * from that seed. A track's waveform therefore depends only on its seed,
+ * not on which thread materializes it.
+ *
+ * By default every thread seeds itself from std::random_device once.
+ * seed() makes runs reproducible: after it, the n-th track created on the
+ * k-th thread to draw a seed always gets the same waveform.
+ */
+class WaveformRandom {
+public:
+    /**
+     * @brief Use a fixed base seed for all threads (0 restores random seeding)
+     */
+    static void seed(uint64_t base_seed);
+
+    /**
+     * @brief Next per-track seed from the calling thread's stream
+     */
+    static uint64_t nextTrackSeed();
+
+    /**
+     * @brief Fill out[0..count) with uniform samples in [-1, 1) derived from seed
+     */
+    static void fill(double* out, size_t count, uint64_t seed);
+};
@@ -0,0 +1,139 @@
+#include "AnalysisCache.h"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+// Header line of the persisted format; bump the version if the fields change.
+const char* const FILE_HEADER = "# dj analysis cache v1";
+}
+
+AnalysisCache& AnalysisCache::instance() {
+    static AnalysisCache cache;
+    return cache;
+}
+
+AnalysisCache::AnalysisCache() : entries(), mutex(), hits(0), misses(0) {}
+
+bool AnalysisCache::find_beat_grid(uint64_t key, BeatGrid& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end() || !it->second.has_beat_grid) {
+        ++misses;
+        return false;
+    }
+    ++hits;
+    out = it->second.beat_grid;
+    return true;
+}
+
+void AnalysisCache::store_beat_grid(uint64_t key, const BeatGrid& grid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = entries[key];
+    entry.beat_grid = grid;
+    entry.has_beat_grid = true;
+}
+
+bool AnalysisCache::find_stats(uint64_t key, WaveformStats& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end() || !it->second.has_stats) {
+        ++misses;
+        return false;
+    }
+    ++hits;
+    out = it->second.stats;
+    return true;
+}
+
+void AnalysisCache::store_stats(uint64_t key, const WaveformStats& stats) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = entries[key];
+    entry.stats = stats;
+    entry.has_stats = true;
+}
+
+bool AnalysisCache::save(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out)
+        return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    out << FILE_HEADER << '\n';
+    out << "# key grid bpm confidence first_beat stats rms peak crest_factor zero_crossing_rate\n";
+    out << std::setprecision(17);
+    for (const auto& pair : entries) {
+        const Entry& e = pair.second;
+        out << std::hex << pair.first << std::dec << ' '
+            << e.has_beat_grid << ' ' << e.beat_grid.bpm << ' ' << e.beat_grid.confidence << ' '
+            << e.beat_grid.first_beat << ' '
+            << e.has_stats << ' ' << e.stats.rms << ' ' << e.stats.peak << ' '
+            << e.stats.crest_factor << ' ' << e.stats.zero_crossing_rate << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+bool AnalysisCache::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in)
+        return false;
+    std::string line;
+    std::lock_guard<std::mutex> lock(mutex);
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream fields(line);
+        uint64_t key;
+        Entry e;
+        fields >> std::hex >> key >> std::dec
+               >> e.has_beat_grid >> e.beat_grid.bpm >> e.beat_grid.confidence >> e.beat_grid.first_beat
+               >> e.has_stats >> e.stats.rms >> e.stats.peak >> e.stats.crest_factor >> e.stats.zero_crossing_rate;
+        if (!fields)
+            continue;
+        e.beat_grid.analyzed = e.has_beat_grid;
+        entries[key] = e;
+    }
+    return true;
+}
+
+void AnalysisCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    hits = 0;
+    misses = 0;
+}
+
+AnalysisCache::Stats AnalysisCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats s;
+    s.hits = hits;
+    s.misses = misses;
+    s.entries = entries.size();
+    return s;
+}
+
+uint64_t AnalysisCache::combine(uint64_t hash, uint64_t value) {
+    // splitmix64 finalizer over the xor, so every input bit reaches every output bit
+    uint64_t z = hash ^ (value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2));
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t AnalysisCache::hash_string(uint64_t hash, const std::string& text) {
+    return hash_bytes(combine(hash, text.size()), text.data(), text.size());
+}
+
+uint64_t AnalysisCache::hash_bytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        hash = combine(hash, word);
+    }
+    uint64_t tail = 0;
+    if (i < size)
+        std::memcpy(&tail, bytes + i, size - i);
+    return combine(hash, tail ^ size);
+}
@@ -1,19 +1,20 @@
 #include "AudioTrack.h"
+#include "AnalysisCache.h"
+#include "WaveformPool.h"
+#include "WaveformRandom.h"
+#include <cmath>
 #include <iostream>
-#include <cstring>
-#include <random>
 
 AudioTrack::AudioTrack(const std::string& title, const std::vector<std::string>& artists, 
                       int duration, int bpm, size_t waveform_samples)
-    : title(title), artists(artists), duration_seconds(duration), bpm(bpm),
-      waveform_data(nullptr), 
+    : waveform_stats(), waveform_stats_ready(false), envelope_memo(), overview_memo(), beat_grid(),
+      content_key(0), content_key_ready(false), track_id(INVALID_TRACK_ID),
+      title(title), artists(artists), duration_seconds(duration), bpm(bpm),
+      waveform(), 
       waveform_size(waveform_samples) {
-    waveform_data = new double[waveform_size];
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dis(-1.0, 1.0);
-    for (size_t i = 0; i < waveform_size; ++i)
-        waveform_data[i] = dis(gen);
+    // Samples are generated on first read; only the seed is drawn now.
+    waveform = std::make_shared<WaveformBuffer>(waveform_size, WaveformRandom::nextTrackSeed(),
+                                                WaveformBuffer::default_format());
     #ifdef DEBUG
     std::cout << "AudioTrack created: " << title << " by " << std::endl;
     for (const auto& artist : artists)
@@ -30,11 +31,19 @@ AudioTrack::~AudioTrack() {
 }
 
 AudioTrack::AudioTrack(const AudioTrack& other)
-    : title(other.title),
+    : waveform_stats(other.waveform_stats),
+      waveform_stats_ready(other.waveform_stats_ready),
+      envelope_memo(),
+      overview_memo(),
+      beat_grid(other.beat_grid),
+      content_key(other.content_key),
+      content_key_ready(other.content_key_ready),
+      track_id(other.track_id),
+      title(other.title),
       artists(other.artists),
       duration_seconds(other.duration_seconds),
       bpm(other.bpm),
-      waveform_data(nullptr),
+      waveform(),
       waveform_size(other.waveform_size)
 {
     #ifdef DEBUG
@@ -50,27 +59,42 @@ AudioTrack& AudioTrack::operator=(const AudioTrack& other) {
     if (this != &other) {
         clear();
         title = other.title;
+        track_id = other.track_id;
         artists = other.artists;
         duration_seconds = other.duration_seconds;
         bpm = other.bpm;
         waveform_size = other.waveform_size;
         copy_from(other);
+        waveform_stats = other.waveform_stats;
+        waveform_stats_ready = other.waveform_stats_ready;
+        beat_grid = other.beat_grid;
+        content_key = other.content_key;
+        content_key_ready = other.content_key_ready;
     }
     return *this;
 }
 
 AudioTrack::AudioTrack(AudioTrack&& other) noexcept 
-    : title(std::move(other.title)),
+    : waveform_stats(other.waveform_stats),
+      waveform_stats_ready(other.waveform_stats_ready),
+      envelope_memo(std::move(other.envelope_memo)),
+      overview_memo(std::move(other.overview_memo)),
+      beat_grid(other.beat_grid),
+      content_key(other.content_key),
+      content_key_ready(other.content_key_ready),
+      track_id(other.track_id),
+      title(std::move(other.title)),
       artists(std::move(other.artists)),
       duration_seconds(other.duration_seconds),
       bpm(other.bpm),
-      waveform_data(nullptr),
+      waveform(),
       waveform_size(other.waveform_size)
 {
     #ifdef DEBUG
     std::cout << "AudioTrack move constructor called for: " << other.title << std::endl;
     #endif
     move_from(std::move(other));
+    other.invalidate_analysis();
 }
 
 AudioTrack& AudioTrack::operator=(AudioTrack&& other) noexcept {
@@ -80,34 +104,251 @@ AudioTrack& AudioTrack::operator=(AudioTrack&& other) noexcept {
     if (this != &other) {
         clear();
         title = std::move(other.title);
+        track_id = other.track_id;
         artists = std::move(other.artists);
         duration_seconds = other.duration_seconds;
         bpm = other.bpm;
         waveform_size = other.waveform_size;
         move_from(std::move(other));
+        waveform_stats = other.waveform_stats;
+        waveform_stats_ready = other.waveform_stats_ready;
+        envelope_memo = std::move(other.envelope_memo);
+        overview_memo = std::move(other.overview_memo);
+        beat_grid = other.beat_grid;
+        content_key = other.content_key;
+        content_key_ready = other.content_key_ready;
+        other.invalidate_analysis();
     }
     return *this;
 }
 
+namespace {
+// Float64 view of a waveform: the buffer itself, or a pooled decoded copy
+// of a compact one that lives as long as this object.
+class DecodedSamples {
+private:
+    const WaveformBuffer* buffer;
+    double* scratch;
+    const double* samples;
+
+public:
+    explicit DecodedSamples(const WaveformBuffer* source)
+        : buffer(source), scratch(nullptr), samples(source ? source->data() : nullptr) {
+        if (buffer && !samples && buffer->size()) {
+            scratch = WaveformPool::instance().allocate(buffer->size());
+            buffer->decode(0, buffer->size(), scratch);
+            samples = scratch;
+        }
+    }
+    ~DecodedSamples() {
+        if (scratch)
+            WaveformPool::instance().release(scratch, buffer->size());
+    }
+    DecodedSamples(const DecodedSamples&) = delete;
+    DecodedSamples& operator=(const DecodedSamples&) = delete;
+
+    const double* data() const { return samples; }
+};
+}
+
 void AudioTrack::get_waveform_copy(double* buffer, size_t buffer_size) const {
-    if (buffer && waveform_data && buffer_size <= waveform_size)
-        std::memcpy(buffer, waveform_data, buffer_size * sizeof(double));
+    if (buffer && waveform && buffer_size <= waveform_size)
+        waveform->decode(0, buffer_size, buffer);
+}
+
+const double* AudioTrack::get_waveform_data() const {
+    return waveform ? waveform->data() : nullptr;
+}
+
+WaveformFormat AudioTrack::get_waveform_format() const {
+    return waveform ? waveform->getFormat() : WaveformBuffer::default_format();
+}
+
+void AudioTrack::set_waveform_format(WaveformFormat format) {
+    if (!waveform || waveform->getFormat() == format)
+        return;
+    waveform = std::make_shared<WaveformBuffer>(*waveform, format);
+    // Quantization changes the samples, so earlier analysis no longer applies.
+    invalidate_analysis();
+}
+
+double* AudioTrack::get_mutable_waveform_data() {
+    if (!waveform)
+        return nullptr;
+    if (waveform.use_count() > 1 || waveform->getFormat() != WaveformFormat::Float64)
+        waveform = std::make_shared<WaveformBuffer>(*waveform, WaveformFormat::Float64);
+    // The caller may change any sample, so memoized results are stale.
+    invalidate_analysis();
+    return waveform->mutable_data();
+}
+
+const WaveformStats& AudioTrack::get_waveform_stats() const {
+    if (!waveform_stats_ready) {
+        AnalysisCache& cache = AnalysisCache::instance();
+        if (!cache.find_stats(content_hash(), waveform_stats)) {
+            DecodedSamples samples(waveform.get());
+            waveform_stats = WaveformKernels::stats(samples.data(), waveform_size);
+            cache.store_stats(content_hash(), waveform_stats);
+        }
+        waveform_stats_ready = true;
+    }
+    return waveform_stats;
+}
+
+const std::vector<double>& AudioTrack::get_energy_envelope(size_t window) const {
+    auto it = envelope_memo.find(window);
+    if (it == envelope_memo.end()) {
+        DecodedSamples samples(waveform.get());
+        it = envelope_memo.insert(std::make_pair(window,
+                 WaveformKernels::energy_envelope(samples.data(), waveform_size, window))).first;
+    }
+    return it->second;
+}
+
+const std::vector<WaveformMinMax>& AudioTrack::get_min_max_overview(size_t buckets) const {
+    auto it = overview_memo.find(buckets);
+    if (it == overview_memo.end()) {
+        DecodedSamples samples(waveform.get());
+        it = overview_memo.insert(std::make_pair(buckets,
+                 WaveformKernels::min_max_downsample(samples.data(), waveform_size, buckets))).first;
+    }
+    return it->second;
+}
+
+void AudioTrack::get_waveform_overview(size_t width, std::vector<WaveformColumn>& columns) const {
+    if (waveform)
+        waveform->pyramid().overview(width, columns);
+    else
+        columns.clear();
+}
+
+const BeatGrid& AudioTrack::detect_beat_grid() {
+    if (!beat_grid.analyzed) {
+        AnalysisCache& cache = AnalysisCache::instance();
+        std::vector<double> window;
+        double window_rate = 0.0;
+        if (analysis_window(window, window_rate)) {
+            // Keyed by the decoded samples too: they are not part of content_hash().
+            uint64_t key = AnalysisCache::hash_bytes(content_hash(), window.data(), window.size() * sizeof(double));
+            if (!cache.find_beat_grid(key, beat_grid)) {
+                beat_grid = BeatDetector::analyze(window.data(), window.size(), window_rate);
+                cache.store_beat_grid(key, beat_grid);
+            }
+            return beat_grid;
+        }
+        if (cache.find_beat_grid(content_hash(), beat_grid))
+            return beat_grid;
+        double sample_rate = duration_seconds > 0 ? static_cast<double>(waveform_size) / duration_seconds : 0.0;
+        size_t hop = BeatDetector::hop_size(sample_rate);
+        double frame_rate = sample_rate / hop;
+        if (BeatDetector::resolvable(frame_rate, waveform_size / hop)) {
+            beat_grid = BeatDetector::estimate(BeatDetector::onset_strength(get_energy_envelope(hop)), frame_rate);
+        } else {
+            beat_grid = BeatGrid();
+            beat_grid.analyzed = true;
+        }
+        cache.store_beat_grid(content_hash(), beat_grid);
+    }
+    return beat_grid;
+}
+
+TrackId AudioTrack::intern_id() {
+    if (track_id == INVALID_TRACK_ID)
+        track_id = TrackRegistry::instance().intern(title);
+    return track_id;
+}
+
+bool AudioTrack::analysis_window(std::vector<double>& samples, double& sample_rate) const {
+    (void)samples;
+    (void)sample_rate;
+    return false;
+}
+
+uint64_t AudioTrack::content_hash() const {
+    if (!content_key_ready) {
+        uint64_t hash = AnalysisCache::hash_string(0, title);
+        for (const auto& artist : artists)
+            hash = AnalysisCache::hash_string(hash, artist);
+        hash = AnalysisCache::combine(hash, static_cast<uint64_t>(duration_seconds));
+        hash = AnalysisCache::combine(hash, waveform ? waveform->content_hash() : 0);
+        content_key = hash;
+        content_key_ready = true;
+    }
+    return content_key;
+}
+
+double AudioTrack::get_tempo() const {
+    return beat_grid.reliable() ? beat_grid.bpm : static_cast<double>(bpm);
+}
+
+void AudioTrack::set_tempo(double target_bpm) {
+    if (target_bpm <= 0.0)
+        return;
+    if (beat_grid.reliable()) {
+        // Stretching scales every beat position by old/new tempo.
+        beat_grid.first_beat *= beat_grid.bpm / target_bpm;
+        beat_grid.bpm = target_bpm;
+    }
+    bpm = static_cast<int>(std::lround(target_bpm));
+}
+
+void AudioTrack::set_duration(int seconds) {
+    if (seconds == duration_seconds)
+        return;
+    duration_seconds = seconds;
+    invalidate_analysis();
+}
+
+void AudioTrack::invalidate_analysis() {
+    waveform_stats = WaveformStats();
+    waveform_stats_ready = false;
+    envelope_memo.clear();
+    overview_memo.clear();
+    beat_grid = BeatGrid();
+    content_key_ready = false;
+}
+
+namespace {
+// Strings short enough for the small-string buffer own no heap memory.
+size_t string_heap_bytes(const std::string& s) {
+    static const size_t inline_capacity = std::string().capacity();
+    return s.capacity() > inline_capacity ? s.capacity() + 1 : 0;
+}
+}
+
+size_t AudioTrack::waveform_footprint() const {
+    if (!waveform)
+        return 0;
+    size_t bytes = sizeof(WaveformBuffer) + waveform->pyramid_bytes();
+    if (waveform->isMaterialized())
+        bytes += waveform->allocated_bytes();
+    return bytes;
+}
+
+size_t AudioTrack::heap_footprint() const {
+    size_t bytes = string_heap_bytes(title) + waveform_footprint();
+    bytes += artists.capacity() * sizeof(std::string);
+    for (const auto& artist : artists)
+        bytes += string_heap_bytes(artist);
+    return bytes;
+}
+
+size_t AudioTrack::memory_footprint() const {
+    return sizeof(AudioTrack) + heap_footprint();
 }
 
 void AudioTrack::clear() {
-    delete[] waveform_data;
-    waveform_data = nullptr;
+    invalidate_analysis();
+    waveform.reset();
     waveform_size = 0;
 }
 
 void AudioTrack::copy_from(const AudioTrack& other) {
-    waveform_data = new double[waveform_size];
-    for (size_t i = 0; i < waveform_size; i++)
-        waveform_data[i] = other.waveform_data[i];
+    // Samples are immutable once shared; writers detach in get_mutable_waveform_data().
+    waveform = other.waveform;
 }
 
 void AudioTrack::move_from(AudioTrack&& other) {
-    waveform_data = other.waveform_data;
-    other.waveform_data = nullptr;
+    waveform = std::move(other.waveform);
     other.waveform_size = 0;
 }
\ No newline at end of file
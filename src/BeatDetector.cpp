@@ -0,0 +1,321 @@
+#include "BeatDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+const double BeatDetector::MIN_CONFIDENCE = 0.3;
+
+bool BeatGrid::reliable() const {
+    return analyzed && bpm > 0.0 && confidence >= BeatDetector::MIN_CONFIDENCE;
+}
+
+namespace {
+const double PI = 3.14159265358979323846;
+const double PRIOR_CENTER_BPM = 120.0;
+const double PRIOR_OCTAVES = 1.5;   // std-dev of the log2 tempo prior
+const double OFFBEAT_RATIO = 0.85;   // off-beat / on-beat correlation that makes the faster pulse the beat
+const size_t PHASE_BEATS = 64;       // beats used to pick the initial phase
+
+// Twiddles for every radix-2 stage, stored so each stage reads a contiguous
+// run: entries [h, 2h) hold exp(-i*pi*j/h) for the stage with half-size h.
+// The layout does not depend on the transform size, so the table only grows.
+struct Twiddles {
+    std::vector<double> re;
+    std::vector<double> im;
+
+    Twiddles() : re(), im() {}
+};
+
+const Twiddles& twiddles_for(size_t n) {
+    thread_local Twiddles table;
+    if (table.re.size() < n) {
+        size_t from = std::max<size_t>(1, table.re.size());
+        table.re.resize(n, 0.0);
+        table.im.resize(n, 0.0);
+        for (size_t half = from; half < n; half <<= 1)
+            for (size_t j = 0; j < half; ++j) {
+                double angle = -PI * static_cast<double>(j) / static_cast<double>(half);
+                table.re[half + j] = std::cos(angle);
+                table.im[half + j] = std::sin(angle);
+            }
+    }
+    return table;
+}
+
+// In-place iterative radix-2 FFT on split real/imaginary arrays (n = 2^k).
+// Stages with at least four butterflies per group use the SIMD kernel.
+void fft(std::vector<double>& re, std::vector<double>& im, const WaveformKernels::Table& kernels) {
+    const size_t n = re.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+    for (size_t i = 0; i + 1 < n; i += 2) {
+        double r = re[i + 1], m = im[i + 1];
+        re[i + 1] = re[i] - r;
+        im[i + 1] = im[i] - m;
+        re[i] += r;
+        im[i] += m;
+    }
+    const Twiddles& tw = twiddles_for(n);
+    for (size_t half = 2; half < n; half <<= 1)
+        for (size_t start = 0; start < n; start += 2 * half)
+            kernels.butterflies(&re[start], &im[start], &re[start + half], &im[start + half],
+                                &tw.re[half], &tw.im[half], half);
+}
+
+// Spectrum bins 0..n/2 of a real sequence of length n, through one complex
+// FFT of length n/2 on the even/odd samples packed as re/im.
+void real_fft(const std::vector<double>& x, std::vector<double>& out_re, std::vector<double>& out_im,
+              const WaveformKernels::Table& kernels) {
+    const size_t n = x.size();
+    const size_t m = n / 2;
+    std::vector<double> re(m), im(m);
+    for (size_t k = 0; k < m; ++k) {
+        re[k] = x[2 * k];
+        im[k] = x[2 * k + 1];
+    }
+    fft(re, im, kernels);
+    const Twiddles& tw = twiddles_for(n);   // exp(-2*pi*i*k/n) is entry m + k
+    out_re.assign(m + 1, 0.0);
+    out_im.assign(m + 1, 0.0);
+    for (size_t k = 0; k <= m; ++k) {
+        size_t a = k % m, b = (m - k) % m;
+        // Even part E = (Z[k] + conj Z[m-k]) / 2, odd part O = (Z[k] - conj Z[m-k]) / 2i
+        double er = 0.5 * (re[a] + re[b]), ei = 0.5 * (im[a] - im[b]);
+        double orr = 0.5 * (im[a] + im[b]), oi = -0.5 * (re[a] - re[b]);
+        double wr = k < m ? tw.re[m + k] : -1.0;
+        double wi = k < m ? tw.im[m + k] : 0.0;
+        out_re[k] = er + wr * orr - wi * oi;
+        out_im[k] = ei + wr * oi + wi * orr;
+    }
+}
+
+// Linear autocorrelation for lags 0..max_lag (Wiener-Khinchin).
+std::vector<double> autocorrelation(const std::vector<double>& x, size_t max_lag,
+                                    const WaveformKernels::Table& kernels) {
+    size_t n = 4;
+    while (n < x.size() + max_lag + 1)
+        n <<= 1;
+    std::vector<double> padded(n, 0.0);
+    std::copy(x.begin(), x.end(), padded.begin());
+    std::vector<double> re, im;
+    real_fft(padded, re, im, kernels);
+    // The power spectrum is real and even, so a forward FFT inverts it (up to 1/n).
+    const size_t m = n / 2;
+    for (size_t k = 0; k <= m; ++k) {
+        double power = re[k] * re[k] + im[k] * im[k];
+        padded[k] = power;
+        if (k > 0 && k < m)
+            padded[n - k] = power;
+    }
+    real_fft(padded, re, im, kernels);
+    std::vector<double> acf(max_lag + 1);
+    for (size_t lag = 0; lag <= max_lag; ++lag)
+        acf[lag] = re[lag] / static_cast<double>(n);
+    return acf;
+}
+
+// Offset of the vertex of the parabola through (-1, a), (0, b), (1, c).
+double parabolic_offset(double a, double b, double c) {
+    double denom = a - 2.0 * b + c;
+    if (denom >= 0.0)
+        return 0.0;
+    return std::max(-0.5, std::min(0.5, 0.5 * (a - c) / denom));
+}
+
+// Index of the largest r[] in [lo, hi] (clamped to the array).
+size_t peak_in(const std::vector<double>& r, double lo, double hi) {
+    size_t first = static_cast<size_t>(std::max(1.0, std::ceil(lo)));
+    size_t last = std::min(r.size() - 1, static_cast<size_t>(std::floor(hi)));
+    size_t best = first;
+    for (size_t i = first; i <= last; ++i)
+        if (r[i] > r[best])
+            best = i;
+    return best;
+}
+}
+
+size_t BeatDetector::hop_size(double sample_rate, const Options& options) {
+    if (sample_rate <= 0.0 || options.frame_rate <= 0.0)
+        return 1;
+    return std::max<size_t>(1, static_cast<size_t>(std::lround(sample_rate / options.frame_rate)));
+}
+
+bool BeatDetector::resolvable(double frame_rate, size_t frames, const Options& options) {
+    if (frame_rate <= 0.0 || options.min_bpm <= 0.0 || options.max_bpm <= options.min_bpm)
+        return false;
+    double shortest = 60.0 * frame_rate / options.max_bpm;
+    double longest = 60.0 * frame_rate / options.min_bpm;
+    return shortest >= 2.0 && static_cast<double>(frames) >= 4.0 * std::ceil(longest);
+}
+
+std::vector<double> BeatDetector::onset_strength(const std::vector<double>& energy) {
+    std::vector<double> onset(energy.size(), 0.0);
+    double mean = 0.0;
+    for (double e : energy)
+        mean += e;
+    if (energy.empty() || mean <= 0.0)
+        return onset;
+    mean /= static_cast<double>(energy.size());
+
+    double previous = std::log1p(100.0 * energy[0] / mean);
+    for (size_t i = 1; i < energy.size(); ++i) {
+        double current = std::log1p(100.0 * energy[i] / mean);
+        onset[i] = std::max(0.0, current - previous);
+        previous = current;
+    }
+    return onset;
+}
+
+BeatGrid BeatDetector::estimate(const std::vector<double>& onset, double frame_rate, const Options& options,
+                                const WaveformKernels::Table& kernels) {
+    BeatGrid grid;
+    grid.analyzed = true;
+    const size_t frames = onset.size();
+    if (!resolvable(frame_rate, frames, options))
+        return grid;
+    // Lags (in frames) spanned by the tempo range.
+    const size_t min_lag = static_cast<size_t>(std::floor(60.0 * frame_rate / options.max_bpm));
+    const size_t max_lag = static_cast<size_t>(std::ceil(60.0 * frame_rate / options.min_bpm));
+    const size_t horizon = std::min(2 * max_lag + 2, frames / 2);
+
+    double mean = 0.0;
+    for (double v : onset)
+        mean += v;
+    mean /= static_cast<double>(frames);
+    // Light triangular smoothing, so a beat whose onset straddles two frames
+    // still gives a full-height correlation peak at a fractional period.
+    std::vector<double> centered(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        double l2 = onset[i > 1 ? i - 2 : 0];
+        double left = onset[i > 0 ? i - 1 : i];
+        double right = onset[i + 1 < frames ? i + 1 : i];
+        double r2 = onset[i + 2 < frames ? i + 2 : frames - 1];
+        centered[i] = (l2 + 2.0 * left + 3.0 * onset[i] + 2.0 * right + r2) / 9.0 - mean;
+    }
+
+    std::vector<double> r = autocorrelation(centered, horizon, kernels);
+    if (r[0] <= 0.0)
+        return grid;
+    // Unbiased, normalized so r[0] == 1.
+    const double energy = r[0] / static_cast<double>(frames);
+    for (size_t lag = 0; lag <= horizon; ++lag)
+        r[lag] /= energy * static_cast<double>(frames - lag);
+
+    // Comb score: the mean correlation at every multiple of the period up to
+    // the horizon, weighted by the tempo prior.
+    double best_score = -1e300;
+    size_t best_lag = min_lag;
+    for (size_t lag = min_lag; lag <= max_lag; ++lag) {
+        double sum = 0.0;
+        size_t teeth = 0;
+        for (size_t k = 1; k * lag <= horizon; ++k, ++teeth) {
+            double center = static_cast<double>(k * lag);
+            sum += r[peak_in(r, center - 0.5 * k, center + 0.5 * k)];
+        }
+        double octaves = std::log2(60.0 * frame_rate / lag / PRIOR_CENTER_BPM) / PRIOR_OCTAVES;
+        double score = sum / teeth * std::exp(-0.5 * octaves * octaves);
+        if (score > best_score) {
+            best_score = score;
+            best_lag = lag;
+        }
+    }
+
+    // Octave decision, independent of the prior: the faster of two octaves is
+    // the beat only if the onsets between the slower pulse's beats correlate
+    // almost as strongly as the beats themselves.
+    while (2 * best_lag <= max_lag &&
+           r[peak_in(r, best_lag - 1.0, best_lag + 1.0)] <
+               OFFBEAT_RATIO * r[peak_in(r, 2.0 * best_lag - 1.0, 2.0 * best_lag + 1.0)])
+        best_lag = peak_in(r, 2.0 * best_lag - 1.0, 2.0 * best_lag + 1.0);
+    while (best_lag >= 2 * min_lag + 1) {
+        double half = 0.5 * best_lag;
+        size_t faster = peak_in(r, half - 1.0, half + 1.0);
+        if (r[faster] < OFFBEAT_RATIO * r[peak_in(r, best_lag - 1.0, best_lag + 1.0)])
+            break;
+        best_lag = faster;
+    }
+
+    // Refine on the furthest multiple inside the horizon: the peak position
+    // error is divided by k.
+    size_t k = std::max<size_t>(1, (horizon - 1) / best_lag);
+    double center = static_cast<double>(k * best_lag);
+    size_t peak = peak_in(r, center - 0.5 * k, center + 0.5 * k);
+    double period = static_cast<double>(peak);
+    if (peak > 0 && peak < horizon)
+        period += parabolic_offset(r[peak - 1], r[peak], r[peak + 1]);
+    period /= static_cast<double>(k);
+
+    size_t base = peak_in(r, best_lag - 1.0, best_lag + 1.0);
+    grid.confidence = std::max(0.0, std::min(1.0, r[base]));
+
+    // Phase: the offset whose comb over the first beats collects the most
+    // onset strength (few beats, so a small period error cannot smear it).
+    const size_t phases = static_cast<size_t>(std::ceil(period));
+    const double phase_end = std::min(static_cast<double>(frames), PHASE_BEATS * period);
+    std::vector<double> comb(phases, 0.0);
+    for (size_t phase = 0; phase < phases; ++phase)
+        for (double t = static_cast<double>(phase); t + 0.5 < phase_end; t += period)
+            comb[phase] += onset[static_cast<size_t>(t + 0.5)];
+    size_t best_phase = static_cast<size_t>(std::max_element(comb.begin(), comb.end()) - comb.begin());
+    double phase = static_cast<double>(best_phase);
+    if (best_phase > 0 && best_phase + 1 < phases)
+        phase += parabolic_offset(comb[best_phase - 1], comb[best_phase], comb[best_phase + 1]);
+
+    // Refine period and phase together: weighted least-squares line through
+    // the strongest onset within a quarter period of every predicted beat.
+    double sw = 0.0, sj = 0.0, st = 0.0, sjj = 0.0, sjt = 0.0;
+    size_t beats = 0;
+    for (size_t j = 0; phase + j * period < frames; ++j) {
+        double predicted = phase + j * period;
+        size_t lo = static_cast<size_t>(std::max(0.0, std::ceil(predicted - period / 4)));
+        size_t hi = std::min(frames - 1, static_cast<size_t>(predicted + period / 4));
+        size_t m = lo;
+        for (size_t i = lo; i <= hi; ++i)
+            if (onset[i] > onset[m])
+                m = i;
+        double w = onset[m];
+        if (w <= 0.0)
+            continue;
+        double t = static_cast<double>(m);
+        if (m > 0 && m + 1 < frames)
+            t += parabolic_offset(onset[m - 1], onset[m], onset[m + 1]);
+        double jd = static_cast<double>(j);
+        sw += w; sj += w * jd; st += w * t; sjj += w * jd * jd; sjt += w * jd * t;
+        ++beats;
+    }
+    double det = sw * sjj - sj * sj;
+    if (beats >= 8 && det > 0.0) {
+        double fitted = (sw * sjt - sj * st) / det;
+        if (std::fabs(fitted - period) < 0.02 * period) {
+            period = fitted;
+            phase = (st - fitted * sj) / sw;
+            while (phase < 0.0)
+                phase += period;
+        }
+    }
+
+    grid.bpm = 60.0 * frame_rate / period;
+    // An onset in frame i happened somewhere inside that frame: report its middle.
+    grid.first_beat = (phase + 0.5) / frame_rate;
+    return grid;
+}
+
+BeatGrid BeatDetector::analyze(const double* data, size_t count, double sample_rate,
+                               const Options& options, const WaveformKernels::Table& kernels) {
+    if (!data || count == 0 || sample_rate <= 0.0) {
+        BeatGrid grid;
+        grid.analyzed = true;
+        return grid;
+    }
+    size_t hop = hop_size(sample_rate, options);
+    std::vector<double> energy = WaveformKernels::energy_envelope(data, count, hop, kernels);
+    return estimate(onset_strength(energy), sample_rate / hop, options, kernels);
+}
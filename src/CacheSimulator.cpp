@@ -0,0 +1,56 @@
+#include "CacheSimulator.h"
+
+CacheSimulator::CacheSimulator(size_t capacity, const std::string& policy_name, size_t byte_budget)
+    : slots(capacity), keys(capacity, INVALID_TRACK_ID), charged(capacity, 0), index(), free_slots(),
+      policy(make_eviction_policy(policy_name)), byte_budget(byte_budget), bytes_used(0),
+      hits(0), misses(0), evictions(0) {
+    if (!policy)
+        policy = make_eviction_policy("lru");
+    for (size_t i = capacity; i > 0; --i)
+        free_slots.push_back(i - 1);
+    policy->reset(capacity);
+}
+
+bool CacheSimulator::access(const std::string& title, size_t bytes) {
+    return access(TrackRegistry::instance().intern(title), bytes);
+}
+
+bool CacheSimulator::access(TrackId key, size_t bytes) {
+    policy->recordAccess(key);
+    if (key >= index.size())
+        index.resize(static_cast<size_t>(key) + 1, CacheSlot::npos);
+    if (index[key] != CacheSlot::npos) {
+        policy->onHit(slots, index[key]);
+        ++hits;
+        return true;
+    }
+    ++misses;
+    if (slots.empty() || (byte_budget && bytes > byte_budget))
+        return false;
+    policy->prepareInsert(key);
+    while (free_slots.empty() || (byte_budget && bytes_used + bytes > byte_budget)) {
+        size_t victim = policy->victim(slots);
+        if (victim == CacheSlot::npos)
+            return false;
+        policy->onRemove(slots, victim, keys[victim], true);
+        index[keys[victim]] = CacheSlot::npos;
+        keys[victim] = INVALID_TRACK_ID;
+        bytes_used -= charged[victim];
+        charged[victim] = 0;
+        free_slots.push_back(victim);
+        ++evictions;
+    }
+    size_t idx = free_slots.back();
+    free_slots.pop_back();
+    keys[idx] = key;
+    charged[idx] = bytes;
+    bytes_used += bytes;
+    index[key] = idx;
+    policy->onInsert(slots, idx, key);
+    return false;
+}
+
+double CacheSimulator::hitRatio() const {
+    size_t total = hits + misses;
+    return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+}
@@ -1,14 +1,24 @@
 #include "CacheSlot.h"
 
-CacheSlot::CacheSlot() : 
-    track(nullptr), 
-    last_access_time(0), 
-    occupied(false){
+const size_t CacheSlot::npos = static_cast<size_t>(-1);
+
+CacheSlot::CacheSlot() :
+    track(nullptr),
+    last_access_time(0),
+    occupied(false),
+    prev(npos),
+    next(npos),
+    segment(0),
+    frequency(0),
+    key_hash(0),
+    bytes(0),
+    shared(nullptr) {
 }
 
-void CacheSlot::store(PointerWrapper<AudioTrack> track_ptr, uint64_t access_time) {
+void CacheSlot::store(PointerWrapper<AudioTrack> track_ptr, uint64_t access_time, size_t charged_bytes) {
     track = std::move(track_ptr);
     last_access_time = access_time;
+    bytes = charged_bytes;
     occupied = true;
 }
 
@@ -16,7 +26,7 @@ AudioTrack* CacheSlot::access(uint64_t access_time) {
     if (!occupied) {
         return nullptr;
     }
-    
+
     last_access_time = access_time;
     return track.get();
 }
@@ -24,5 +34,23 @@ AudioTrack* CacheSlot::access(uint64_t access_time) {
 void CacheSlot::clear() {
     track.reset(nullptr);
     occupied = false;
+    resetMetadata();
+}
+
+PointerWrapper<AudioTrack> CacheSlot::take() {
+    PointerWrapper<AudioTrack> out(track.release());
+    occupied = false;
+    resetMetadata();
+    return out;
+}
+
+void CacheSlot::resetMetadata() {
     last_access_time = 0;
-}
\ No newline at end of file
+    prev = npos;
+    next = npos;
+    segment = 0;
+    frequency = 0;
+    key_hash = 0;
+    bytes = 0;
+    shared = nullptr;
+}
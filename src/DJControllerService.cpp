@@ -8,10 +8,13 @@ DJControllerService::DJControllerService(size_t cache_size)
     : cache(cache_size) {}
 
 int DJControllerService::loadTrackToCache(AudioTrack& track) {
-    std::string title = track.get_title();
-    if (cache.contains(title)) {
-        cache.get(title);
+    const std::string& title = track.get_title();
+    if (cache.get(track.get_id()))
         return 1;
+    if (!cache.fits(track.memory_footprint())) {
+        std::cerr << "[WARNING] Track: \"" << title << "\" (" << track.memory_footprint()
+                  << " bytes) exceeds the cache budget; not cached" << std::endl;
+        return 0;
     }
     PointerWrapper<AudioTrack> cloned_track = track.clone();
     if (!cloned_track) {
@@ -26,10 +29,41 @@ int DJControllerService::loadTrackToCache(AudioTrack& track) {
     return 0;
 }
 
+int DJControllerService::prefetchTrackToCache(AudioTrack& track,
+                                              const std::function<bool(TrackId)>& can_evict) {
+    const std::string& title = track.get_title();
+    if (cache.contains(track.get_id()))
+        return 1;
+    // Measure the copy as it will be cached: loading can change its footprint.
+    PointerWrapper<AudioTrack> cloned_track = track.clone();
+    if (!cloned_track) {
+        std::cerr << "[ERROR] Track: \"" << title << "\" failed to clone" << std::endl;
+        return -2;
+    }
+    cloned_track->load();
+    cloned_track->analyze_beatgrid();
+    int evicted = cache.putIfApproved(std::move(cloned_track), can_evict);
+    if (evicted < 0)
+        return -2;
+    return evicted > 0 ? -1 : 0;
+}
+
 void DJControllerService::set_cache_size(size_t new_size) {
     cache.set_capacity(new_size);
 }
 
+void DJControllerService::set_cache_bytes(size_t bytes) {
+    cache.set_byte_budget(bytes);
+}
+
+bool DJControllerService::set_cache_policy(const std::string& policy_name) {
+    PointerWrapper<EvictionPolicy> policy = make_eviction_policy(policy_name);
+    if (!policy)
+        return false;
+    cache.set_policy(std::move(policy));
+    return true;
+}
+
 void DJControllerService::displayCacheStatus() const {
     std::cout << "\n=== Cache Status ===\n";
     cache.displayStatus();
@@ -38,4 +72,8 @@ void DJControllerService::displayCacheStatus() const {
 
 AudioTrack* DJControllerService::getTrackFromCache(const std::string& track_title) {
     return cache.get(track_title);
-}
\ No newline at end of file
+}
+
+AudioTrack* DJControllerService::getTrackFromCache(TrackId track_id) {
+    return cache.get(track_id);
+}
\ No newline at end of file
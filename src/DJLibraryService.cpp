@@ -6,8 +6,34 @@
 #include <memory>
 #include <filesystem>
 
+namespace {
+/**
+ * Fill blank title/artists/BPM of an MP3 library entry from the file's
+ * ID3v2 tag (only the frame index and the TIT2/TPE1/TBPM frames are read).
+ * A title that is still blank falls back to the file name.
+ */
+std::shared_ptr<const ID3v2Tag> import_tags(SessionConfig::TrackInfo& info) {
+    std::shared_ptr<ID3v2Tag> tag = std::make_shared<ID3v2Tag>();
+    if (!tag->read(info.file_path) && !tag->error().empty()) {
+        std::cout << "[WARNING] Cannot read ID3 tag of " << info.file_path << ": " << tag->error() << std::endl;
+        return nullptr;
+    }
+    if (info.title.empty())
+        info.title = tag->title();
+    if (info.artists.empty())
+        info.artists = tag->artists();
+    if (info.bpm <= 0)
+        info.bpm = tag->bpm();
+    if (info.title.empty()) {
+        size_t slash = info.file_path.find_last_of('/');
+        info.title = info.file_path.substr(slash == std::string::npos ? 0 : slash + 1);
+    }
+    return tag;
+}
+}
+
 DJLibraryService::DJLibraryService(const Playlist& playlist) 
-    : playlist(playlist), library() {}
+    : playlist(playlist), library(), track_table() {}
 
 DJLibraryService::~DJLibraryService() {
     for (AudioTrack* track : library)
@@ -21,18 +47,31 @@ DJLibraryService::~DJLibraryService() {
  */
 void DJLibraryService::buildLibrary(const std::vector<SessionConfig::TrackInfo>& library_tracks) {
     AudioTrack* new_track = nullptr;
-    for (const auto& info : library_tracks) {
+    // Library titles are interned first, so they get the lowest, densest ids.
+    TrackRegistry::instance().reserve(library_tracks.size());
+    track_table.reserve(track_table.size() + library_tracks.size());
+    for (const auto& entry : library_tracks) {
+        SessionConfig::TrackInfo info = entry;
         if (info.type == "MP3") {
-            new_track = new MP3Track(info.title, info.artists, info.duration_seconds, 
-                                     info.bpm, info.extra_param1, static_cast<bool>(info.extra_param2));
+            std::shared_ptr<const ID3v2Tag> tag;
+            if (!info.file_path.empty())
+                tag = import_tags(info);
+            MP3Track* mp3 = new MP3Track(info.title, info.artists, info.duration_seconds, 
+                                         info.bpm, info.extra_param1, static_cast<bool>(info.extra_param2), info.file_path);
+            if (tag)
+                mp3->set_id3_tag(tag);
+            new_track = mp3;
             std::cout << "[INFO] MP3Track created: " << info.extra_param1 << " kbps" << std::endl;
         } else if (info.type == "WAV") {
             new_track = new WAVTrack(info.title, info.artists, info.duration_seconds, 
-                                     info.bpm, info.extra_param1, info.extra_param2);
+                                     info.bpm, info.extra_param1, info.extra_param2, info.file_path);
             std::cout << "[INFO] WAVTrack created: " << info.extra_param1 << "Hz/" << info.extra_param2 << "bit" << std::endl;
         }
-        if (new_track)
+        if (new_track) {
+            new_track->intern_id();
             library.push_back(new_track);
+            track_table.add(*new_track);
+        }
         new_track = nullptr;
     }
     std::cout << "[INFO] Track library built: " << library_tracks.size() << " tracks loaded" << std::endl;
@@ -66,6 +105,10 @@ AudioTrack* DJLibraryService::findTrack(const std::string& track_title) {
     return playlist.find_track(track_title);
 }
 
+AudioTrack* DJLibraryService::findTrack(TrackId track_id) {
+    return playlist.find_track(track_id);
+}
+
 void DJLibraryService::loadPlaylistFromIndices(const std::string& playlist_name, 
                                                const std::vector<int>& track_indices) {
     std::cout << "[INFO] Loading playlist: " << playlist_name << std::endl;
@@ -90,9 +133,22 @@ void DJLibraryService::loadPlaylistFromIndices(const std::string& playlist_name,
 
 std::vector<std::string> DJLibraryService::getTrackTitles() const {
     std::vector<std::string> titles;
-    std::vector<AudioTrack*> tracks = playlist.getTracks();
-    for (const auto* track : tracks)
-        if (track)
-            titles.push_back(track->get_title());
+    titles.reserve(playlist.get_track_count());
+    playlist.for_each_track([&titles](const AudioTrack& track) { titles.push_back(track.get_title()); });
     return titles;
+}
+
+std::vector<TrackId> DJLibraryService::getLibraryTrackIds() const {
+    std::vector<TrackId> ids;
+    ids.reserve(library.size());
+    for (const AudioTrack* track : library)
+        ids.push_back(track->get_id());
+    return ids;
+}
+
+std::vector<TrackId> DJLibraryService::getTrackIds() const {
+    std::vector<TrackId> ids;
+    ids.reserve(playlist.get_track_count());
+    playlist.for_each_track([&ids](const AudioTrack& track) { ids.push_back(track.get_id()); });
+    return ids;
 }
\ No newline at end of file
@@ -1,6 +1,15 @@
 
 #include "DJSession.h"
+#include "CacheSimulator.h"
+#include "MissRatioCurve.h"
+#include "WaveformPool.h"
+#include "AnalysisCache.h"
+#include "PlaylistOptimizer.h"
+#include "WaveformRandom.h"
+#include <cmath>
+#include <fstream>
 #include <iostream>
+#include <iomanip>
 #include <algorithm>
 #include <sstream>
 #include <dirent.h>
@@ -12,7 +21,11 @@ DJSession::DJSession(const std::string& name, bool play_all)
       mixing_service(),
       config_manager(),
       session_config(),
-      track_titles(),
+      track_ids(),
+      access_trace(),
+      playlist_trace_begin(0),
+      id_positions(),
+      prefetched(),
       play_all(play_all),
       stats() 
 {
@@ -33,7 +46,17 @@ bool DJSession::load_playlist(const std::string& playlist_name)  {
     library_service.loadPlaylistFromIndices(playlist_name, it->second);
     if (library_service.getPlaylist().is_empty())
         return false;
-    track_titles = library_service.getTrackTitles();
+    if (session_config.playlist_order_budget_ms > 0) {
+        PlaylistOrderOptions options;
+        options.bpm_tolerance = session_config.bpm_tolerance;
+        options.time_budget_seconds = session_config.playlist_order_budget_ms / 1000.0;
+        PlaylistOrder result = PlaylistOptimizer(options).optimize(library_service.getPlaylist());
+        library_service.getPlaylist().reorder(result.order);
+        std::cout << "[INFO] Reordered playlist for BPM flow: mixable transitions " << result.initial_mixable
+                  << " -> " << result.mixable << ", cost " << result.initial_cost << " -> " << result.cost
+                  << std::endl;
+    }
+    track_ids = library_service.getTrackIds();
     return true;
 }
 
@@ -42,14 +65,27 @@ bool DJSession::load_playlist(const std::string& playlist_name)  {
  * @return: Cache operation result code
  */
 int DJSession::load_track_to_controller(const std::string& track_name) {
-    AudioTrack* track = library_service.findTrack(track_name);    
+    TrackId track_id = TrackRegistry::instance().find(track_name);
+    if (track_id == INVALID_TRACK_ID) {
+        std::cerr << "[ERROR] Track: \"" << track_name << "\" not found in library" << std::endl;
+        stats.errors++;
+        return 0;
+    }
+    return load_track_to_controller(track_id);
+}
+
+int DJSession::load_track_to_controller(TrackId track_id) {
+    AudioTrack* track = library_service.findTrack(track_id);
+    const std::string& track_name = TrackRegistry::instance().title(track_id);
     if (!track) {
         std::cerr << "[ERROR] Track: \"" << track_name << "\" not found in library" << std::endl;
         stats.errors++;
         return 0;
     }
     std::cout << "[System] Loading track '" << track_name << "' to controller..." << std::endl;
+    access_trace.push_back(std::make_pair(track_id, track->memory_footprint()));
     int result = controller_service.loadTrackToCache(*track);
+    bool was_prefetched = prefetched.erase(track_id) > 0;
     switch (result) {
         case -1:
             stats.cache_misses++;
@@ -59,7 +95,8 @@ int DJSession::load_track_to_controller(const std::string& track_name) {
             stats.cache_misses++;
             break;
         case 1:
-            stats.cache_hits++;
+            if (was_prefetched) stats.prefetch_hits++;
+            else stats.cache_hits++;
             break;
     }
     controller_service.displayCacheStatus();
@@ -71,14 +108,25 @@ int DJSession::load_track_to_controller(const std::string& track_name) {
  * @return: Whether track was successfully loaded to a deck
  */
 bool DJSession::load_track_to_mixer_deck(const std::string& track_title) {
-    AudioTrack* cached_track = controller_service.getTrackFromCache(track_title);
+    TrackId track_id = TrackRegistry::instance().find(track_title);
+    if (track_id == INVALID_TRACK_ID) {
+        std::cerr << "[ERROR] Track: \"" << track_title << "\" not found in cache" << std::endl;
+        stats.errors++;
+        return false;
+    }
+    return load_track_to_mixer_deck(track_id);
+}
+
+bool DJSession::load_track_to_mixer_deck(TrackId track_id) {
+    AudioTrack* cached_track = controller_service.getTrackFromCache(track_id);
+    const std::string& track_title = TrackRegistry::instance().title(track_id);
     if (!cached_track) {
         std::cerr << "[ERROR] Track: \"" << track_title << "\" not found in cache" << std::endl;
         stats.errors++;
         return false;
     }
     int deck_index = mixing_service.loadTrackToDeck(*cached_track);
-    bool flag;
+    bool flag = false;
     switch (deck_index) {
         case 0:
             stats.deck_loads_a++;
@@ -119,7 +167,10 @@ void DJSession::simulate_dj_performance() {
     std::cout << "\nStarting DJ performance simulation..." << std::endl;
     std::cout << "BPM Tolerance: " << session_config.bpm_tolerance << " BPM" << std::endl;
     std::cout << "Auto Sync: " << (session_config.auto_sync ? "enabled" : "disabled") << std::endl;
-    std::cout << "Cache Capacity: " << session_config.controller_cache_size << " slots (LRU policy)" << std::endl;
+    std::cout << "Cache Capacity: " << session_config.controller_cache_size << " slots";
+    if (controller_service.get_cache_byte_budget())
+        std::cout << ", " << controller_service.get_cache_byte_budget() << " bytes";
+    std::cout << " (" << controller_service.get_cache_policy_name() << " policy)" << std::endl;
     std::cout << "\n--- Processing Tracks ---" << std::endl;
     if (play_all) {
         std::vector<std::string> playlists_to_process;
@@ -129,17 +180,36 @@ void DJSession::simulate_dj_performance() {
     for (const auto& playlist_name : playlists_to_process) {            
         if (!load_playlist(playlist_name))
             continue;
-        std::reverse(track_titles.begin(), track_titles.end());
-        for (const auto& title : track_titles) {
-            std::cout << "\n-- Processing: " << title << " --" << std::endl;
+        playlist_trace_begin = access_trace.size();
+        id_positions.clear();
+        for (size_t i = 0; i < track_ids.size(); ++i) {
+            if (track_ids[i] >= id_positions.size())
+                id_positions.resize(static_cast<size_t>(track_ids[i]) + 1);
+            id_positions[track_ids[i]].push_back(i);
+        }
+        for (size_t i = 0; i < track_ids.size(); ++i) {
+            std::cout << "\n-- Processing: " << TrackRegistry::instance().title(track_ids[i]) << " --" << std::endl;
             stats.tracks_processed++;
-            load_track_to_controller(title);
-            load_track_to_mixer_deck(title);
+            load_track_to_controller(track_ids[i]);
+            load_track_to_mixer_deck(track_ids[i]);
+            prefetch_upcoming(i);
         }
         print_session_summary();
     }
+    if (!session_config.controller_trace_file.empty()) {
+        if (save_access_trace(session_config.controller_trace_file))
+            std::cout << "[System] Cache access trace written to: " << session_config.controller_trace_file << std::endl;
+        else
+            std::cerr << "[ERROR] Failed to write cache access trace: " << session_config.controller_trace_file << std::endl;
+    }
     }
     else display_playlist_menu_from_config();
+    if (!session_config.analysis_cache_file.empty()) {
+        if (AnalysisCache::instance().save(session_config.analysis_cache_file))
+            std::cout << "[System] Analysis cache written to: " << session_config.analysis_cache_file << std::endl;
+        else
+            std::cerr << "[ERROR] Failed to write analysis cache: " << session_config.analysis_cache_file << std::endl;
+    }
     std::cout << "Session cancelled by user or all playlists played." << std::endl;
 }
 
@@ -159,9 +229,36 @@ bool DJSession::load_configuration() {
     std::cout << "BPM Tolerance: " << session_config.bpm_tolerance << " BPM" << std::endl;
     std::cout << "Auto Sync: " << (session_config.auto_sync ? "enabled" : "disabled") << std::endl;
     std::cout << "Cache Size: " << session_config.controller_cache_size << " slots" << std::endl;
+    if (session_config.waveform_seed) {
+        WaveformRandom::seed(session_config.waveform_seed);
+        std::cout << "Waveform Seed: " << session_config.waveform_seed << std::endl;
+    }
+    WaveformFormat waveform_format = WaveformFormat::Float64;
+    if (!WaveformBuffer::parse_format(session_config.waveform_format, waveform_format))
+        std::cerr << "[WARNING] Unknown waveform format '" << session_config.waveform_format
+                  << "', using float64" << std::endl;
+    WaveformBuffer::set_default_format(waveform_format);
+    if (waveform_format != WaveformFormat::Float64)
+        std::cout << "Waveform Format: " << WaveformBuffer::format_name(waveform_format) << std::endl;
+    if (!session_config.analysis_cache_file.empty()) {
+        if (AnalysisCache::instance().load(session_config.analysis_cache_file))
+            std::cout << "Analysis Cache: " << AnalysisCache::instance().stats().entries
+                      << " entries from " << session_config.analysis_cache_file << std::endl;
+        else
+            std::cout << "Analysis Cache: starting empty (" << session_config.analysis_cache_file << ")" << std::endl;
+    }
     mixing_service.set_auto_sync(session_config.auto_sync);
     mixing_service.set_bpm_tolerance(session_config.bpm_tolerance);
     controller_service.set_cache_size(session_config.controller_cache_size);
+    controller_service.set_cache_bytes(session_config.controller_cache_bytes);
+    if (session_config.controller_cache_bytes)
+        std::cout << "Cache Budget: " << session_config.controller_cache_bytes << " bytes" << std::endl;
+    if (session_config.controller_prefetch_depth > 0)
+        std::cout << "Prefetch Depth: " << session_config.controller_prefetch_depth << " tracks" << std::endl;
+    if (!controller_service.set_cache_policy(session_config.controller_cache_policy))
+        std::cerr << "[WARNING] Unknown cache policy '" << session_config.controller_cache_policy
+                  << "', using " << controller_service.get_cache_policy_name() << std::endl;
+    std::cout << "Cache Policy: " << controller_service.get_cache_policy_name() << std::endl;
     return true;
 }
 
@@ -206,9 +303,193 @@ void DJSession::print_session_summary() const {
     std::cout << "Cache hits: " << stats.cache_hits << std::endl;
     std::cout << "Cache misses: " << stats.cache_misses << std::endl;
     std::cout << "Cache evictions: " << stats.cache_evictions << std::endl;
+    if (session_config.controller_prefetch_depth > 0) {
+        std::cout << "Prefetch loads: " << stats.prefetch_loads << std::endl;
+        std::cout << "Prefetch hits: " << stats.prefetch_hits << std::endl;
+        std::cout << "Prefetch evictions: " << stats.prefetch_evictions << std::endl;
+    }
+    print_cache_policy_comparison();
+    WaveformPool::Stats pool = WaveformPool::instance().stats();
+    std::cout << "Waveform pool: " << pool.hits << " hits, " << pool.misses << " misses, "
+              << pool.bytes_outstanding << " bytes outstanding" << std::endl;
+    AnalysisCache::Stats analysis = AnalysisCache::instance().stats();
+    std::cout << "Analysis cache: " << analysis.hits << " hits, " << analysis.misses << " misses, "
+              << analysis.entries << " entries" << std::endl;
     std::cout << "Deck A loads: " << stats.deck_loads_a << std::endl;
     std::cout << "Deck B loads: " << stats.deck_loads_b << std::endl;
     std::cout << "Transitions: " << stats.transitions << std::endl;
     std::cout << "Errors: " << stats.errors << std::endl;
     std::cout << "=== Session Complete ===" << std::endl;
-}
\ No newline at end of file
+}
+/*
+ * Prefetch stage: loads the next titles while the current one plays, so their
+ * clone()/load()/analyze_beatgrid() cost is off the demand path. A cached track
+ * may only be evicted for a prefetch if it is not needed before the prefetched
+ * track (Belady's rule restricted to the known playlist).
+ */
+void DJSession::prefetch_upcoming(size_t position) {
+    if (session_config.controller_prefetch_depth <= 0)
+        return;
+    size_t depth = static_cast<size_t>(session_config.controller_prefetch_depth);
+    size_t end = std::min(track_ids.size(), position + 1 + depth);
+    for (size_t j = position + 1; j < end; ++j) {
+        AudioTrack* track = library_service.findTrack(track_ids[j]);
+        if (!track)
+            continue;
+        auto can_evict = [this, position, j](TrackId victim) {
+            return next_use(victim, position) > j;
+        };
+        int result = controller_service.prefetchTrackToCache(*track, can_evict);
+        if (result == -2)
+            break;  // titles further ahead are needed even later; they would be refused too
+        if (result == 1)
+            continue;
+        std::cout << "[System] Prefetched track '" << track->get_title() << "' to controller" << std::endl;
+        stats.prefetch_loads++;
+        if (result == -1)
+            stats.prefetch_evictions++;
+        prefetched.insert(track->get_id());
+    }
+}
+
+size_t DJSession::next_use(TrackId track_id, size_t position) const {
+    if (track_id >= id_positions.size())
+        return track_ids.size();
+    const std::vector<size_t>& positions = id_positions[track_id];
+    auto next = std::upper_bound(positions.begin(), positions.end(), position);
+    return next == positions.end() ? track_ids.size() : *next;
+}
+
+/*
+ * Replays the current playlist's controller lookups against every eviction
+ * policy at the configured capacity, so the active policy can be judged
+ * against the alternatives on the exact same workload. Each replay starts
+ * from an empty cache. Off unless controller_compare_policies is set; each
+ * playlist is replayed once, in its own summary.
+ */
+void DJSession::print_cache_policy_comparison() const {
+    size_t hits = stats.cache_hits + stats.prefetch_hits;
+    size_t lookups = hits + stats.cache_misses;
+    std::ostringstream ratio;
+    ratio << std::fixed << std::setprecision(1)
+          << (lookups ? 100.0 * hits / lookups : 0.0) << "%";
+    std::cout << "Cache hit ratio: " << ratio.str()
+              << " (" << controller_service.get_cache_policy_name() << ")" << std::endl;
+    if (!session_config.controller_compare_policies || playlist_trace_begin >= access_trace.size())
+        return;
+    size_t capacity = controller_service.get_cache_capacity();
+    size_t budget = controller_service.get_cache_byte_budget();
+    std::cout << "Policy comparison (this playlist, " << access_trace.size() - playlist_trace_begin
+              << " lookups, " << capacity << " slots";
+    if (budget)
+        std::cout << ", " << budget << " bytes";
+    std::cout << "):" << std::endl;
+    for (const std::string& name : eviction_policy_names()) {
+        CacheSimulator sim(capacity, name, budget);
+        for (size_t i = playlist_trace_begin; i < access_trace.size(); ++i)
+            sim.access(access_trace[i].first, access_trace[i].second);
+        std::ostringstream line;
+        line << "  " << std::left << std::setw(10) << sim.policyName()
+             << " hits: " << std::setw(6) << sim.getHits()
+             << " evictions: " << std::setw(6) << sim.getEvictions()
+             << " hit ratio: " << std::fixed << std::setprecision(1)
+             << 100.0 * sim.hitRatio() << "%";
+        std::cout << line.str() << std::endl;
+    }
+}
+
+std::vector<std::string> DJSession::playlist_access_stream() const {
+    // Playlist indices refer to the library as built by buildLibrary().
+    std::vector<TrackId> library_ids = library_service.getLibraryTrackIds();
+    std::vector<std::string> stream;
+    for (const auto& pair : session_config.playlists)
+        for (int index : pair.second)
+            if (index >= 1 && index <= static_cast<int>(library_ids.size()))
+                stream.push_back(TrackRegistry::instance().title(library_ids[index - 1]));
+    return stream;
+}
+
+bool DJSession::save_access_trace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out)
+        return false;
+    for (const auto& lookup : access_trace)
+        out << TrackRegistry::instance().title(lookup.first) << '\n';
+    return static_cast<bool>(out);
+}
+
+void DJSession::run_cache_sizing(const std::string& trace_path, double sample_rate) {
+    std::cout << "=== Cache Sizing (Miss Ratio Curve) ===" << std::endl;
+    if (!load_configuration()) {
+        std::cerr << "[ERROR] Failed to load configuration. Aborting cache sizing." << std::endl;
+        return;
+    }
+    std::vector<std::string> trace;
+    if (trace_path.empty()) {
+        library_service.buildLibrary(session_config.library_tracks);
+        trace = playlist_access_stream();
+        std::cout << "Trace source: configured playlists (play-all order)" << std::endl;
+    } else {
+        std::ifstream in(trace_path);
+        if (!in) {
+            std::cerr << "[ERROR] Cannot open trace file: " << trace_path << std::endl;
+            return;
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (!line.empty())
+                trace.push_back(line);
+        }
+        std::cout << "Trace source: " << trace_path << std::endl;
+    }
+    if (trace.empty()) {
+        std::cerr << "[ERROR] Access trace is empty." << std::endl;
+        return;
+    }
+
+    if (sample_rate <= 0.0 || sample_rate > 1.0)
+        sample_rate = MissRatioCurve::auto_sample_rate(trace.size());
+    MissRatioCurve curve(sample_rate);
+    curve.build(trace);
+    size_t distinct = curve.distinctTitles();
+    std::cout << "Accesses: " << curve.accesses() << ", distinct titles: " << distinct
+              << (curve.sampleRate() < 1.0 ? " (estimated)" : "") << std::endl;
+    std::ostringstream rate;
+    rate << std::fixed << std::setprecision(2) << 100.0 * curve.sampleRate() << "%";
+    std::cout << "SHARDS sampling: " << (curve.sampleRate() < 1.0 ? rate.str() : "off (exact)")
+              << ", " << curve.sampledAccesses() << " accesses tracked" << std::endl;
+    if (curve.sampleRate() < 1.0)
+        std::cout << "Note: below " << static_cast<size_t>(std::ceil(1.0 / curve.sampleRate()))
+                  << " slots (1/R) the sampled curve is interpolated within its first bucket; treat it as rough"
+                  << std::endl;
+
+    // Every size up to 16 (the sample config's alternatives), then powers of
+    // two up to the working set, plus the configured size.
+    size_t configured = session_config.controller_cache_size > 0
+                      ? static_cast<size_t>(session_config.controller_cache_size) : 0;
+    std::vector<size_t> sizes;
+    for (size_t size = 1; size <= std::min<size_t>(16, distinct); ++size)
+        sizes.push_back(size);
+    for (size_t size = 32; size < distinct; size *= 2)
+        sizes.push_back(size);
+    sizes.push_back(distinct);
+    if (configured)
+        sizes.push_back(configured);
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+
+    std::cout << "\n" << std::setw(10) << "Slots" << std::setw(12) << "LRU miss"
+              << std::setw(12) << "OPT miss" << std::endl;
+    for (size_t size : sizes) {
+        std::ostringstream row;
+        row << std::fixed << std::setprecision(1)
+            << std::setw(10) << size
+            << std::setw(11) << 100.0 * curve.lruMissRatio(size) << "%"
+            << std::setw(11) << 100.0 * curve.optMissRatio(size) << "%"
+            << (size == configured ? "   <- controller_cache_size" : "");
+        std::cout << row.str() << std::endl;
+    }
+    std::cout << "=== Cache Sizing Complete ===" << std::endl;
+}
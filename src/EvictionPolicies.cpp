@@ -0,0 +1,370 @@
+#include "EvictionPolicies.h"
+#include <algorithm>
+
+// ========== LRU ==========
+
+void LRUPolicy::reset(size_t) {
+    recency.reset();
+}
+
+void LRUPolicy::onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId) {
+    recency.pushFront(slots, idx);
+}
+
+void LRUPolicy::onHit(std::vector<CacheSlot>& slots, size_t idx) {
+    recency.moveToFront(slots, idx);
+}
+
+void LRUPolicy::onRemove(std::vector<CacheSlot>& slots, size_t idx, TrackId, bool) {
+    recency.remove(slots, idx);
+}
+
+size_t LRUPolicy::victim(const std::vector<CacheSlot>&) const {
+    return recency.back();
+}
+
+void LRUPolicy::forEachVictim(const std::vector<CacheSlot>& slots, TrackId, const VictimVisitor& visit) const {
+    for (size_t idx = recency.back(); idx != CacheSlot::npos && visit(idx); idx = slots[idx].getPrev()) {}
+}
+
+// ========== LFU ==========
+
+const uint32_t LFUPolicy::MAX_FREQUENCY;
+
+LFUPolicy::LFUPolicy() : buckets(MAX_FREQUENCY + 1), min_frequency(1) {}
+
+void LFUPolicy::reset(size_t) {
+    for (auto& bucket : buckets)
+        bucket.reset();
+    min_frequency = 1;
+}
+
+void LFUPolicy::onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId) {
+    slots[idx].setFrequency(1);
+    buckets[1].pushFront(slots, idx);
+    min_frequency = 1;
+}
+
+void LFUPolicy::onHit(std::vector<CacheSlot>& slots, size_t idx) {
+    uint32_t freq = slots[idx].getFrequency();
+    if (freq >= MAX_FREQUENCY) {
+        buckets[freq].moveToFront(slots, idx);
+        return;
+    }
+    buckets[freq].remove(slots, idx);
+    if (freq == min_frequency && buckets[freq].empty())
+        ++min_frequency;
+    slots[idx].setFrequency(freq + 1);
+    buckets[freq + 1].pushFront(slots, idx);
+}
+
+void LFUPolicy::onRemove(std::vector<CacheSlot>& slots, size_t idx, TrackId, bool) {
+    buckets[slots[idx].getFrequency()].remove(slots, idx);
+}
+
+size_t LFUPolicy::victim(const std::vector<CacheSlot>&) const {
+    // min_frequency is a lower bound; removals may have emptied that bucket.
+    for (uint32_t f = min_frequency; f <= MAX_FREQUENCY; ++f)
+        if (!buckets[f].empty())
+            return buckets[f].back();
+    return CacheSlot::npos;
+}
+
+void LFUPolicy::forEachVictim(const std::vector<CacheSlot>& slots, TrackId, const VictimVisitor& visit) const {
+    // Evicting never changes another slot's count: walk the buckets in order.
+    for (uint32_t f = min_frequency; f <= MAX_FREQUENCY; ++f)
+        for (size_t idx = buckets[f].back(); idx != CacheSlot::npos; idx = slots[idx].getPrev())
+            if (!visit(idx))
+                return;
+}
+
+// ========== 2Q ==========
+
+TwoQueuePolicy::TwoQueuePolicy() : a1_in(), a_main(), a1_out(), kin(1), kout(1) {}
+
+void TwoQueuePolicy::reset(size_t capacity) {
+    a1_in.reset();
+    a_main.reset();
+    a1_out.clear();
+    // Parameters recommended by the paper: Kin = 25%, Kout = 50% of capacity.
+    kin = std::max<size_t>(1, capacity / 4);
+    kout = std::max<size_t>(1, capacity / 2);
+}
+
+void TwoQueuePolicy::onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId key) {
+    if (a1_out.contains(key)) {
+        a1_out.erase(key);
+        slots[idx].setSegment(A_MAIN);
+        a_main.pushFront(slots, idx);
+    } else {
+        slots[idx].setSegment(A1_IN);
+        a1_in.pushFront(slots, idx);
+    }
+}
+
+void TwoQueuePolicy::onHit(std::vector<CacheSlot>& slots, size_t idx) {
+    // Hits in the FIFO probation queue deliberately do not reorder it.
+    if (slots[idx].getSegment() == A_MAIN)
+        a_main.moveToFront(slots, idx);
+}
+
+void TwoQueuePolicy::onRemove(std::vector<CacheSlot>& slots, size_t idx, TrackId key, bool evicted) {
+    if (slots[idx].getSegment() == A_MAIN) {
+        a_main.remove(slots, idx);
+        return;
+    }
+    a1_in.remove(slots, idx);
+    if (evicted) {
+        a1_out.pushFront(key);
+        while (a1_out.size() > kout)
+            a1_out.popBack();
+    }
+}
+
+size_t TwoQueuePolicy::victim(const std::vector<CacheSlot>&) const {
+    if (!a1_in.empty() && (a1_in.size() > kin || a_main.empty()))
+        return a1_in.back();
+    return a_main.empty() ? CacheSlot::npos : a_main.back();
+}
+
+void TwoQueuePolicy::forEachVictim(const std::vector<CacheSlot>& slots, TrackId, const VictimVisitor& visit) const {
+    size_t in = a1_in.back(), main = a_main.back();
+    size_t in_count = a1_in.size();
+    for (;;) {
+        size_t idx;
+        if (in != CacheSlot::npos && (in_count > kin || main == CacheSlot::npos)) {
+            idx = in;
+            in = slots[in].getPrev();
+            --in_count;
+        } else if (main != CacheSlot::npos) {
+            idx = main;
+            main = slots[main].getPrev();
+        } else {
+            return;
+        }
+        if (!visit(idx))
+            return;
+    }
+}
+
+// ========== ARC ==========
+
+ARCPolicy::ARCPolicy()
+    : t1(), t2(), b1(), b2(), capacity(0), p(0), pending_in_b2(false) {}
+
+void ARCPolicy::reset(size_t new_capacity) {
+    t1.reset();
+    t2.reset();
+    b1.clear();
+    b2.clear();
+    capacity = new_capacity;
+    p = 0;
+    pending_in_b2 = false;
+}
+
+size_t ARCPolicy::targetFor(TrackId key, bool& in_b2) const {
+    in_b2 = false;
+    if (b1.contains(key)) {
+        size_t delta = std::max<size_t>(1, b2.size() / std::max<size_t>(1, b1.size()));
+        return std::min(capacity, p + delta);
+    }
+    if (b2.contains(key)) {
+        size_t delta = std::max<size_t>(1, b1.size() / std::max<size_t>(1, b2.size()));
+        in_b2 = true;
+        return p > delta ? p - delta : 0;
+    }
+    return p;
+}
+
+void ARCPolicy::prepareInsert(TrackId key) {
+    p = targetFor(key, pending_in_b2);
+}
+
+void ARCPolicy::onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId key) {
+    if (b1.contains(key) || b2.contains(key)) {
+        b1.erase(key);
+        b2.erase(key);
+        slots[idx].setSegment(T2);
+        t2.pushFront(slots, idx);
+    } else {
+        slots[idx].setSegment(T1);
+        t1.pushFront(slots, idx);
+    }
+    pending_in_b2 = false;
+    trimGhosts();
+}
+
+void ARCPolicy::onHit(std::vector<CacheSlot>& slots, size_t idx) {
+    if (slots[idx].getSegment() == T1) {
+        t1.remove(slots, idx);
+        slots[idx].setSegment(T2);
+        t2.pushFront(slots, idx);
+    } else {
+        t2.moveToFront(slots, idx);
+    }
+}
+
+void ARCPolicy::onRemove(std::vector<CacheSlot>& slots, size_t idx, TrackId key, bool evicted) {
+    bool from_t1 = slots[idx].getSegment() == T1;
+    (from_t1 ? t1 : t2).remove(slots, idx);
+    if (evicted) {
+        (from_t1 ? b1 : b2).pushFront(key);
+        trimGhosts();
+    }
+}
+
+size_t ARCPolicy::victim(const std::vector<CacheSlot>&) const {
+    if (!t1.empty() && (t2.empty() || t1.size() > p || (pending_in_b2 && t1.size() == p)))
+        return t1.back();
+    return t2.empty() ? CacheSlot::npos : t2.back();
+}
+
+void ARCPolicy::forEachVictim(const std::vector<CacheSlot>& slots, TrackId key, const VictimVisitor& visit) const {
+    // Same choice as victim(), with p adapted as prepareInsert(key) would.
+    bool in_b2;
+    size_t target = targetFor(key, in_b2);
+    size_t from_t1 = t1.back(), from_t2 = t2.back();
+    size_t t1_count = t1.size();
+    for (;;) {
+        size_t idx;
+        if (from_t1 != CacheSlot::npos &&
+            (from_t2 == CacheSlot::npos || t1_count > target || (in_b2 && t1_count == target))) {
+            idx = from_t1;
+            from_t1 = slots[from_t1].getPrev();
+            --t1_count;
+        } else if (from_t2 != CacheSlot::npos) {
+            idx = from_t2;
+            from_t2 = slots[from_t2].getPrev();
+        } else {
+            return;
+        }
+        if (!visit(idx))
+            return;
+    }
+}
+
+void ARCPolicy::trimGhosts() {
+    // Invariants from the paper: |T1| + |B1| <= c and the directory <= 2c.
+    while (!b1.empty() && t1.size() + b1.size() > capacity)
+        b1.popBack();
+    while (t1.size() + t2.size() + b1.size() + b2.size() > 2 * capacity) {
+        if (!b2.empty()) b2.popBack();
+        else if (!b1.empty()) b1.popBack();
+        else break;
+    }
+}
+
+// ========== W-TinyLFU ==========
+
+TinyLFUPolicy::TinyLFUPolicy()
+    : window(), probation(), protected_main(), sketch(), window_capacity(1), protected_capacity(1),
+      last_recorded(INVALID_TRACK_ID) {}
+
+void TinyLFUPolicy::reset(size_t capacity) {
+    window.reset();
+    probation.reset();
+    protected_main.reset();
+    sketch.ensureCapacity(capacity);
+    last_recorded = INVALID_TRACK_ID;
+    // 1% admission window, 80% of the main area protected (Caffeine defaults).
+    window_capacity = std::max<size_t>(1, capacity / 100);
+    size_t main_capacity = capacity > window_capacity ? capacity - window_capacity : 1;
+    protected_capacity = std::max<size_t>(1, main_capacity * 4 / 5);
+}
+
+void TinyLFUPolicy::recordAccess(TrackId key) {
+    sketch.increment(hash_cache_key(key));
+    last_recorded = key;
+}
+
+void TinyLFUPolicy::prepareInsert(TrackId key) {
+    // A demand miss was already counted by its lookup.
+    if (key != last_recorded)
+        sketch.increment(hash_cache_key(key));
+    last_recorded = INVALID_TRACK_ID;
+}
+
+void TinyLFUPolicy::onInsert(std::vector<CacheSlot>& slots, size_t idx, TrackId key) {
+    slots[idx].setKeyHash(hash_cache_key(key));
+    slots[idx].setSegment(WINDOW);
+    window.pushFront(slots, idx);
+    // Overflowing window entries have already won (or skipped) admission.
+    while (window.size() > window_capacity) {
+        size_t demoted = window.back();
+        window.remove(slots, demoted);
+        slots[demoted].setSegment(PROBATION);
+        probation.pushFront(slots, demoted);
+    }
+}
+
+void TinyLFUPolicy::onHit(std::vector<CacheSlot>& slots, size_t idx) {
+    switch (slots[idx].getSegment()) {
+        case WINDOW:
+            window.moveToFront(slots, idx);
+            break;
+        case PROBATION:
+            probation.remove(slots, idx);
+            slots[idx].setSegment(PROTECTED);
+            protected_main.pushFront(slots, idx);
+            if (protected_main.size() > protected_capacity) {
+                size_t demoted = protected_main.back();
+                protected_main.remove(slots, demoted);
+                slots[demoted].setSegment(PROBATION);
+                probation.pushFront(slots, demoted);
+            }
+            break;
+        default:
+            protected_main.moveToFront(slots, idx);
+            break;
+    }
+}
+
+void TinyLFUPolicy::onRemove(std::vector<CacheSlot>& slots, size_t idx, TrackId, bool) {
+    switch (slots[idx].getSegment()) {
+        case WINDOW: window.remove(slots, idx); break;
+        case PROBATION: probation.remove(slots, idx); break;
+        default: protected_main.remove(slots, idx); break;
+    }
+}
+
+size_t TinyLFUPolicy::victim(const std::vector<CacheSlot>& slots) const {
+    size_t main_victim = !probation.empty() ? probation.back()
+                       : (!protected_main.empty() ? protected_main.back() : CacheSlot::npos);
+    if (window.size() < window_capacity || window.empty())
+        return main_victim != CacheSlot::npos ? main_victim : window.back();
+    if (main_victim == CacheSlot::npos)
+        return window.back();
+    // Admission: the window's oldest entry only displaces the main victim if
+    // the sketch says it is more popular.
+    size_t candidate = window.back();
+    uint32_t candidate_freq = sketch.frequency(slots[candidate].getKeyHash());
+    uint32_t victim_freq = sketch.frequency(slots[main_victim].getKeyHash());
+    return candidate_freq > victim_freq ? main_victim : candidate;
+}
+
+void TinyLFUPolicy::forEachVictim(const std::vector<CacheSlot>& slots, TrackId, const VictimVisitor& visit) const {
+    // Estimates are read as they stand; prepareInsert() only adds the newcomer's count.
+    size_t from_window = window.back(), from_probation = probation.back(), from_protected = protected_main.back();
+    size_t window_count = window.size();
+    for (;;) {
+        size_t main_victim = from_probation != CacheSlot::npos ? from_probation : from_protected;
+        size_t idx;
+        if (window_count < window_capacity || window_count == 0 || main_victim == CacheSlot::npos)
+            idx = main_victim != CacheSlot::npos ? main_victim : from_window;
+        else
+            idx = sketch.frequency(slots[from_window].getKeyHash()) > sketch.frequency(slots[main_victim].getKeyHash())
+                      ? main_victim : from_window;
+        if (idx == CacheSlot::npos)
+            return;
+        if (idx == from_window) {
+            from_window = slots[idx].getPrev();
+            --window_count;
+        } else if (idx == from_probation) {
+            from_probation = slots[idx].getPrev();
+        } else {
+            from_protected = slots[idx].getPrev();
+        }
+        if (!visit(idx))
+            return;
+    }
+}
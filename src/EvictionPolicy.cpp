@@ -0,0 +1,118 @@
+#include "EvictionPolicy.h"
+#include "EvictionPolicies.h"
+#include <algorithm>
+#include <cctype>
+
+// ========== SlotList ==========
+
+SlotList::SlotList() : head(CacheSlot::npos), tail(CacheSlot::npos), count(0) {}
+
+void SlotList::pushFront(std::vector<CacheSlot>& slots, size_t idx) {
+    slots[idx].setPrev(CacheSlot::npos);
+    slots[idx].setNext(head);
+    if (head != CacheSlot::npos)
+        slots[head].setPrev(idx);
+    head = idx;
+    if (tail == CacheSlot::npos)
+        tail = idx;
+    ++count;
+}
+
+void SlotList::remove(std::vector<CacheSlot>& slots, size_t idx) {
+    size_t prev = slots[idx].getPrev();
+    size_t next = slots[idx].getNext();
+    if (prev != CacheSlot::npos) slots[prev].setNext(next);
+    else head = next;
+    if (next != CacheSlot::npos) slots[next].setPrev(prev);
+    else tail = prev;
+    slots[idx].setPrev(CacheSlot::npos);
+    slots[idx].setNext(CacheSlot::npos);
+    --count;
+}
+
+void SlotList::moveToFront(std::vector<CacheSlot>& slots, size_t idx) {
+    if (idx == head)
+        return;
+    remove(slots, idx);
+    pushFront(slots, idx);
+}
+
+void SlotList::reset() {
+    head = tail = CacheSlot::npos;
+    count = 0;
+}
+
+// ========== GhostList ==========
+
+void GhostList::pushFront(TrackId key) {
+    erase(key);
+    order.push_front(key);
+    lookup[key] = order.begin();
+}
+
+void GhostList::erase(TrackId key) {
+    auto it = lookup.find(key);
+    if (it == lookup.end())
+        return;
+    order.erase(it->second);
+    lookup.erase(it);
+}
+
+void GhostList::popBack() {
+    if (order.empty())
+        return;
+    lookup.erase(order.back());
+    order.pop_back();
+}
+
+void GhostList::clear() {
+    order.clear();
+    lookup.clear();
+}
+
+// ========== Factory ==========
+
+PointerWrapper<EvictionPolicy> make_eviction_policy(const std::string& name) {
+    std::string key = name;
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    if (key == "lru")
+        return PointerWrapper<EvictionPolicy>(new LRUPolicy());
+    if (key == "lfu")
+        return PointerWrapper<EvictionPolicy>(new LFUPolicy());
+    if (key == "2q")
+        return PointerWrapper<EvictionPolicy>(new TwoQueuePolicy());
+    if (key == "arc")
+        return PointerWrapper<EvictionPolicy>(new ARCPolicy());
+    if (key == "tinylfu" || key == "w-tinylfu")
+        return PointerWrapper<EvictionPolicy>(new TinyLFUPolicy());
+    return PointerWrapper<EvictionPolicy>();
+}
+
+const std::vector<std::string>& eviction_policy_names() {
+    static const std::vector<std::string> names = {"lru", "lfu", "2q", "arc", "tinylfu"};
+    return names;
+}
+
+uint64_t hash_cache_key(const std::string& key) {
+    // FNV-1a followed by a murmur finalizer for well-mixed high bits.
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t hash_cache_key(TrackId key) {
+    // Dense ids differ only in their low bits; the murmur finalizer spreads them.
+    uint64_t h = key + 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
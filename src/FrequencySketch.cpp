@@ -0,0 +1,70 @@
+#include "FrequencySketch.h"
+#include <algorithm>
+
+namespace {
+const uint64_t ROW_SEEDS[4] = {
+    0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+    0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL
+};
+const uint64_t MAX_COUNTER = 15;
+const uint64_t RESET_MASK = 0x7777777777777777ULL;  // clears each nibble's high bit after >> 1
+}
+
+FrequencySketch::FrequencySketch(size_t capacity)
+    : table(), mask(0), additions(0), sample_size(0) {
+    ensureCapacity(capacity);
+}
+
+void FrequencySketch::ensureCapacity(size_t capacity) {
+    size_t words = 1;
+    size_t wanted = std::max<size_t>(capacity, 1);
+    while (words < wanted)
+        words <<= 1;
+    table.assign(words, 0);
+    mask = words - 1;
+    additions = 0;
+    sample_size = 10 * std::max<size_t>(capacity, 1);
+}
+
+size_t FrequencySketch::indexOf(uint64_t hash, int row) const {
+    uint64_t h = (hash + ROW_SEEDS[row]) * ROW_SEEDS[(row + 1) & 3];
+    h ^= h >> 32;
+    return static_cast<size_t>(h) & mask;
+}
+
+void FrequencySketch::increment(uint64_t key_hash) {
+    bool added = false;
+    for (int row = 0; row < 4; ++row) {
+        // Each row owns one nibble of the selected word, picked by the hash.
+        size_t word = indexOf(key_hash, row);
+        int nibble = static_cast<int>(((key_hash >> (row * 8)) & 3) << 2) + (row << 4);
+        uint64_t count = (table[word] >> nibble) & 0xF;
+        if (count < MAX_COUNTER) {
+            table[word] += 1ULL << nibble;
+            added = true;
+        }
+    }
+    if (added && ++additions >= sample_size)
+        halve();
+}
+
+uint32_t FrequencySketch::frequency(uint64_t key_hash) const {
+    uint64_t best = MAX_COUNTER;
+    for (int row = 0; row < 4; ++row) {
+        size_t word = indexOf(key_hash, row);
+        int nibble = static_cast<int>(((key_hash >> (row * 8)) & 3) << 2) + (row << 4);
+        best = std::min(best, (table[word] >> nibble) & 0xF);
+    }
+    return static_cast<uint32_t>(best);
+}
+
+void FrequencySketch::clear() {
+    std::fill(table.begin(), table.end(), 0);
+    additions = 0;
+}
+
+void FrequencySketch::halve() {
+    for (auto& word : table)
+        word = (word >> 1) & RESET_MASK;
+    additions /= 2;
+}
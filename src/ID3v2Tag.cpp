@@ -0,0 +1,398 @@
+#include "ID3v2Tag.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Frame headers are walked through a window of this size; one read usually
+// covers the header, the text frames and the start of the art.
+const size_t WINDOW_BYTES = 16 * 1024;
+
+// Tag-wide unsynchronisation (both versions) and v2.4 frame flags
+const uint8_t TAG_UNSYNCHRONISED = 0x80;
+const uint8_t TAG_EXTENDED_HEADER = 0x40;
+const uint8_t TAG_FOOTER = 0x10;
+const uint16_t V24_GROUPING = 0x0040;
+const uint16_t V24_COMPRESSED = 0x0008;
+const uint16_t V24_ENCRYPTED = 0x0004;
+const uint16_t V24_UNSYNCHRONISED = 0x0002;
+const uint16_t V24_DATA_LENGTH = 0x0001;
+const uint16_t V23_COMPRESSED = 0x0080;
+const uint16_t V23_ENCRYPTED = 0x0040;
+const uint16_t V23_GROUPING = 0x0020;
+
+uint32_t syncsafe(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0] & 0x7F) << 21) | (static_cast<uint32_t>(p[1] & 0x7F) << 14) |
+           (static_cast<uint32_t>(p[2] & 0x7F) << 7) | static_cast<uint32_t>(p[3] & 0x7F);
+}
+
+uint32_t read_be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+bool valid_frame_id(const uint8_t* p) {
+    for (int i = 0; i < 4; ++i)
+        if (!((p[i] >= 'A' && p[i] <= 'Z') || (p[i] >= '0' && p[i] <= '9')))
+            return false;
+    return true;
+}
+
+// Undo unsynchronisation: every 0xFF 0x00 pair was stored for a plain 0xFF.
+template<typename Bytes>
+void remove_unsync(Bytes& data) {
+    size_t out = 0;
+    for (size_t in = 0; in < data.size(); ++in) {
+        data[out++] = data[in];
+        if (static_cast<uint8_t>(data[in]) == 0xFF && in + 1 < data.size() && data[in + 1] == 0)
+            ++in;
+    }
+    data.resize(out);
+}
+
+void append_utf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+/**
+ * Split an encoded string (after the encoding byte) at its terminators and
+ * convert each piece to UTF-8. Returns the byte length consumed up to and
+ * including the first terminator in `first_end` (size if none).
+ */
+std::vector<std::string> decode_strings(uint8_t encoding, const std::string& bytes, size_t& first_end) {
+    std::vector<std::string> values(1);
+    first_end = bytes.size();
+    if (encoding == 1 || encoding == 2) {
+        bool big_endian = true;
+        bool value_start = true;
+        for (size_t i = 0; i + 1 < bytes.size(); i += 2) {
+            uint8_t a = static_cast<uint8_t>(bytes[i]), b = static_cast<uint8_t>(bytes[i + 1]);
+            if (encoding == 1 && value_start && ((a == 0xFF && b == 0xFE) || (a == 0xFE && b == 0xFF))) {
+                big_endian = a == 0xFE;
+                value_start = false;
+                continue;
+            }
+            value_start = false;
+            uint32_t unit = big_endian ? (a << 8) | b : (b << 8) | a;
+            if (unit == 0) {
+                if (first_end == bytes.size())
+                    first_end = i + 2;
+                values.push_back(std::string());
+                value_start = true;
+                continue;
+            }
+            if (unit >= 0xD800 && unit < 0xDC00 && i + 3 < bytes.size()) {
+                uint8_t c = static_cast<uint8_t>(bytes[i + 2]), d = static_cast<uint8_t>(bytes[i + 3]);
+                uint32_t low = big_endian ? (c << 8) | d : (d << 8) | c;
+                if (low >= 0xDC00 && low < 0xE000) {
+                    unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                    i += 2;
+                }
+            }
+            append_utf8(values.back(), unit);
+        }
+    } else {
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            uint8_t c = static_cast<uint8_t>(bytes[i]);
+            if (c == 0) {
+                if (first_end == bytes.size())
+                    first_end = i + 1;
+                values.push_back(std::string());
+            } else if (encoding == 0) {
+                append_utf8(values.back(), c);   // ISO-8859-1 maps straight to code points
+            } else {
+                values.back() += static_cast<char>(c);
+            }
+        }
+    }
+    values.erase(std::remove(values.begin(), values.end(), std::string()), values.end());
+    return values;
+}
+
+bool slash_separated_v23(const char* id) {
+    static const char* const ids[] = {"TPE1", "TPE2", "TPE3", "TPE4", "TCOM", "TEXT", "TOLY", "TOPE"};
+    for (const char* candidate : ids)
+        if (std::strcmp(candidate, id) == 0)
+            return true;
+    return false;
+}
+
+} // namespace
+
+const size_t ID3v2Tag::INLINE_FRAME_BYTES;
+const size_t ID3v2Tag::NOT_INLINE;
+
+ID3v2Tag::ID3v2Tag()
+    : file_path(), major_version(0), tag_flags(0), total_bytes(0), index(), inline_store(), last_error(),
+      read_bytes(0) {}
+
+bool ID3v2Tag::fail(const std::string& message) {
+    last_error = message;
+    major_version = 0;
+    return false;
+}
+
+bool ID3v2Tag::read(const std::string& path) {
+    file_path = path;
+    major_version = 0;
+    tag_flags = 0;
+    total_bytes = 0;
+    index.clear();
+    inline_store.clear();
+    last_error.clear();
+    read_bytes = 0;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return fail(std::strerror(errno));
+    uint8_t header[10];
+    ssize_t got = ::pread(fd, header, sizeof(header), 0);
+    read_bytes += got > 0 ? static_cast<uint64_t>(got) : 0;
+    if (got < static_cast<ssize_t>(sizeof(header)) || std::memcmp(header, "ID3", 3) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (header[3] != 3 && header[3] != 4) {
+        ::close(fd);
+        return fail("unsupported ID3v2." + std::to_string(header[3]) + " tag");
+    }
+    int version = header[3];
+    tag_flags = header[5];
+    uint64_t body = syncsafe(header + 6);
+    total_bytes = 10 + body + ((version == 4 && (tag_flags & TAG_FOOTER)) ? 10 : 0);
+    uint64_t tag_end = 10 + body;
+
+    // Bytes [window_start, window_start + window.size()) of the file, or of the
+    // resynchronised tag when it had to be read whole (v2.3 unsynchronisation).
+    std::vector<uint8_t> window;
+    uint64_t window_start = 0;
+    bool whole = version == 3 && (tag_flags & TAG_UNSYNCHRONISED);
+    if (whole) {
+        window.resize(body);
+        got = ::pread(fd, window.data(), window.size(), 10);
+        read_bytes += got > 0 ? static_cast<uint64_t>(got) : 0;
+        window.resize(got > 0 ? static_cast<size_t>(got) : 0);
+        remove_unsync(window);
+        window_start = 10;
+        tag_end = 10 + window.size();
+    }
+    auto view = [&](uint64_t pos, size_t count) -> const uint8_t* {
+        if (pos >= window_start && pos + count <= window_start + window.size())
+            return window.data() + (pos - window_start);
+        if (whole || pos + count > tag_end)
+            return nullptr;
+        window.resize(static_cast<size_t>(std::min<uint64_t>(std::max(count, WINDOW_BYTES), tag_end - pos)));
+        ssize_t n = ::pread(fd, window.data(), window.size(), static_cast<off_t>(pos));
+        read_bytes += n > 0 ? static_cast<uint64_t>(n) : 0;
+        window.resize(n > 0 ? static_cast<size_t>(n) : 0);
+        window_start = pos;
+        return window.size() >= count ? window.data() : nullptr;
+    };
+
+    uint64_t pos = 10;
+    if (tag_flags & TAG_EXTENDED_HEADER) {
+        const uint8_t* ext = view(pos, 4);
+        if (!ext) {
+            ::close(fd);
+            return fail("truncated extended header");
+        }
+        // v2.3 counts the bytes after the size field, v2.4 the whole header
+        pos += version == 3 ? 4 + read_be32(ext) : syncsafe(ext);
+    }
+    while (pos + 10 <= tag_end) {
+        const uint8_t* h = view(pos, 10);
+        if (!h || h[0] == 0 || !valid_frame_id(h))
+            break;   // padding, or garbage: keep the frames found so far
+        uint32_t size = version == 4 ? syncsafe(h + 4) : read_be32(h + 4);
+        uint64_t payload = pos + 10;
+        if (size > tag_end - payload)
+            break;
+        ID3Frame frame;
+        std::memcpy(frame.id, h, 4);
+        frame.id[4] = '\0';
+        frame.flags = static_cast<uint16_t>((h[8] << 8) | h[9]);
+        frame.size = size;
+        frame.offset = payload;
+        frame.inline_at = NOT_INLINE;
+        if (size <= INLINE_FRAME_BYTES) {
+            const uint8_t* data = view(payload, size);
+            if (data) {
+                frame.inline_at = inline_store.size();
+                inline_store.append(reinterpret_cast<const char*>(data), size);
+            }
+        }
+        index.push_back(frame);
+        pos = payload + size;
+    }
+    ::close(fd);
+    major_version = version;
+    return true;
+}
+
+const ID3Frame* ID3v2Tag::find(const char* id) const {
+    for (const ID3Frame& frame : index)
+        if (std::strncmp(frame.id, id, 4) == 0)
+            return &frame;
+    return nullptr;
+}
+
+bool ID3v2Tag::read_at(uint64_t offset, size_t count, uint8_t* out) const {
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    size_t done = 0;
+    while (done < count) {
+        ssize_t n = ::pread(fd, out + done, count - done, static_cast<off_t>(offset + done));
+        if (n <= 0)
+            break;
+        done += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    return done == count;
+}
+
+bool ID3v2Tag::read_at(uint64_t offset, size_t count, std::string& out) const {
+    out.resize(count);
+    return count == 0 || read_at(offset, count, reinterpret_cast<uint8_t*>(&out[0]));
+}
+
+bool ID3v2Tag::frame_data(const ID3Frame& frame, size_t limit, std::string& out, size_t& full_size,
+                          size_t& prefix) const {
+    bool v24 = major_version == 4;
+    uint16_t flags = frame.flags;
+    if (v24 ? (flags & (V24_COMPRESSED | V24_ENCRYPTED)) : (flags & (V23_COMPRESSED | V23_ENCRYPTED)))
+        return false;
+    prefix = v24 ? ((flags & V24_GROUPING) ? 1 : 0) + ((flags & V24_DATA_LENGTH) ? 4 : 0)
+                 : ((flags & V23_GROUPING) ? 1 : 0);
+    if (prefix > frame.size)
+        return false;
+    // v2.3 tag-wide unsynchronisation was undone when the tag was read whole.
+    bool unsync = v24 && ((flags & V24_UNSYNCHRONISED) || (tag_flags & TAG_UNSYNCHRONISED));
+    size_t stored = frame.size - prefix;
+    size_t want = unsync ? (limit >= stored / 2 ? stored : limit * 2) : std::min(stored, limit);
+
+    std::string raw;
+    if (frame.inline_at != NOT_INLINE) {
+        raw.assign(inline_store, frame.inline_at, prefix + want);
+    } else if (!v24 && (tag_flags & TAG_UNSYNCHRONISED)) {
+        // Offsets are into the resynchronised tag: read it whole again.
+        if (!read_at(10, static_cast<size_t>(total_bytes - 10), raw))
+            return false;
+        remove_unsync(raw);
+        if (frame.offset - 10 + prefix + want > raw.size())
+            return false;
+        raw = raw.substr(static_cast<size_t>(frame.offset - 10), prefix + want);
+    } else if (!read_at(frame.offset, prefix + want, raw)) {
+        return false;
+    }
+    full_size = stored;
+    if (v24 && (flags & V24_DATA_LENGTH))
+        full_size = syncsafe(reinterpret_cast<const uint8_t*>(raw.data()) + prefix - 4);
+    out.assign(raw, prefix, std::string::npos);
+    if (unsync)
+        remove_unsync(out);
+    if (out.size() > limit)
+        out.resize(limit);
+    return true;
+}
+
+std::vector<std::string> ID3v2Tag::text_values(const char* id) const {
+    const ID3Frame* frame = find(id);
+    std::string data;
+    size_t full_size = 0, prefix = 0;
+    if (!frame || id[0] != 'T' || !frame_data(*frame, static_cast<size_t>(-1), data, full_size, prefix) ||
+        data.empty())
+        return std::vector<std::string>();
+    size_t first_end;
+    std::vector<std::string> values =
+        decode_strings(static_cast<uint8_t>(data[0]), data.substr(1), first_end);
+    if (major_version == 3 && slash_separated_v23(id)) {
+        std::vector<std::string> split;
+        for (const std::string& value : values) {
+            size_t start = 0;
+            for (size_t slash; (slash = value.find('/', start)) != std::string::npos; start = slash + 1)
+                if (slash > start)
+                    split.push_back(value.substr(start, slash - start));
+            if (start < value.size())
+                split.push_back(value.substr(start));
+        }
+        values.swap(split);
+    }
+    return values;
+}
+
+std::string ID3v2Tag::text(const char* id) const {
+    std::vector<std::string> values = text_values(id);
+    std::string joined;
+    for (size_t i = 0; i < values.size(); ++i)
+        joined += (i ? "/" : "") + values[i];
+    return joined;
+}
+
+int ID3v2Tag::bpm() const {
+    std::string value = text("TBPM");
+    double parsed = std::strtod(value.c_str(), nullptr);
+    return parsed > 0.0 ? static_cast<int>(std::lround(parsed)) : 0;
+}
+
+bool ID3v2Tag::picture_info(ID3Picture& picture) const {
+    const ID3Frame* frame = find("APIC");
+    std::string data;
+    size_t full_size = 0, prefix = 0;
+    if (!frame || !frame_data(*frame, 1024, data, full_size, prefix) || data.size() < 4)
+        return false;
+    uint8_t encoding = static_cast<uint8_t>(data[0]);
+    size_t mime_end = data.find('\0', 1);
+    if (mime_end == std::string::npos || mime_end + 1 >= data.size())
+        return false;
+    picture.mime = data.substr(1, mime_end - 1);
+    picture.type = static_cast<uint8_t>(data[mime_end + 1]);
+    size_t description_start = mime_end + 2;
+    size_t description_end;
+    std::vector<std::string> description =
+        decode_strings(encoding, data.substr(description_start), description_end);
+    if (description_start + description_end >= data.size() && data.size() < full_size)
+        return false;   // description longer than the bytes read; not a real-world tag
+    picture.description = description.empty() ? std::string() : description[0];
+    picture.image_offset = description_start + description_end;
+    picture.image_bytes = full_size > picture.image_offset ? full_size - picture.image_offset : 0;
+    return true;
+}
+
+bool ID3v2Tag::read_picture(const ID3Picture& picture, std::vector<uint8_t>& image) const {
+    const ID3Frame* frame = find("APIC");
+    std::string data;
+    size_t full_size = 0, prefix = 0;
+    if (!frame || !frame_data(*frame, 0, data, full_size, prefix))
+        return false;
+    bool unsync = (tag_flags & TAG_UNSYNCHRONISED) || (major_version == 4 && (frame->flags & V24_UNSYNCHRONISED));
+    if (frame->inline_at == NOT_INLINE && !unsync) {
+        // Stored as-is: read the image straight into the caller's buffer.
+        image.resize(picture.image_bytes);
+        return picture.image_bytes == 0 ||
+               read_at(frame->offset + prefix + picture.image_offset, picture.image_bytes, image.data());
+    }
+    if (!frame_data(*frame, static_cast<size_t>(-1), data, full_size, prefix) || picture.image_offset > data.size())
+        return false;
+    image.assign(data.begin() + static_cast<std::ptrdiff_t>(picture.image_offset), data.end());
+    return true;
+}
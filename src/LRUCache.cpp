@@ -1,95 +1,315 @@
 #include "LRUCache.h"
+#include "EvictionPolicies.h"
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+#include <utility>
 
-LRUCache::LRUCache(size_t capacity)
-    : slots(capacity), max_size(capacity), access_counter(0) {}
+LRUCache::LRUCache(size_t capacity, std::atomic<uint64_t>* clock)
+    : slots(capacity), index(), occupied(0), free_slots(), policy(new LRUPolicy()),
+      max_size(capacity), byte_budget(0), bytes_used(0), shared_charges(), access_counter(0),
+      shared_clock(clock) {
+    resetBookkeeping();
+}
 
-bool LRUCache::contains(const std::string& track_id) const {
+bool LRUCache::contains(TrackId track_id) const {
     return findSlot(track_id) != max_size;
 }
 
-AudioTrack* LRUCache::get(const std::string& track_id) {
+bool LRUCache::contains(const std::string& title) const {
+    return contains(TrackRegistry::instance().find(title));
+}
+
+AudioTrack* LRUCache::get(TrackId track_id) {
+    policy->recordAccess(track_id);
     size_t idx = findSlot(track_id);
     if (idx == max_size) return nullptr;
-    return slots[idx].access(++access_counter);
+    return touch(idx);
+}
+
+AudioTrack* LRUCache::get(const std::string& title) {
+    return get(TrackRegistry::instance().find(title));
 }
 
 bool LRUCache::put(PointerWrapper<AudioTrack> track) {
-    if (!track) return false;
-    size_t existing_idx = findSlot(track->get_title());
+    if (!track || track->get_id() == INVALID_TRACK_ID) return false;
+    TrackId id = track->get_id();
+    size_t existing_idx = findSlot(id);
     if (existing_idx != max_size) {
-        slots[existing_idx].access(++access_counter);
+        touch(existing_idx);
         return false;
     }
+    if (!fits(track->memory_footprint()))
+        return false;
+    policy->prepareInsert(id);
+    // With a slot and a budget the entry fits, emptying the cache always
+    // makes room, so running out of victims means the bookkeeping is broken.
+    // The charge is re-read each round: a victim may share the waveform.
     bool evicted = false;
-    size_t insert_idx = findEmptySlot();
-    if (insert_idx == max_size) {
+    while (!hasRoomFor(chargeFor(*track))) {
         if (!evictLRU())
-            return false;
-        insert_idx = findEmptySlot();
+            throw std::runtime_error("LRUCache::put: no victim left for an entry that fits");
         evicted = true;
     }
-    if (insert_idx != max_size)
-        slots[insert_idx].store(std::move(track), ++access_counter);
+    insert(std::move(track));
     return evicted;
 }
 
+int LRUCache::putIfApproved(PointerWrapper<AudioTrack> track, const std::function<bool(TrackId)>& can_evict) {
+    if (!track || track->get_id() == INVALID_TRACK_ID)
+        return -1;
+    TrackId id = track->get_id();
+    if (findSlot(id) != max_size || !fits(track->memory_footprint()))
+        return -1;
+    // Vet the victims before evicting any; only then may the policy adapt
+    // (ARC/2Q ghost hits) to the newcomer. Shared waveforms are freed with
+    // their last holder, and the newcomer pays for its own once no survivor does.
+    const WaveformBuffer* buffer = track->get_waveform_buffer();
+    size_t own_bytes = track->memory_footprint() - track->waveform_footprint();
+    std::unordered_map<const WaveformBuffer*, size_t> holders_left;
+    std::vector<size_t> victims;
+    size_t free_count = free_slots.size();
+    size_t bytes_left = bytes_used;
+    bool refused = false;
+    auto holders = [&](const WaveformBuffer* b) -> size_t& {
+        auto it = holders_left.find(b);
+        if (it == holders_left.end()) {
+            auto charged = shared_charges.find(b);
+            it = holders_left.insert(std::make_pair(b, charged == shared_charges.end() ? 0 : charged->second.holders)).first;
+        }
+        return it->second;
+    };
+    auto has_room = [&]() {
+        size_t bytes = own_bytes + (buffer && holders(buffer) == 0 ? track->waveform_footprint() : 0);
+        return free_count > 0 && (!byte_budget || bytes_left + bytes <= byte_budget);
+    };
+    if (!has_room()) {
+        policy->forEachVictim(slots, id, [&](size_t idx) {
+            if (!can_evict(slots[idx].getTrack()->get_id())) {
+                refused = true;
+                return false;
+            }
+            victims.push_back(idx);
+            ++free_count;
+            bytes_left -= slots[idx].getBytes();
+            const WaveformBuffer* shared = slots[idx].getSharedBuffer();
+            if (shared && --holders(shared) == 0)
+                bytes_left -= shared_charges.find(shared)->second.bytes;
+            return !has_room();
+        });
+    }
+    if (refused || !has_room())
+        return -1;
+    policy->prepareInsert(id);
+    for (size_t idx : victims)
+        evictSlot(idx);
+    insert(std::move(track));
+    return static_cast<int>(victims.size());
+}
+
+bool LRUCache::hasRoomFor(size_t bytes) const {
+    return findEmptySlot() != max_size && (!byte_budget || bytes_used + bytes <= byte_budget);
+}
+
+size_t LRUCache::chargeFor(const AudioTrack& track) const {
+    size_t bytes = track.memory_footprint() - track.waveform_footprint();
+    const WaveformBuffer* buffer = track.get_waveform_buffer();
+    if (buffer && shared_charges.find(buffer) == shared_charges.end())
+        bytes += track.waveform_footprint();
+    return bytes;
+}
+
+void LRUCache::insert(PointerWrapper<AudioTrack> track) {
+    TrackId id = track->get_id();
+    size_t bytes = track->memory_footprint() - track->waveform_footprint();
+    size_t insert_idx = findEmptySlot();
+    free_slots.pop_back();
+    // put()/putIfApproved() turned INVALID_TRACK_ID away, so this never asks for 4G entries.
+    if (id >= index.size())
+        index.resize(static_cast<size_t>(id) + 1, CacheSlot::npos);
+    index[id] = insert_idx;
+    ++occupied;
+    slots[insert_idx].store(std::move(track), nextTick(), bytes);
+    bytes_used += bytes;
+    chargeShared(insert_idx);
+    policy->onInsert(slots, insert_idx, id);
+}
+
+void LRUCache::chargeShared(size_t idx) {
+    const AudioTrack* track = slots[idx].getTrack();
+    const WaveformBuffer* buffer = track->get_waveform_buffer();
+    slots[idx].setSharedBuffer(buffer);
+    if (!buffer)
+        return;
+    SharedCharge& charge = shared_charges[buffer];
+    if (charge.holders++ == 0) {
+        charge.bytes = track->waveform_footprint();
+        bytes_used += charge.bytes;
+    }
+}
+
+void LRUCache::releaseShared(size_t idx) {
+    const WaveformBuffer* buffer = slots[idx].getSharedBuffer();
+    slots[idx].setSharedBuffer(nullptr);
+    if (!buffer)
+        return;
+    auto it = shared_charges.find(buffer);
+    if (--it->second.holders == 0) {
+        bytes_used -= it->second.bytes;
+        shared_charges.erase(it);
+    }
+}
+
+void LRUCache::remeasure(size_t idx) {
+    const AudioTrack* track = slots[idx].getTrack();
+    size_t bytes = track->memory_footprint() - track->waveform_footprint();
+    bytes_used = bytes_used - slots[idx].getBytes() + bytes;
+    slots[idx].setBytes(bytes);
+    const WaveformBuffer* buffer = track->get_waveform_buffer();
+    if (buffer != slots[idx].getSharedBuffer()) {
+        releaseShared(idx);
+        chargeShared(idx);
+    } else if (buffer) {
+        SharedCharge& charge = shared_charges.find(buffer)->second;
+        size_t current = track->waveform_footprint();
+        bytes_used = bytes_used - charge.bytes + current;
+        charge.bytes = current;
+    }
+}
+
 bool LRUCache::evictLRU() {
-    size_t lru = findLRUSlot();
-    if (lru == max_size || !slots[lru].isOccupied()) return false;
-    slots[lru].clear();
+    size_t victim = findLRUSlot();
+    if (victim == max_size || !slots[victim].isOccupied()) return false;
+    evictSlot(victim);
     return true;
 }
 
+void LRUCache::evictSlot(size_t idx) {
+    TrackId id = slots[idx].getTrack()->get_id();
+    policy->onRemove(slots, idx, id, true);
+    index[id] = CacheSlot::npos;
+    --occupied;
+    bytes_used -= slots[idx].getBytes();
+    releaseShared(idx);
+    slots[idx].clear();
+    free_slots.push_back(idx);
+}
+
+uint64_t LRUCache::lruAccessTime() const {
+    size_t victim = findLRUSlot();
+    return victim == max_size ? UINT64_MAX : slots[victim].getLastAccessTime();
+}
+
 size_t LRUCache::size() const {
-    size_t count = 0;
-    for (const auto& slot : slots) if (slot.isOccupied()) ++count;
-    return count;
+    return occupied;
 }
 
 void LRUCache::clear() {
     for (auto& slot : slots)
         slot.clear();
+    resetBookkeeping();
 }
 
 void LRUCache::displayStatus() const {
     std::cout << "[LRUCache] Status: " << size() << "/" << max_size << " slots used\n";
-    for (size_t i = 0; i < max_size; ++i)
-        if(slots[i].isOccupied())
-            std::cout << "  Slot " << i << ": " << slots[i].getTrack()->get_title()
-                      << " (last access: " << slots[i].getLastAccessTime() << ")\n";
-        else std::cout << "  Slot " << i << ": [EMPTY]\n";
+    if (byte_budget)
+        std::cout << "[LRUCache] Memory: " << bytes_used << "/" << byte_budget << " bytes used\n";
+    else
+        std::cout << "[LRUCache] Memory: " << bytes_used << " bytes used (no byte budget)\n";
+    for (size_t i = 0; i < max_size; ++i) {
+        if (!slots[i].isOccupied()) {
+            std::cout << "  Slot " << i << ": [EMPTY]\n";
+            continue;
+        }
+        std::cout << "  Slot " << i << ": " << slots[i].getTrack()->get_title()
+                  << " (last access: " << slots[i].getLastAccessTime()
+                  << ", " << slots[i].getBytes() << " bytes";
+        auto charge = shared_charges.find(slots[i].getSharedBuffer());
+        if (charge != shared_charges.end())
+            std::cout << " + " << charge->second.bytes << " waveform bytes"
+                      << (charge->second.holders > 1 ? " shared" : "");
+        std::cout << ")\n";
+    }
 }
 
-size_t LRUCache::findSlot(const std::string& track_id) const {
-    for (size_t i = 0; i < max_size; ++i)
-        if (slots[i].isOccupied() && slots[i].getTrack()->get_title() == track_id) return i;
-    return max_size;
-
+size_t LRUCache::findSlot(TrackId track_id) const {
+    // Ids past the end of the index (or INVALID_TRACK_ID) were never inserted.
+    if (track_id >= index.size() || index[track_id] == CacheSlot::npos)
+        return max_size;
+    return index[track_id];
 }
 
 size_t LRUCache::findLRUSlot() const {
-    size_t lru_index = max_size, min_time = -1, time;
-    for (size_t i = 0; i < max_size; i++)
-        if (slots[i].isOccupied()) {
-            time = slots[i].getLastAccessTime();
-            if (time < min_time) {
-                min_time = time;
-                lru_index = i;
-            }
-        }
-    return lru_index;
+    size_t victim = policy->victim(slots);
+    return victim == CacheSlot::npos ? max_size : victim;
 }
 
 size_t LRUCache::findEmptySlot() const {
-    for (size_t i = 0; i < max_size; ++i)
-        if (!slots[i].isOccupied()) return i;
-    return max_size;
+    return free_slots.empty() ? max_size : free_slots.back();
+}
+
+AudioTrack* LRUCache::touch(size_t idx) {
+    remeasure(idx);
+    policy->onHit(slots, idx);
+    return slots[idx].access(nextTick());
+}
+
+uint64_t LRUCache::nextTick() {
+    if (shared_clock)
+        return shared_clock->fetch_add(1, std::memory_order_relaxed) + 1;
+    return ++access_counter;
+}
+
+void LRUCache::resetBookkeeping() {
+    index.clear();
+    occupied = 0;
+    free_slots.clear();
+    bytes_used = 0;
+    shared_charges.clear();
+    policy->reset(max_size);
+    // Lowest index is handed out first, matching the original first-empty scan.
+    for (size_t i = max_size; i > 0; --i)
+        free_slots.push_back(i - 1);
+}
+
+void LRUCache::rebuild() {
+    // Order the survivors oldest first, then keep the newest that still fit.
+    std::vector<std::pair<uint64_t, size_t>> order;
+    for (size_t i = 0; i < slots.size(); ++i)
+        if (slots[i].isOccupied())
+            order.push_back(std::make_pair(slots[i].getLastAccessTime(), i));
+    std::sort(order.begin(), order.end());
+    size_t skip = order.size() > max_size ? order.size() - max_size : 0;
+    std::vector<AudioTrack*> keep;
+    for (size_t i = 0; i < order.size(); ++i) {
+        AudioTrack* track = slots[order[i].second].take().release();
+        if (i < skip) delete track;
+        else keep.push_back(track);
+    }
+    slots.clear();
+    slots.resize(max_size);
+    resetBookkeeping();
+    for (AudioTrack* track : keep)
+        put(PointerWrapper<AudioTrack>(track));
 }
 
 void LRUCache::set_capacity(size_t capacity){
     if (max_size == capacity)
         return;
     max_size = capacity;
-    slots.resize(capacity);
-}
\ No newline at end of file
+    rebuild();
+}
+
+void LRUCache::set_byte_budget(size_t bytes) {
+    if (byte_budget == bytes)
+        return;
+    byte_budget = bytes;
+    rebuild();
+}
+
+void LRUCache::set_policy(PointerWrapper<EvictionPolicy> new_policy) {
+    if (!new_policy)
+        return;
+    policy = std::move(new_policy);
+    rebuild();
+}
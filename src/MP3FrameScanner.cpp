@@ -0,0 +1,296 @@
+#include "MP3FrameScanner.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// kbps by [row][bitrate index]; rows: V1 L1, V1 L2, V1 L3, V2/2.5 L1, V2/2.5 L2+L3
+const unsigned BITRATES[5][16] = {
+    {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0},
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0},
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0},
+};
+
+const unsigned MPEG1_SAMPLE_RATES[3] = {44100, 48000, 32000};
+
+const size_t PROBE_BYTES = 16 * 1024;
+
+struct FrameHeader {
+    int version;
+    int layer;
+    unsigned bitrate_kbps;
+    unsigned sample_rate;
+    unsigned channels;
+    unsigned samples;
+    size_t frame_bytes;
+};
+
+bool parse_header(const uint8_t* p, FrameHeader& h) {
+    if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0)
+        return false;
+    unsigned version_bits = (p[1] >> 3) & 3;
+    unsigned layer_bits = (p[1] >> 1) & 3;
+    unsigned bitrate_index = p[2] >> 4;
+    unsigned rate_index = (p[2] >> 2) & 3;
+    if (version_bits == 1 || layer_bits == 0 || bitrate_index == 0 || bitrate_index == 15 || rate_index == 3)
+        return false;
+    h.version = version_bits == 3 ? 1 : version_bits == 2 ? 2 : 25;
+    h.layer = 4 - static_cast<int>(layer_bits);
+    int row = h.version == 1 ? h.layer - 1 : (h.layer == 1 ? 3 : 4);
+    h.bitrate_kbps = BITRATES[row][bitrate_index];
+    h.sample_rate = MPEG1_SAMPLE_RATES[rate_index] / (h.version == 1 ? 1 : h.version == 2 ? 2 : 4);
+    h.channels = (p[3] >> 6) == 3 ? 1 : 2;
+    unsigned padding = (p[2] >> 1) & 1;
+    if (h.layer == 1) {
+        h.samples = 384;
+        h.frame_bytes = (12000 * h.bitrate_kbps / h.sample_rate + padding) * 4;
+    } else {
+        h.samples = (h.layer == 3 && h.version != 1) ? 576 : 1152;
+        h.frame_bytes = (h.samples / 8) * 1000 * h.bitrate_kbps / h.sample_rate + padding;
+    }
+    return true;
+}
+
+bool same_stream(const FrameHeader& a, const FrameHeader& b) {
+    return a.version == b.version && a.layer == b.layer && a.sample_rate == b.sample_rate;
+}
+
+uint32_t read_be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+/**
+ * Sequential block reader over a file descriptor. Reads start at
+ * PROBE_BYTES, enough for tags and a first frame, and double up to the
+ * buffer size, so header-only scans stay small and full scans use large
+ * blocks. Skips past the buffered bytes become seeks.
+ */
+class BlockReader {
+public:
+    BlockReader(int descriptor, std::vector<uint8_t>& storage)
+        : fd(descriptor), buf(storage), pos(0), end(0), base(0), read_bytes(0),
+          next_read(std::min(PROBE_BYTES, storage.size())), at_eof(false) {}
+
+    // Bytes available at the cursor, reading on if fewer than `want`
+    size_t fill(size_t want) {
+        if (end - pos >= want || at_eof)
+            return end - pos;
+        std::memmove(buf.data(), buf.data() + pos, end - pos);
+        base += pos;
+        end -= pos;
+        pos = 0;
+        if (want > buf.size())
+            buf.resize(want);
+        while (end < want && !at_eof) {
+            size_t chunk = std::min(std::max(next_read, want - end), buf.size() - end);
+            next_read = std::min(next_read * 2, buf.size());
+            ssize_t n = ::read(fd, buf.data() + end, chunk);
+            if (n <= 0) {
+                at_eof = true;
+                break;
+            }
+            end += static_cast<size_t>(n);
+            read_bytes += static_cast<uint64_t>(n);
+        }
+        return end - pos;
+    }
+
+    const uint8_t* cursor() const { return buf.data() + pos; }
+    uint64_t offset() const { return base + pos; }
+    uint64_t bytes_read() const { return read_bytes; }
+
+    void advance(uint64_t count) {
+        if (count <= end - pos) {
+            pos += static_cast<size_t>(count);
+            return;
+        }
+        base = offset() + count;
+        pos = end = 0;
+        at_eof = ::lseek(fd, static_cast<off_t>(base), SEEK_SET) < 0;
+    }
+
+private:
+    int fd;
+    std::vector<uint8_t>& buf;
+    size_t pos;
+    size_t end;
+    uint64_t base;      // file offset of buf[0]
+    uint64_t read_bytes;
+    size_t next_read;
+    bool at_eof;
+};
+
+// A header counts as a frame start if the next frame also starts where it says
+// (or the file ends right after it).
+bool confirmed_frame(BlockReader& reader, FrameHeader& h) {
+    if (!parse_header(reader.cursor(), h))
+        return false;
+    size_t available = reader.fill(h.frame_bytes + 4);
+    if (available < h.frame_bytes)
+        return false;
+    if (available < h.frame_bytes + 4)
+        return true;
+    FrameHeader next;
+    return parse_header(reader.cursor() + h.frame_bytes, next) && same_stream(h, next);
+}
+
+bool is_trailing_tag(const uint8_t* p, size_t available) {
+    return (available >= 3 && std::memcmp(p, "TAG", 3) == 0) ||
+           (available >= 8 && std::memcmp(p, "APETAGEX", 8) == 0) ||
+           (available >= 6 && std::memcmp(p, "LYRICS", 6) == 0);
+}
+
+} // namespace
+
+const size_t MP3FrameScanner::DEFAULT_BLOCK_SIZE;
+
+MP3StreamInfo::MP3StreamInfo()
+    : mpeg_version(0), layer(0), sample_rate(0), channels(0), bitrate_kbps(0), vbr(false), frames(0),
+      duration_seconds(0.0), source(Source::FrameScan), has_toc(false), audio_offset(0), audio_bytes(0),
+      id3v2_bytes(0) {}
+
+const char* MP3StreamInfo::source_name(Source source) {
+    switch (source) {
+    case Source::Xing: return "Xing header";
+    case Source::Info: return "Info header";
+    case Source::VBRI: return "VBRI header";
+    default: return "frame scan";
+    }
+}
+
+MP3FrameScanner::MP3FrameScanner(size_t block_size)
+    : buffer(block_size), stream(), last_error(), total_read(0) {}
+
+bool MP3FrameScanner::scan(const std::string& path) {
+    stream = MP3StreamInfo();
+    total_read = 0;
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        last_error = std::strerror(errno);
+        return false;
+    }
+    struct stat file_info;
+    uint64_t file_size = ::fstat(fd, &file_info) == 0 ? static_cast<uint64_t>(file_info.st_size) : 0;
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    BlockReader reader(fd, buffer);
+
+    // ID3v2: "ID3", version, flags, then a 28-bit syncsafe size (+10 with a footer)
+    if (reader.fill(10) >= 10 && std::memcmp(reader.cursor(), "ID3", 3) == 0) {
+        const uint8_t* tag = reader.cursor();
+        stream.id3v2_bytes = 10 + ((static_cast<uint64_t>(tag[6] & 0x7F) << 21) | ((tag[7] & 0x7F) << 14) |
+                                   ((tag[8] & 0x7F) << 7) | (tag[9] & 0x7F)) + ((tag[5] & 0x10) ? 10 : 0);
+        reader.advance(stream.id3v2_bytes);
+    }
+
+    FrameHeader first;
+    while (true) {
+        if (reader.fill(4) < 4) {
+            ::close(fd);
+            total_read = reader.bytes_read();
+            last_error = "no MPEG audio frames found";
+            return false;
+        }
+        if (confirmed_frame(reader, first))
+            break;
+        reader.advance(1);
+    }
+    stream.mpeg_version = first.version;
+    stream.layer = first.layer;
+    stream.sample_rate = first.sample_rate;
+    stream.channels = first.channels;
+    stream.audio_offset = reader.offset();
+
+    // Xing/Info sits after the side info of the first frame; VBRI at a fixed 32 bytes.
+    const uint8_t* frame = reader.cursor();
+    size_t side_info = first.version == 1 ? (first.channels == 1 ? 17 : 32) : (first.channels == 1 ? 9 : 17);
+    size_t xing = 4 + side_info;
+    uint64_t tag_frames = 0, tag_bytes = 0;
+    bool tagged = false;
+    if (first.layer == 3 && first.frame_bytes >= xing + 8 &&
+        (std::memcmp(frame + xing, "Xing", 4) == 0 || std::memcmp(frame + xing, "Info", 4) == 0)) {
+        tagged = true;
+        stream.source = frame[xing] == 'X' ? MP3StreamInfo::Source::Xing : MP3StreamInfo::Source::Info;
+        uint32_t flags = read_be32(frame + xing + 4);
+        size_t field = xing + 8;
+        if ((flags & 1) && field + 4 <= first.frame_bytes) {
+            tag_frames = read_be32(frame + field);
+            field += 4;
+        }
+        if ((flags & 2) && field + 4 <= first.frame_bytes)
+            tag_bytes = read_be32(frame + field);
+        stream.has_toc = (flags & 4) != 0;
+    } else if (first.layer == 3 && first.frame_bytes >= 36 + 18 && std::memcmp(frame + 36, "VBRI", 4) == 0) {
+        tagged = true;
+        stream.source = MP3StreamInfo::Source::VBRI;
+        tag_bytes = read_be32(frame + 36 + 10);
+        tag_frames = read_be32(frame + 36 + 14);
+    }
+
+    if (tag_frames > 0) {
+        // Exact frame count from the header: no need to read any further.
+        stream.frames = tag_frames;
+        stream.duration_seconds = static_cast<double>(tag_frames) * first.samples / first.sample_rate;
+        stream.audio_bytes = tag_bytes ? tag_bytes : file_size - stream.audio_offset;
+        stream.vbr = stream.source != MP3StreamInfo::Source::Info;
+        stream.bitrate_kbps = stream.vbr
+            ? static_cast<unsigned>(stream.audio_bytes * 8 / stream.duration_seconds / 1000.0 + 0.5)
+            : first.bitrate_kbps;
+        ::close(fd);
+        total_read = reader.bytes_read();
+        return true;
+    }
+    if (tagged) {
+        stream.source = MP3StreamInfo::Source::FrameScan;  // header without a count; the tag frame holds no audio
+        reader.advance(first.frame_bytes);
+    }
+
+    uint64_t samples = 0, bytes = 0;
+    bool in_sync = true;
+    while (true) {
+        size_t available = reader.fill(4);
+        if (available < 4)
+            break;
+        FrameHeader h;
+        bool valid = in_sync ? parse_header(reader.cursor(), h) && same_stream(first, h)
+                             : confirmed_frame(reader, h) && same_stream(first, h);
+        if (valid) {
+            if (reader.fill(h.frame_bytes) < h.frame_bytes)
+                break;  // truncated last frame
+            ++stream.frames;
+            samples += h.samples;
+            bytes += h.frame_bytes;
+            if (h.bitrate_kbps != first.bitrate_kbps)
+                stream.vbr = true;
+            reader.advance(h.frame_bytes);
+            in_sync = true;
+            continue;
+        }
+        // fill() may move the buffer, so take the cursor only after it.
+        size_t tail = reader.fill(8);
+        if (is_trailing_tag(reader.cursor(), tail))
+            break;
+        in_sync = false;
+        reader.advance(1);
+    }
+    ::close(fd);
+    total_read = reader.bytes_read();
+    if (stream.frames == 0) {
+        last_error = "no MPEG audio frames found";
+        return false;
+    }
+    stream.audio_bytes = bytes;
+    stream.duration_seconds = static_cast<double>(samples) / first.sample_rate;
+    stream.bitrate_kbps = stream.vbr
+        ? static_cast<unsigned>(bytes * 8 / stream.duration_seconds / 1000.0 + 0.5)
+        : first.bitrate_kbps;
+    return true;
+}
@@ -4,43 +4,108 @@
 #include <algorithm>
 
 MP3Track::MP3Track(const std::string& title, const std::vector<std::string>& artists, 
-                   int duration, int bpm, int bitrate, bool has_tags)
-    : AudioTrack(title, artists, duration, bpm), bitrate(bitrate), has_id3_tags(has_tags) {
+                   int duration, int bpm, int bitrate, bool has_tags, const std::string& file_path)
+    : AudioTrack(title, artists, duration, bpm), bitrate(bitrate), has_id3_tags(has_tags),
+      file_path(file_path), stream_info(), id3_tag() {
 
     std::cout << "MP3Track created: " << bitrate << " kbps" << std::endl;
 }
 
 void MP3Track::load() {
+    std::string scan_error;
+    bool scanned = scan_file(scan_error);
+    if (scanned)
+        read_tag();
     std::cout << "[MP3Track::load] Loading MP3: \"" << title
               << "\" at " << bitrate << " kbps...\n";
     if (has_id3_tags) {
         std::cout << "  → tags found." << std::endl;
-        std::cout << "  → Processing ID3 metadata (artist info, album art, etc.)..." << std::endl;
+        if (id3_tag && id3_tag->present()) {
+            std::cout << "  → ID3v2." << id3_tag->version() << " tag: " << id3_tag->frames().size()
+                      << " frames indexed (" << id3_tag->bytes_read() << " of " << id3_tag->tag_bytes()
+                      << " bytes read)" << std::endl;
+            std::string tag_title = id3_tag->title();
+            if (!tag_title.empty())
+                std::cout << "  → TIT2: " << tag_title << std::endl;
+            std::string tag_artist = id3_tag->text("TPE1");
+            if (!tag_artist.empty())
+                std::cout << "  → TPE1: " << tag_artist << std::endl;
+            ID3Picture art;
+            if (id3_tag->picture_info(art))
+                std::cout << "  → APIC: " << art.mime << ", " << art.image_bytes << " bytes (not loaded)" << std::endl;
+        } else {
+            std::cout << "  → Processing ID3 metadata (artist info, album art, etc.)..." << std::endl;
+        }
     } else std::cout << "  → No ID3" << std::endl;
-    std::cout << "  → Decoding MP3 frames..." << std::endl;
+    if (id3_tag && !id3_tag->error().empty())
+        std::cout << "  → [WARNING] ID3 tag of " << file_path << ": " << id3_tag->error() << std::endl;
+    if (scanned) {
+        const MP3StreamInfo& info = *stream_info;
+        std::cout << "  → Scanned " << file_path << ": MPEG-" << (info.mpeg_version == 25 ? "2.5" : std::to_string(info.mpeg_version))
+                  << " Layer " << info.layer << ", " << info.sample_rate << " Hz, " << info.channels << " ch, "
+                  << info.bitrate_kbps << " kbps " << (info.vbr ? "VBR" : "CBR") << ", " << info.frames
+                  << " frames, " << info.duration_seconds << "s (" << MP3StreamInfo::source_name(info.source)
+                  << (info.has_toc ? ", seek TOC" : "") << ")" << std::endl;
+    } else {
+        if (!scan_error.empty())
+            std::cout << "  → [WARNING] Cannot scan " << file_path << ": " << scan_error << std::endl;
+        std::cout << "  → Decoding MP3 frames..." << std::endl;
+    }
     std::cout << "  → Load complete." << std::endl;
 }
 
+bool MP3Track::scan_file(std::string& error) {
+    if (stream_info)
+        return true;
+    if (file_path.empty())
+        return false;
+    MP3FrameScanner scanner;
+    if (!scanner.scan(file_path)) {
+        error = scanner.error();
+        return false;
+    }
+    stream_info = std::make_shared<const MP3StreamInfo>(scanner.info());
+    bitrate = static_cast<int>(stream_info->bitrate_kbps);
+    set_duration(static_cast<int>(stream_info->duration_seconds + 0.5));
+    return true;
+}
+
+void MP3Track::read_tag() {
+    if (id3_tag || file_path.empty())
+        return;
+    std::shared_ptr<ID3v2Tag> tag = std::make_shared<ID3v2Tag>();
+    tag->read(file_path);
+    set_id3_tag(tag);
+}
+
+void MP3Track::set_id3_tag(const std::shared_ptr<const ID3v2Tag>& tag) {
+    id3_tag = tag;
+    // A file that was read either has a tag or not; an unreadable one leaves the configured flag.
+    if (tag && (tag->present() || tag->error().empty()))
+        has_id3_tags = tag->present();
+}
+
 void MP3Track::analyze_beatgrid() {
     std::cout << "[MP3Track::analyze_beatgrid] Analyzing beat grid for: \"" << title << "\"\n";
-    int beats = (duration_seconds / 60.0) * bpm;
+    const BeatGrid& grid = detect_beat_grid();
+    int beats = (duration_seconds / 60.0) * get_tempo();
     double precision_factor = bitrate / 320.0;
     std::cout << "  → Estimated beats: " << beats
               << "  → Compression precision factor: " << precision_factor
               << std::endl;
+    if (grid.reliable())
+        std::cout << "  → Detected tempo: " << grid.bpm << " BPM (confidence " << grid.confidence
+                  << ", first beat at " << grid.first_beat << "s)" << std::endl;
 }
 
 double MP3Track::get_quality_score() const {
-    double score = (bitrate / 320.0) * 100.0;
-    if (has_id3_tags)
-        score += 5.0;
-    if (bitrate < 128)
-        score -= 10.0;
-    if (score < 0.0) score = 0.0;
-    else if (score > 100.0) score = 100.0;
-    return score;
+    return quality_score(bitrate, has_id3_tags);
 }
 
 PointerWrapper<AudioTrack> MP3Track::clone() const {
     return PointerWrapper<AudioTrack>(new MP3Track(*this));
+}
+
+size_t MP3Track::memory_footprint() const {
+    return sizeof(MP3Track) + heap_footprint();
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "MappedFile.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile()
+    : bytes(nullptr), length(0), mapped(false), file_path(), last_error() {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    file_path = path;
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        last_error = std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        last_error = std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            last_error = std::strerror(errno);
+            length = 0;
+            ::close(fd);
+            return false;
+        }
+        bytes = static_cast<const uint8_t*>(view);
+    }
+    // The mapping keeps the file alive; the descriptor is no longer needed.
+    ::close(fd);
+    mapped = true;
+    last_error.clear();
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes)
+        ::munmap(const_cast<uint8_t*>(bytes), length);
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+}
+
+void MappedFile::advise_sequential(size_t offset, size_t count) const {
+    if (!bytes || offset >= length)
+        return;
+    // madvise wants a page-aligned start.
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t start = offset / page * page;
+    size_t end = count > length - offset ? length : offset + count;
+    ::madvise(const_cast<uint8_t*>(bytes) + start, end - start, MADV_SEQUENTIAL);
+}
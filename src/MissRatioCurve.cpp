@@ -0,0 +1,159 @@
+#include "MissRatioCurve.h"
+#include "EvictionPolicy.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+// Titles are sampled when the low 24 bits of their hash fall below R * 2^24.
+const uint64_t SAMPLE_MODULUS = 1ULL << 24;
+
+// Fenwick tree over 1-based access times: prefix sums of "latest access" marks.
+class FenwickTree {
+private:
+    std::vector<int32_t> tree;
+
+public:
+    explicit FenwickTree(size_t n) : tree(n + 1, 0) {}
+
+    void add(size_t pos, int32_t delta) {
+        for (; pos < tree.size(); pos += pos & (~pos + 1))
+            tree[pos] += delta;
+    }
+
+    int64_t prefix(size_t pos) const {
+        int64_t sum = 0;
+        for (; pos > 0; pos -= pos & (~pos + 1))
+            sum += tree[pos];
+        return sum;
+    }
+};
+}
+
+MissRatioCurve::MissRatioCurve(double rate)
+    : sample_rate(rate > 0.0 && rate < 1.0 ? rate : 1.0),
+      total_accesses(0), sampled(), distinct_sampled(0), histogram(),
+      sampled_weight(0.0) {}
+
+double MissRatioCurve::auto_sample_rate(size_t accesses, size_t max_tracked) {
+    if (accesses <= max_tracked || accesses == 0)
+        return 1.0;
+    return std::max(0.001, static_cast<double>(max_tracked) / accesses);
+}
+
+void MissRatioCurve::build(const std::vector<std::string>& trace) {
+    total_accesses = trace.size();
+    sampled.clear();
+    sampled.reserve(sample_rate < 1.0 ? static_cast<size_t>(trace.size() * sample_rate * 1.1) : trace.size());
+    uint64_t threshold = static_cast<uint64_t>(sample_rate * SAMPLE_MODULUS);
+    std::unordered_map<std::string, uint32_t> ids;
+    for (const std::string& title : trace) {
+        if (sample_rate < 1.0 && (hash_cache_key(title) & (SAMPLE_MODULUS - 1)) >= threshold)
+            continue;
+        auto it = ids.insert(std::make_pair(title, static_cast<uint32_t>(ids.size()))).first;
+        sampled.push_back(it->second);
+    }
+    distinct_sampled = ids.size();
+
+    // Mattson: the stack distance of a reuse is the number of distinct titles
+    // touched since the previous access, plus one.
+    histogram.assign(distinct_sampled + 1, 0.0);
+    FenwickTree marks(sampled.size());
+    std::vector<size_t> last(distinct_sampled, 0);
+    for (size_t t = 1; t <= sampled.size(); ++t) {
+        uint32_t id = sampled[t - 1];
+        size_t prev = last[id];
+        if (prev != 0) {
+            int64_t distance = marks.prefix(t - 1) - marks.prefix(prev) + 1;
+            histogram[static_cast<size_t>(distance)] += 1.0;
+            marks.add(prev, -1);
+        }
+        marks.add(t, 1);
+        last[id] = t;
+    }
+
+    sampled_weight = static_cast<double>(sampled.size());
+    if (sample_rate < 1.0 && histogram.size() > 1) {
+        // SHARDS-adj: credit the sampling error to the smallest distance.
+        sampled_weight = total_accesses * sample_rate;
+        histogram[1] += sampled_weight - static_cast<double>(sampled.size());
+    }
+}
+
+double MissRatioCurve::lruMissRatio(size_t cache_size) const {
+    if (sampled_weight <= 0.0)
+        return 0.0;
+    // A sampled distance d stands for full distances ((d - 1) / R, d / R]:
+    // buckets up to size * R hit in full, the next one in proportion.
+    double scaled = cache_size * sample_rate + 1e-9;
+    size_t limit = static_cast<size_t>(std::floor(scaled));
+    size_t last = histogram.empty() ? 0 : histogram.size() - 1;
+    double hits = 0.0;
+    for (size_t d = 1; d <= std::min(limit, last); ++d)
+        hits += histogram[d];
+    if (limit < last)
+        hits += (scaled - limit) * histogram[limit + 1];
+    double ratio = 1.0 - hits / sampled_weight;
+    return std::min(1.0, std::max(0.0, ratio));
+}
+
+double MissRatioCurve::optMissRatio(size_t cache_size) const {
+    if (sampled.empty())
+        return 0.0;
+    if (sample_rate >= 1.0)
+        return optSampledMissRatio(cache_size);
+    double scaled = cache_size * sample_rate;
+    size_t below = static_cast<size_t>(std::floor(scaled + 1e-9));
+    double fraction = scaled - below;
+    double ratio = optSampledMissRatio(below);
+    if (fraction > 1e-9)
+        ratio += fraction * (optSampledMissRatio(below + 1) - ratio);
+    return ratio;
+}
+
+double MissRatioCurve::optSampledMissRatio(size_t slots) const {
+    if (slots == 0)
+        return 1.0;
+
+    const size_t never = sampled.size();
+    std::vector<size_t> next_use(sampled.size());
+    std::vector<size_t> seen(distinct_sampled, never);
+    for (size_t i = sampled.size(); i > 0; --i) {
+        next_use[i - 1] = seen[sampled[i - 1]];
+        seen[sampled[i - 1]] = i - 1;
+    }
+
+    // Resident titles ordered by next use; the last one is Belady's victim.
+    std::set<std::pair<size_t, uint32_t>> resident;
+    std::vector<size_t> resident_next(distinct_sampled, never);
+    std::vector<bool> cached(distinct_sampled, false);
+    size_t misses = 0;
+    for (size_t i = 0; i < sampled.size(); ++i) {
+        uint32_t id = sampled[i];
+        if (cached[id]) {
+            resident.erase(std::make_pair(resident_next[id], id));
+        } else {
+            ++misses;
+            if (resident.size() >= slots) {
+                auto furthest = std::prev(resident.end());
+                if (furthest->first <= next_use[i])
+                    continue;  // bypass: the newcomer is reused last
+                cached[furthest->second] = false;
+                resident.erase(furthest);
+            }
+            cached[id] = true;
+        }
+        resident_next[id] = next_use[i];
+        resident.insert(std::make_pair(next_use[i], id));
+    }
+    return static_cast<double>(misses) / sampled.size();
+}
+
+size_t MissRatioCurve::distinctTitles() const {
+    if (sample_rate < 1.0)
+        return static_cast<size_t>(std::llround(distinct_sampled / sample_rate));
+    return distinct_sampled;
+}
@@ -72,14 +72,15 @@ void MixingEngineService::displayDeckStatus() const {
 
 /**
  * @param track: Track to check for mixing compatibility
- * @return: true if BPM difference <= tolerance, false otherwise
+ * @return: true if tempo difference <= tolerance, false otherwise
+ * Uses the detected tempo where beat detection was reliable, else the tagged BPM.
  */
 bool MixingEngineService::can_mix_tracks(const PointerWrapper<AudioTrack>& track) const {
     if (!decks[active_deck] || !track)
         return false;
-    int current_bpm = decks[active_deck]->get_bpm();
-    int new_bpm = track->get_bpm();    
-    return std::abs(current_bpm - new_bpm) <= bpm_tolerance;
+    double current_tempo = decks[active_deck]->get_tempo();
+    double new_tempo = track->get_tempo();
+    return std::fabs(current_tempo - new_tempo) <= bpm_tolerance;
 }
 
 /**
@@ -87,9 +88,8 @@ bool MixingEngineService::can_mix_tracks(const PointerWrapper<AudioTrack>& track
  */
 void MixingEngineService::sync_bpm(const PointerWrapper<AudioTrack>& track) const {
     if (!decks[active_deck] || !track) return;
-    int current_bpm = decks[active_deck]->get_bpm();
-    int new_bpm = track->get_bpm();
-    int avg_bpm = (current_bpm + new_bpm) / 2;
-    std::cout << "[Sync BPM] Syncing BPM from " << new_bpm << " to " << avg_bpm << std::endl;
-    track->set_bpm(avg_bpm);
+    double current_tempo = decks[active_deck]->get_tempo();
+    double new_tempo = track->get_tempo();
+    track->set_tempo((current_tempo + new_tempo) / 2);
+    std::cout << "[Sync BPM] Syncing BPM from " << new_tempo << " to " << track->get_tempo() << std::endl;
 }
\ No newline at end of file
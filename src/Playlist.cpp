@@ -1,23 +1,46 @@
 #include "Playlist.h"
 #include "AudioTrack.h"
-#include <iostream>
+#include "TrackTable.h"
 #include <algorithm>
+#include <cmath>
+#include <iostream>
 
-Playlist::Playlist(const std::string& name) 
-    : head(nullptr), playlist_name(name), track_count(0) {
-    std::cout << "Created playlist: " << name << std::endl;
+const uint32_t Playlist::NO_SLOT;
+const int64_t Playlist::QUALITY_SCALE;
+const uint8_t Playlist::FORMAT_OTHER;
+
+PlaylistView PlaylistView::slice(size_t position, size_t count) const {
+    size_t start = std::min(position, size());
+    return PlaylistView(first + start, first + start + std::min(count, size() - start));
 }
 
-Playlist::Playlist(const Playlist& other) 
-    : head(nullptr), playlist_name(other.playlist_name), track_count(0) {
-        copy_nodes_from(other);
+Playlist::Contents::Contents()
+    : tracks(), slot_of(), holes(0), slots(), free_slots(), by_id(), total_duration(0), bpm_sum(0), quality_sum(0),
+      format_counts(), bpm_counts() {}
+
+const std::shared_ptr<Playlist::Contents>& Playlist::empty_contents() {
+    static const std::shared_ptr<Contents> empty = std::make_shared<Contents>();
+    return empty;
+}
+
+Playlist::Contents& Playlist::mutable_contents() {
+    if (contents.use_count() > 1)
+        contents = std::make_shared<Contents>(*contents);
+    return *contents;
 }
 
+Playlist::Playlist(const std::string& name)
+    : contents(empty_contents()), playlist_name(name) {
+    std::cout << "Created playlist: " << name << std::endl;
+}
+
+Playlist::Playlist(const Playlist& other)
+    : contents(other.contents), playlist_name(other.playlist_name) {}
+
 Playlist& Playlist::operator=(const Playlist& other) {
     if (this != &other) {
-        clear_nodes();
+        contents = other.contents;
         playlist_name = other.playlist_name;
-        copy_nodes_from(other);
     }
     return *this;
 }
@@ -26,143 +49,294 @@ Playlist::~Playlist() {
     #ifdef DEBUG
     std::cout << "Destroying playlist: " << playlist_name << std::endl;
     #endif
-    clear_nodes();
 }
 
-Playlist::Playlist(Playlist&& other) noexcept 
-    : head(other.head),
-      playlist_name(std::move(other.playlist_name)),
-      track_count(other.track_count)
-{
-    move_nodes_from(std::move(other));
+Playlist::Playlist(Playlist&& other) noexcept
+    : contents(std::move(other.contents)),
+      playlist_name(std::move(other.playlist_name)) {
+    other.contents = empty_contents();
 }
 
 Playlist& Playlist::operator=(Playlist&& other) noexcept {
     if (this != &other) {
-        clear_nodes();
+        contents = std::move(other.contents);
         playlist_name = std::move(other.playlist_name);
-        move_nodes_from(std::move(other));
+        other.contents = empty_contents();
     }
     return *this;
 }
 
-void Playlist::add_track(AudioTrack* track) {
+PlaylistHandle Playlist::add_track(AudioTrack* track) {
     if (!track) {
         std::cout << "[Error] Cannot add null track to playlist" << std::endl;
-        return;
+        return PlaylistHandle();
     }
-    PlaylistNode* new_node = new PlaylistNode(track);
-    new_node->next = head;
-    head = new_node;
-    track_count++;
-    std::cout << "Added '" << track->get_title() << "' to playlist '" 
+    Contents& c = mutable_contents();
+    uint32_t slot;
+    if (!c.free_slots.empty()) {
+        slot = c.free_slots.back();
+        c.free_slots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(c.slots.size());
+        Slot fresh = {NO_SLOT, 0, NO_SLOT, NO_SLOT, 0, 0, FORMAT_OTHER, 0};
+        c.slots.push_back(fresh);
+    }
+    c.slots[slot].position = static_cast<uint32_t>(c.tracks.size());
+    c.tracks.push_back(track);
+    c.slot_of.push_back(slot);
+    c.link_id(track->intern_id(), slot);
+    c.count_in(slot);
+    std::cout << "Added '" << track->get_title() << "' to playlist '"
               << playlist_name << "'" << std::endl;
+    return PlaylistHandle(slot, c.slots[slot].generation);
 }
 
-void Playlist::remove_track(const std::string& title) {
-    PlaylistNode* current = head;
-    PlaylistNode* prev = nullptr;
-    while (current && current->track->get_title() != title) {
-        prev = current;
-        current = current->next;
+void Playlist::Contents::erase_at(size_t position) {
+    uint32_t slot = slot_of[position];
+    unlink_id(tracks[position]->get_id(), slot);
+    count_out(slot);
+    slots[slot].position = NO_SLOT;
+    slots[slot].generation++;
+    free_slots.push_back(slot);
+    tracks[position] = nullptr;
+    slot_of[position] = NO_SLOT;
+    ++holes;
+    // Tombstones at the end cost nothing to drop; elsewhere they wait for
+    // compact(), which is due once they outnumber the live entries.
+    while (!tracks.empty() && !tracks.back()) {
+        tracks.pop_back();
+        slot_of.pop_back();
+        --holes;
+    }
+    if (holes > tracks.size() - holes)
+        compact();
+}
+
+void Playlist::Contents::compact() {
+    size_t kept = 0;
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        if (!tracks[i])
+            continue;
+        tracks[kept] = tracks[i];
+        slot_of[kept] = slot_of[i];
+        slots[slot_of[kept]].position = static_cast<uint32_t>(kept);
+        ++kept;
     }
-    if (current) {
-        if (prev)
-            prev->next = current->next;
-        else head = current->next;
-        delete current;
-        track_count--;
+    tracks.resize(kept);
+    slot_of.resize(kept);
+    holes = 0;
+}
+
+void Playlist::remove_track(const std::string& title) {
+    uint32_t slot = contents->first_slot(TrackRegistry::instance().find(title));
+    if (slot != NO_SLOT) {
+        Contents& c = mutable_contents();
+        c.erase_at(c.slots[slot].position);
         std::cout << "Removed '" << title << "' from playlist" << std::endl;
-    } else std::cout << "Track '" << title << "' not found in playlist" << std::endl;
+        return;
+    }
+    std::cout << "Track '" << title << "' not found in playlist" << std::endl;
+}
+
+bool Playlist::remove_track(PlaylistHandle handle) {
+    uint32_t slot = live_slot(handle);
+    if (slot == NO_SLOT)
+        return false;
+    Contents& c = mutable_contents();
+    c.erase_at(c.slots[slot].position);
+    return true;
+}
+
+bool Playlist::reorder(const std::vector<size_t>& order) {
+    size_t count = size();
+    if (order.size() != count)
+        return false;
+    std::vector<char> seen(count, 0);
+    for (size_t position : order) {
+        if (position >= count || seen[position])
+            return false;
+        seen[position] = 1;
+    }
+    Contents& c = mutable_contents();
+    if (c.holes)
+        c.compact();
+    std::vector<AudioTrack*> tracks(count);
+    std::vector<uint32_t> slot_of(count);
+    for (size_t k = 0; k < count; ++k) {
+        tracks[k] = c.tracks[order[k]];
+        slot_of[k] = c.slot_of[order[k]];
+        c.slots[slot_of[k]].position = static_cast<uint32_t>(k);
+    }
+    c.tracks.swap(tracks);
+    c.slot_of.swap(slot_of);
+    IdChain empty = {NO_SLOT, NO_SLOT};
+    for (AudioTrack* track : c.tracks)
+        c.by_id[track->get_id()] = empty;
+    for (size_t k = 0; k < count; ++k)
+        c.link_id(c.tracks[k]->get_id(), c.slot_of[k]);
+    return true;
 }
 
 void Playlist::display() const {
     std::cout << "\n=== Playlist: " << playlist_name << " ===" << std::endl;
-    std::cout << "Track count: " << track_count << std::endl;
-    PlaylistNode* current = head;
+    std::cout << "Track count: " << size() << std::endl;
     int index = 1;
-    while (current) {
-        std::vector<std::string> artists = current->track->get_artists();
-        std::string artist_list;
-        std::for_each(artists.begin(), artists.end(), [&](const std::string& artist) {
-            if (!artist_list.empty())
-                artist_list += ", ";
-            artist_list += artist;
-        });
-        AudioTrack* track = current->track;
-        std::cout << index << ". " << track->get_title() 
-                  << " by " << artist_list
-                  << " (" << track->get_duration() << "s, " 
+    for (AudioTrack* track : *this) {
+        std::cout << index << ". " << track->get_title() << " by ";
+        const std::vector<std::string>& artists = track->get_artists();
+        for (size_t i = 0; i < artists.size(); ++i)
+            std::cout << (i ? ", " : "") << artists[i];
+        std::cout << " (" << track->get_duration() << "s, "
                   << track->get_bpm() << " BPM)" << std::endl;
-        current = current->next;
         index++;
     }
-    if (track_count == 0)
+    if (is_empty())
         std::cout << "(Empty playlist)" << std::endl;
     std::cout << "========================\n" << std::endl;
 }
 
 AudioTrack* Playlist::find_track(const std::string& title) const {
-    PlaylistNode* current = head;
-    while (current) {
-        if (current->track->get_title() == title)
-            return current->track;
-        current = current->next;
-    }
-    return nullptr;
+    return find_track(TrackRegistry::instance().find(title));
 }
 
-int Playlist::get_total_duration() const {
-    int total = 0;
-    PlaylistNode* current = head;
-    while (current) {
-        total += current->track->get_duration();
-        current = current->next;
-    }
-    return total;
+AudioTrack* Playlist::find_track(TrackId id) const {
+    uint32_t slot = contents->first_slot(id);
+    return slot == NO_SLOT ? nullptr : contents->tracks[contents->slots[slot].position];
 }
 
-std::vector<AudioTrack*> Playlist::getTracks() const {
-    std::vector<AudioTrack*> tracks;
-    PlaylistNode* current = head;
-    while (current) {
-        if (current->track)
-            tracks.push_back(current->track);
-        current = current->next;
-    }
-    return tracks;
+PlaylistHandle Playlist::find_handle(TrackId id) const {
+    uint32_t slot = contents->first_slot(id);
+    return slot == NO_SLOT ? PlaylistHandle() : PlaylistHandle(slot, contents->slots[slot].generation);
+}
+
+uint32_t Playlist::Contents::first_slot(TrackId id) const {
+    return id < by_id.size() ? by_id[id].first : NO_SLOT;
 }
 
-void Playlist::clear_nodes() {
-    PlaylistNode* current = head;
-    PlaylistNode* next;
-    while (current) {
-        next = current->next;
-        delete current;
-        current = next;
+void Playlist::Contents::link_id(TrackId id, uint32_t slot) {
+    if (id == INVALID_TRACK_ID)   // not indexed rather than a 4G-entry index
+        return;
+    if (id >= by_id.size()) {
+        IdChain empty = {NO_SLOT, NO_SLOT};
+        by_id.resize(static_cast<size_t>(id) + 1, empty);
     }
-    head = nullptr;
-    track_count = 0;
-}
-
-void Playlist::copy_nodes_from(const Playlist& other) {
-    PlaylistNode* current = other.head;
-    PlaylistNode* last_added = nullptr;
-    PlaylistNode* new_node;
-    while (current) {
-        new_node = new PlaylistNode(current->track);
-        if (!head) 
-            head = new_node;
-        else last_added->next = new_node;
-        last_added = new_node;
-        current = current->next;
-        track_count++;
+    IdChain& chain = by_id[id];
+    slots[slot].next_same = NO_SLOT;
+    slots[slot].prev_same = chain.last;
+    if (chain.first == NO_SLOT)
+        chain.first = slot;
+    else
+        slots[chain.last].next_same = slot;
+    chain.last = slot;
+}
+
+void Playlist::Contents::unlink_id(TrackId id, uint32_t slot) {
+    if (id == INVALID_TRACK_ID)
+        return;
+    IdChain& chain = by_id[id];
+    uint32_t previous = slots[slot].prev_same;
+    uint32_t next = slots[slot].next_same;
+    if (previous == NO_SLOT)
+        chain.first = next;
+    else
+        slots[previous].next_same = next;
+    if (next == NO_SLOT)
+        chain.last = previous;
+    else
+        slots[next].prev_same = previous;
+    slots[slot].next_same = NO_SLOT;
+    slots[slot].prev_same = NO_SLOT;
+}
+
+void Playlist::Contents::count_in(uint32_t slot) {
+    Slot& entry = slots[slot];
+    const AudioTrack& track = *tracks[entry.position];
+    entry.duration = track.get_duration();
+    entry.bpm = track.get_bpm();
+    entry.quality = static_cast<int64_t>(std::llround(track.get_quality_score() * QUALITY_SCALE));
+    if (dynamic_cast<const MP3Track*>(&track))
+        entry.format = static_cast<uint8_t>(TrackFormat::MP3);
+    else if (dynamic_cast<const WAVTrack*>(&track))
+        entry.format = static_cast<uint8_t>(TrackFormat::WAV);
+    else
+        entry.format = FORMAT_OTHER;
+    total_duration += entry.duration;
+    bpm_sum += entry.bpm;
+    quality_sum += entry.quality;
+    format_counts[entry.format]++;
+    bpm_counts[entry.bpm]++;
+}
+
+void Playlist::Contents::count_out(uint32_t slot) {
+    const Slot& entry = slots[slot];
+    total_duration -= entry.duration;
+    bpm_sum -= entry.bpm;
+    quality_sum -= entry.quality;
+    format_counts[entry.format]--;
+    std::map<int, size_t>::iterator bin = bpm_counts.find(entry.bpm);
+    if (--bin->second == 0)
+        bpm_counts.erase(bin);
+}
+
+void Playlist::Contents::refresh(const AudioTrack* track) {
+    for (uint32_t slot = first_slot(track->get_id()); slot != NO_SLOT; slot = slots[slot].next_same) {
+        if (tracks[slots[slot].position] == track) {
+            count_out(slot);
+            count_in(slot);
+        }
     }
 }
 
-void Playlist::move_nodes_from(Playlist&& other) {
-    head = other.head;
-    track_count = other.track_count;   
-    other.head = nullptr;
-    other.track_count = 0;
-}
\ No newline at end of file
+double Playlist::mean_bpm() const {
+    return is_empty() ? 0.0 : static_cast<double>(contents->bpm_sum) / size();
+}
+
+double Playlist::mean_quality() const {
+    return is_empty() ? 0.0 : static_cast<double>(contents->quality_sum) / QUALITY_SCALE / size();
+}
+
+size_t Playlist::format_count(TrackFormat format) const {
+    return contents->format_counts[static_cast<size_t>(format)];
+}
+
+bool Playlist::set_track_bpm(PlaylistHandle handle, int new_bpm) {
+    AudioTrack* track = get(handle);
+    if (!track)
+        return false;
+    track->set_bpm(new_bpm);
+    mutable_contents().refresh(track);
+    return true;
+}
+
+void Playlist::refresh_track(const AudioTrack* track) {
+    if (track && contents->first_slot(track->get_id()) != NO_SLOT)
+        mutable_contents().refresh(track);
+}
+
+uint32_t Playlist::live_slot(PlaylistHandle handle) const {
+    if (handle.slot >= contents->slots.size())
+        return NO_SLOT;
+    const Slot& slot = contents->slots[handle.slot];
+    if (slot.generation != handle.generation || slot.position == NO_SLOT)
+        return NO_SLOT;
+    return handle.slot;
+}
+
+AudioTrack* Playlist::get(PlaylistHandle handle) const {
+    uint32_t slot = live_slot(handle);
+    return slot == NO_SLOT ? nullptr : contents->tracks[contents->slots[slot].position];
+}
+
+long Playlist::position_of(PlaylistHandle handle) const {
+    uint32_t slot = live_slot(handle);
+    if (slot == NO_SLOT)
+        return -1;
+    compact();
+    return static_cast<long>(contents->slots[slot].position);
+}
+
+PlaylistHandle Playlist::handle_at(size_t position) const {
+    compact();
+    uint32_t slot = contents->slot_of[position];
+    return PlaylistHandle(slot, contents->slots[slot].generation);
+}
@@ -0,0 +1,315 @@
+#include "PlaylistOptimizer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <set>
+#include <thread>
+#include <utility>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const size_t NONE = static_cast<size_t>(-1);
+const double EPSILON = 1e-9;   // smallest cost change counted as an improvement
+
+double cost_of(const PlaylistOrderOptions& options, double from_bpm, double to_bpm) {
+    double change = to_bpm - from_bpm;
+    double cost = change >= 0.0 ? change : -change * options.slowdown_weight;
+    if (std::fabs(change) > options.bpm_tolerance)
+        cost += options.unmixable_penalty;
+    return cost;
+}
+
+/**
+ * First-improvement local search over order[begin, end). The positions
+ * just outside (begin - 1 and end) are read but never moved, and neither
+ * are pinned positions, so regions with disjoint ranges can be searched
+ * concurrently.
+ */
+class RegionSearch {
+public:
+    RegionSearch(const PlaylistOrderOptions& options, const std::vector<double>& tempos,
+                 std::vector<size_t>& order, const std::vector<char>& pinned, long begin, long end,
+                 Clock::time_point deadline)
+        : options(options), tempos(tempos), order(order), pinned(pinned), begin(begin), end(end),
+          size(static_cast<long>(order.size())), deadline(deadline), free_positions(), runs() {
+        for (long p = begin; p < end; ++p) {
+            if (pinned[p])
+                continue;
+            if (free_positions.empty() || free_positions.back() != p - 1)
+                runs.push_back(std::make_pair(p, p + 1));
+            else
+                runs.back().second = p + 1;
+            free_positions.push_back(p);
+        }
+    }
+
+    /**
+     * @return true if the order was improved
+     */
+    bool run() {
+        bool any = false;
+        bool improved = true;
+        while (improved && !expired()) {
+            improved = false;
+            for (const std::pair<long, long>& run : runs) {
+                improved = two_opt(run.first, run.second) || improved;
+                improved = or_opt(run.first, run.second) || improved;
+            }
+            improved = exchange() || improved;
+            any = any || improved;
+        }
+        return any;
+    }
+
+private:
+    const PlaylistOrderOptions& options;
+    const std::vector<double>& tempos;
+    std::vector<size_t>& order;
+    const std::vector<char>& pinned;
+    long begin;
+    long end;
+    long size;
+    Clock::time_point deadline;
+    std::vector<long> free_positions;
+    std::vector<std::pair<long, long>> runs;   // maximal [first, last) runs of free positions
+
+    bool expired() const { return Clock::now() >= deadline; }
+
+    size_t node(long position) const {
+        return position < 0 || position >= size ? NONE : order[static_cast<size_t>(position)];
+    }
+
+    double cost(size_t from, size_t to) const {
+        return from == NONE || to == NONE ? 0.0 : cost_of(options, tempos[from], tempos[to]);
+    }
+
+    double edge(long position) const { return cost(node(position), node(position + 1)); }
+
+    // Reverse order[i..j] for the first j in the run that lowers the cost.
+    bool reverse_from(long i, long run_end) {
+        size_t previous = node(i - 1);
+        size_t first = order[i];
+        double forward = 0.0, backward = 0.0;   // inner edges of [i..j], as is and reversed
+        for (long j = i + 1; j < run_end; ++j) {
+            size_t last = order[j];
+            forward += cost(order[j - 1], last);
+            backward += cost(last, order[j - 1]);
+            size_t next = node(j + 1);
+            double delta = cost(previous, last) + cost(first, next) - cost(previous, first) - cost(last, next) +
+                           backward - forward;
+            if (delta < -EPSILON) {
+                std::reverse(order.begin() + i, order.begin() + j + 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool two_opt(long run_begin, long run_end) {
+        bool improved = false;
+        for (long i = run_begin; i + 1 < run_end && !expired();) {
+            if (reverse_from(i, run_end))
+                improved = true;
+            else
+                ++i;
+        }
+        return improved;
+    }
+
+    // Move order[i, i + length) to the first gap in the run that lowers the cost.
+    bool relocate(long i, long length, long run_begin, long run_end) {
+        size_t first = order[i];
+        size_t last = order[i + length - 1];
+        size_t previous = node(i - 1), next = node(i + length);
+        double removal = cost(previous, first) + cost(last, next) - cost(previous, next);
+        for (long gap = run_begin; gap <= run_end; ++gap) {   // gap g lies between g - 1 and g
+            if (gap >= i && gap <= i + length)
+                continue;
+            size_t before = node(gap - 1), after = node(gap);
+            double delta = cost(before, first) + cost(last, after) - cost(before, after) - removal;
+            if (delta < -EPSILON) {
+                if (gap < i)
+                    std::rotate(order.begin() + gap, order.begin() + i, order.begin() + i + length);
+                else
+                    std::rotate(order.begin() + i, order.begin() + i + length, order.begin() + gap);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool or_opt(long run_begin, long run_end) {
+        bool improved = false;
+        for (long length = 1; length <= 3; ++length) {
+            for (long i = run_begin; i + length <= run_end && !expired(); ++i)
+                improved = relocate(i, length, run_begin, run_end) || improved;
+        }
+        return improved;
+    }
+
+    // Exchange two free tracks, possibly in different runs of the region.
+    bool exchange() {
+        bool improved = false;
+        for (size_t a = 0; a < free_positions.size() && !expired(); ++a) {
+            for (size_t b = a + 1; b < free_positions.size(); ++b) {
+                long i = free_positions[a], j = free_positions[b];
+                long edges[4] = {i - 1, i, j - 1, j};   // edge p joins p and p + 1
+                size_t count = j == i + 1 ? 3 : 4;
+                if (j == i + 1)
+                    edges[2] = j;
+                double before = 0.0, after = 0.0;
+                for (size_t e = 0; e < count; ++e)
+                    before += edge(edges[e]);
+                std::swap(order[i], order[j]);
+                for (size_t e = 0; e < count; ++e)
+                    after += edge(edges[e]);
+                if (after - before < -EPSILON)
+                    improved = true;
+                else
+                    std::swap(order[i], order[j]);
+            }
+        }
+        return improved;
+    }
+};
+
+} // namespace
+
+PlaylistOrderOptions::PlaylistOrderOptions()
+    : bpm_tolerance(10.0), unmixable_penalty(1000.0), slowdown_weight(1.5), pinned(), time_budget_seconds(1.0),
+      threads(0), window(256) {}
+
+PlaylistOrder::PlaylistOrder()
+    : order(), initial_cost(0.0), cost(0.0), initial_mixable(0), mixable(0), rounds(0), budget_exhausted(false),
+      seconds(0.0) {}
+
+PlaylistOptimizer::PlaylistOptimizer(const PlaylistOrderOptions& options) : settings(options) {}
+
+double PlaylistOptimizer::transition_cost(double from_bpm, double to_bpm) const {
+    return cost_of(settings, from_bpm, to_bpm);
+}
+
+bool PlaylistOptimizer::mixable(double from_bpm, double to_bpm) const {
+    return std::fabs(to_bpm - from_bpm) <= settings.bpm_tolerance;
+}
+
+PlaylistOrder PlaylistOptimizer::optimize(const Playlist& playlist) const {
+    std::vector<double> tempos;
+    tempos.reserve(playlist.size());
+    for (AudioTrack* track : playlist)
+        tempos.push_back(track->get_tempo());
+    return optimize(tempos);
+}
+
+PlaylistOrder PlaylistOptimizer::optimize(const std::vector<double>& tempos) const {
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline =
+        start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(settings.time_budget_seconds));
+    size_t n = tempos.size();
+    auto measure = [&](const std::vector<size_t>& order, double& cost, size_t& mixable_pairs) {
+        cost = 0.0;
+        mixable_pairs = 0;
+        for (size_t k = 1; k < order.size(); ++k) {
+            cost += transition_cost(tempos[order[k - 1]], tempos[order[k]]);
+            mixable_pairs += mixable(tempos[order[k - 1]], tempos[order[k]]) ? 1 : 0;
+        }
+    };
+
+    PlaylistOrder result;
+    result.order.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        result.order[i] = i;
+    measure(result.order, result.initial_cost, result.initial_mixable);
+    result.cost = result.initial_cost;
+    result.mixable = result.initial_mixable;
+    if (n < 3)
+        return result;
+
+    std::vector<char> pinned(n, 0);
+    for (size_t position : settings.pinned)
+        if (position < n)
+            pinned[position] = 1;
+
+    // Nearest neighbour from the slowest free track; pinned positions keep their track.
+    std::vector<size_t> order(n);
+    std::set<std::pair<double, size_t>> pool;
+    for (size_t i = 0; i < n; ++i)
+        if (!pinned[i])
+            pool.insert(std::make_pair(tempos[i], i));
+    size_t previous = NONE;
+    for (size_t k = 0; k < n; ++k) {
+        if (pinned[k]) {
+            order[k] = k;
+        } else {
+            std::set<std::pair<double, size_t>>::iterator pick = pool.begin();
+            if (previous != NONE) {
+                // The cost grows with distance on each side, so the best is adjacent in tempo.
+                std::set<std::pair<double, size_t>>::iterator above = pool.lower_bound(std::make_pair(tempos[previous], 0));
+                pick = above;
+                if (above != pool.begin()) {
+                    std::set<std::pair<double, size_t>>::iterator below = std::prev(above);
+                    if (above == pool.end() || transition_cost(tempos[previous], below->first) <
+                                                   transition_cost(tempos[previous], above->first))
+                        pick = below;
+                }
+            }
+            order[k] = pick->second;
+            pool.erase(pick);
+        }
+        previous = order[k];
+    }
+
+    // Parallel rounds over windows; borders shift by half a window every other round.
+    size_t window = std::max<size_t>(settings.window, 8);
+    unsigned threads = settings.threads ? settings.threads : std::max(1u, std::thread::hardware_concurrency());
+    size_t quiet_rounds = 0;
+    while (quiet_rounds < 2) {
+        if (Clock::now() >= deadline) {
+            result.budget_exhausted = true;
+            break;
+        }
+        size_t offset = result.rounds % 2 == 0 ? window : window / 2;
+        std::vector<std::pair<long, long>> regions;
+        long region_begin = 0;
+        for (size_t border = offset; border < n; border += window) {
+            if (static_cast<long>(border) > region_begin)
+                regions.push_back(std::make_pair(region_begin, static_cast<long>(border)));
+            region_begin = static_cast<long>(border) + 1;
+        }
+        if (region_begin < static_cast<long>(n))
+            regions.push_back(std::make_pair(region_begin, static_cast<long>(n)));
+
+        std::atomic<size_t> next_region(0);
+        std::atomic<bool> improved(false);
+        auto worker = [&]() {
+            for (size_t r; (r = next_region.fetch_add(1)) < regions.size();) {
+                RegionSearch search(settings, tempos, order, pinned, regions[r].first, regions[r].second, deadline);
+                if (search.run())
+                    improved = true;
+            }
+        };
+        std::vector<std::thread> pool_threads;
+        for (unsigned t = 1; t < std::min<size_t>(threads, regions.size()); ++t)
+            pool_threads.push_back(std::thread(worker));
+        worker();
+        for (std::thread& thread : pool_threads)
+            thread.join();
+        result.rounds++;
+        quiet_rounds = improved ? 0 : quiet_rounds + 1;
+    }
+
+    double cost;
+    size_t mixable_pairs;
+    measure(order, cost, mixable_pairs);
+    if (cost < result.initial_cost) {
+        result.order.swap(order);
+        result.cost = cost;
+        result.mixable = mixable_pairs;
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
@@ -51,6 +51,42 @@ bool SessionFileParser::parse_config_file(const std::string& config_path, Sessio
                     std::cout << "[WARNING] Invalid cache size at line " << line_number << std::endl;
                 }
                 
+            } else if (key == "controller_cache_bytes") {
+                try {
+                    config.controller_cache_bytes = static_cast<size_t>(std::stoull(value));
+                } catch (const std::exception& e) {
+                    std::cout << "[WARNING] Invalid cache byte budget at line " << line_number << std::endl;
+                }
+                
+            } else if (key == "controller_cache_policy") {
+                config.controller_cache_policy = value;
+                
+            } else if (key == "controller_trace_file") {
+                config.controller_trace_file = value;
+                
+            } else if (key == "controller_compare_policies") {
+                config.controller_compare_policies = parse_bool(value);
+                
+            } else if (key == "controller_prefetch_depth") {
+                try {
+                    config.controller_prefetch_depth = std::stoi(value);
+                } catch (const std::exception& e) {
+                    std::cout << "[WARNING] Invalid prefetch depth at line " << line_number << std::endl;
+                }
+                
+            } else if (key == "waveform_seed") {
+                try {
+                    config.waveform_seed = std::stoull(value);
+                } catch (const std::exception& e) {
+                    std::cout << "[WARNING] Invalid waveform seed at line " << line_number << std::endl;
+                }
+                
+            } else if (key == "waveform_format") {
+                config.waveform_format = value;
+                
+            } else if (key == "analysis_cache_file") {
+                config.analysis_cache_file = value;
+                
             } else if (key == "bpm_tolerance") {
                 try {
                     config.bpm_tolerance = std::stoi(value);
@@ -61,6 +97,13 @@ bool SessionFileParser::parse_config_file(const std::string& config_path, Sessio
             } else if (key == "auto_sync") {
                 config.auto_sync = parse_bool(value);
                 
+            } else if (key == "playlist_order_budget_ms") {
+                try {
+                    config.playlist_order_budget_ms = std::stoi(value);
+                } catch (const std::exception& e) {
+                    std::cout << "[WARNING] Invalid playlist order budget at line " << line_number << std::endl;
+                }
+                
             } else {
                 // Check if it's a playlist definition (any other key=value where value contains numbers/commas)
                 std::string playlist_name;
@@ -175,6 +218,7 @@ bool SessionFileParser::parse_key_value(const std::string& line, std::string& ke
 bool SessionFileParser::parse_library_track(const std::string& line, SessionConfig::TrackInfo& track_info) {
     // Expected format: MP3,title,{artist1;artist2;},duration,bpm,bitrate,has_tags
     // or: WAV,title,{artist1;artist2;},duration,bpm,sample_rate,bit_depth
+    // optionally followed by ,file_path
     
     std::vector<std::string> parts = split_string(line, ',');
     
@@ -193,6 +237,8 @@ bool SessionFileParser::parse_library_track(const std::string& line, SessionConf
         track_info.bpm = std::stoi(parts[4]);
         track_info.extra_param1 = std::stoi(parts[5]);  // bitrate or sample_rate
         track_info.extra_param2 = std::stoi(parts[6]);  // has_tags or bit_depth
+        if (parts.size() > 7)
+            track_info.file_path = trim_string(parts[7]);
         
         // Validate track type is MP3 or WAV
         if (track_info.type != "MP3" && track_info.type != "WAV") {
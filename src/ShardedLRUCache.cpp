@@ -0,0 +1,129 @@
+#include "ShardedLRUCache.h"
+#include <iostream>
+
+namespace {
+// Shards inspected per global eviction; more samples = closer to true LRU.
+const size_t EVICTION_SAMPLES = 4;
+// Extra per-shard headroom so uneven hashing rarely forces a local eviction.
+const size_t SHARD_SLACK = 8;
+}
+
+const size_t ShardedLRUCache::DEFAULT_SHARDS;
+
+ShardedLRUCache::ShardedLRUCache(size_t capacity, size_t shard_count)
+    : shards(), clock(0), entries(0), max_size(capacity) {
+    if (shard_count == 0)
+        shard_count = 1;
+    size_t per_shard = 2 * ((capacity + shard_count - 1) / shard_count) + SHARD_SLACK;
+    if (per_shard > capacity)
+        per_shard = capacity;
+    shards.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i)
+        shards.emplace_back(new Shard(per_shard, &clock));
+}
+
+size_t ShardedLRUCache::shardIndex(TrackId track_id) const {
+    // Hashed rather than id % shards, so ids interned in strides still spread.
+    return static_cast<size_t>(hash_cache_key(track_id) % shards.size());
+}
+
+ShardedLRUCache::Shard& ShardedLRUCache::shardFor(TrackId track_id) const {
+    return *shards[shardIndex(track_id)];
+}
+
+bool ShardedLRUCache::contains(TrackId track_id) const {
+    Shard& shard = shardFor(track_id);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.cache.contains(track_id);
+}
+
+bool ShardedLRUCache::contains(const std::string& title) const {
+    return contains(TrackRegistry::instance().find(title));
+}
+
+PointerWrapper<AudioTrack> ShardedLRUCache::getCopy(TrackId track_id) {
+    Shard& shard = shardFor(track_id);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    AudioTrack* track = shard.cache.get(track_id);
+    if (!track)
+        return PointerWrapper<AudioTrack>();
+    return track->clone();
+}
+
+PointerWrapper<AudioTrack> ShardedLRUCache::getCopy(const std::string& title) {
+    return getCopy(TrackRegistry::instance().find(title));
+}
+
+bool ShardedLRUCache::put(PointerWrapper<AudioTrack> track) {
+    if (!track || max_size == 0) return false;
+    size_t hint = shardIndex(track->get_id());
+    Shard& shard = *shards[hint];
+    bool evicted = false;
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        size_t before = shard.cache.size();
+        // A local eviction (shard full) keeps the total unchanged.
+        evicted = shard.cache.put(std::move(track));
+        if (shard.cache.size() > before)
+            entries.fetch_add(1, std::memory_order_relaxed);
+    }
+    size_t current = entries.load(std::memory_order_relaxed);
+    while (current > max_size) {
+        // Reserve one eviction; losing the race just means someone else did it.
+        if (!entries.compare_exchange_weak(current, current - 1, std::memory_order_relaxed))
+            continue;
+        if (evictApproxLRU(hint)) {
+            evicted = true;
+        } else {
+            entries.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        current = entries.load(std::memory_order_relaxed);
+    }
+    return evicted;
+}
+
+bool ShardedLRUCache::evictApproxLRU(size_t hint) {
+    size_t count = shards.size();
+    size_t samples = count < EVICTION_SAMPLES ? count : EVICTION_SAMPLES;
+    size_t victim = count;
+    uint64_t oldest = UINT64_MAX;
+    size_t stride = count / samples;
+    for (size_t i = 0; i < samples; ++i) {
+        size_t idx = (hint + i * stride) % count;
+        std::lock_guard<std::mutex> guard(shards[idx]->lock);
+        uint64_t age = shards[idx]->cache.lruAccessTime();
+        if (age < oldest) {
+            oldest = age;
+            victim = idx;
+        }
+    }
+    // Every sampled shard was empty: fall back to any non-empty one.
+    for (size_t i = 0; victim == count && i < count; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i]->lock);
+        if (shards[i]->cache.size() > 0)
+            victim = i;
+    }
+    if (victim == count)
+        return false;
+    std::lock_guard<std::mutex> guard(shards[victim]->lock);
+    return shards[victim]->cache.evictLRU();
+}
+
+void ShardedLRUCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        entries.fetch_sub(shard->cache.size(), std::memory_order_relaxed);
+        shard->cache.clear();
+    }
+}
+
+void ShardedLRUCache::displayStatus() const {
+    std::cout << "[ShardedLRUCache] Status: " << size() << "/" << max_size << " entries in "
+              << shards.size() << " shards\n";
+    for (size_t i = 0; i < shards.size(); ++i) {
+        std::lock_guard<std::mutex> guard(shards[i]->lock);
+        std::cout << "  Shard " << i << ": " << shards[i]->cache.size() << "/"
+                  << shards[i]->cache.capacity() << " used\n";
+    }
+}
@@ -0,0 +1,117 @@
+#include "TrackRegistry.h"
+#include <algorithm>
+#include <functional>
+
+const size_t TrackRegistry::SHARDS;
+const size_t TrackRegistry::FIRST_CHUNK;
+const size_t TrackRegistry::MAX_CHUNKS;
+
+namespace {
+// Chunk k covers ids [first_chunk * (2^k - 1), first_chunk * (2^(k+1) - 1)).
+size_t chunk_of(size_t id, size_t first_chunk) {
+    size_t blocks = id / first_chunk + 1;
+    size_t k = 0;
+    while (blocks >> (k + 1))
+        ++k;
+    return k;
+}
+
+size_t chunk_start(size_t k, size_t first_chunk) {
+    return first_chunk * ((static_cast<size_t>(1) << k) - 1);
+}
+}
+
+TrackRegistry& TrackRegistry::instance() {
+    static TrackRegistry registry;
+    return registry;
+}
+
+TrackRegistry::TrackRegistry() : shards(), chunks(), next_id(0), growth() {
+    for (size_t k = 0; k < MAX_CHUNKS; ++k)
+        chunks[k].store(nullptr, std::memory_order_relaxed);
+}
+
+TrackRegistry::~TrackRegistry() {
+    for (size_t k = 0; k < MAX_CHUNKS; ++k)
+        delete[] chunks[k].load(std::memory_order_relaxed);
+}
+
+const TrackRegistry::Entry* TrackRegistry::Shard::find(size_t hash, const std::string& title) const {
+    // Equal keys are adjacent; stop at the first match rather than finding the range's end.
+    for (auto it = ids.find(hash); it != ids.end() && it->first == hash; ++it)
+        if (*it->second.title == title)
+            return &it->second;
+    return nullptr;
+}
+
+TrackRegistry::TitleSlot* TrackRegistry::title_slot(TrackId id) const {
+    size_t k = chunk_of(id, FIRST_CHUNK);
+    TitleSlot* slots = chunks[k].load(std::memory_order_acquire);
+    return slots ? slots + (id - chunk_start(k, FIRST_CHUNK)) : nullptr;
+}
+
+TrackRegistry::TitleSlot* TrackRegistry::chunk(size_t k) {
+    TitleSlot* slots = chunks[k].load(std::memory_order_acquire);
+    if (slots)
+        return slots;
+    std::lock_guard<std::mutex> lock(growth);
+    slots = chunks[k].load(std::memory_order_relaxed);
+    if (!slots) {
+        size_t count = FIRST_CHUNK << k;
+        slots = new TitleSlot[count];
+        for (size_t i = 0; i < count; ++i)
+            slots[i].store(nullptr, std::memory_order_relaxed);
+        chunks[k].store(slots, std::memory_order_release);
+    }
+    return slots;
+}
+
+TrackId TrackRegistry::intern(const std::string& title) {
+    size_t hash = std::hash<std::string>()(title);
+    Shard& shard = shard_for(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (const Entry* found = shard.find(hash, title))
+        return found->id;
+    TrackId id = next_id.fetch_add(1, std::memory_order_relaxed);
+    shard.titles.push_back(title);
+    Entry entry = {&shard.titles.back(), id};
+    shard.ids.insert(std::make_pair(hash, entry));
+    // Published before the id is returned, so whoever holds an id can read its title.
+    size_t k = chunk_of(id, FIRST_CHUNK);
+    chunk(k)[id - chunk_start(k, FIRST_CHUNK)].store(entry.title, std::memory_order_release);
+    return id;
+}
+
+TrackId TrackRegistry::find(const std::string& title) const {
+    size_t hash = std::hash<std::string>()(title);
+    const Shard& shard = shard_for(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const Entry* found = shard.find(hash, title);
+    return found ? found->id : INVALID_TRACK_ID;
+}
+
+const std::string& TrackRegistry::title(TrackId id) const {
+    static const std::string unknown;
+    if (id >= next_id.load(std::memory_order_acquire))
+        return unknown;
+    const TitleSlot* slot = title_slot(id);
+    const std::string* title = slot ? slot->load(std::memory_order_acquire) : nullptr;
+    return title ? *title : unknown;
+}
+
+size_t TrackRegistry::size() const {
+    return next_id.load(std::memory_order_acquire);
+}
+
+void TrackRegistry::reserve(size_t additional) {
+    if (additional == 0)
+        return;
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.ids.reserve(shard.ids.size() + additional / SHARDS + 1);
+    }
+    size_t first = size();
+    size_t last = std::min<size_t>(first + additional, INVALID_TRACK_ID) - 1;
+    for (size_t k = chunk_of(first, FIRST_CHUNK); k <= chunk_of(last, FIRST_CHUNK); ++k)
+        chunk(k);
+}
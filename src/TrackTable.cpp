@@ -0,0 +1,53 @@
+#include "TrackTable.h"
+#include <algorithm>
+
+TrackRecord::TrackRecord(TrackId id, int duration, int bpm, TrackFormat format)
+    : track_id(id), duration_seconds(duration), beats_per_minute(bpm), tag(format), params() {}
+
+TrackRecord TrackRecord::mp3(TrackId id, int duration_seconds, int bpm, int bitrate, bool has_id3_tags) {
+    TrackRecord record(id, duration_seconds, bpm, TrackFormat::MP3);
+    record.params.mp3.bitrate = bitrate;
+    record.params.mp3.has_id3_tags = has_id3_tags;
+    return record;
+}
+
+TrackRecord TrackRecord::wav(TrackId id, int duration_seconds, int bpm, int sample_rate, int bit_depth) {
+    TrackRecord record(id, duration_seconds, bpm, TrackFormat::WAV);
+    record.params.wav.sample_rate = sample_rate;
+    record.params.wav.bit_depth = bit_depth;
+    return record;
+}
+
+bool TrackTable::add(const AudioTrack& track) {
+    // The only dynamic dispatch: once per track, when the table is built.
+    if (const MP3Track* mp3 = dynamic_cast<const MP3Track*>(&track)) {
+        records.push_back(TrackRecord::mp3(track.get_id(), track.get_duration(), track.get_bpm(),
+                                           mp3->get_bitrate(), mp3->has_tags()));
+        return true;
+    }
+    if (const WAVTrack* wav = dynamic_cast<const WAVTrack*>(&track)) {
+        records.push_back(TrackRecord::wav(track.get_id(), track.get_duration(), track.get_bpm(),
+                                           wav->get_sample_rate(), wav->get_bit_depth()));
+        return true;
+    }
+    return false;
+}
+
+void TrackTable::quality_scores(std::vector<double>& scores) const {
+    scores.resize(records.size());
+    for (size_t i = 0; i < records.size(); ++i)
+        scores[i] = records[i].quality_score();
+}
+
+void TrackTable::rank_by_quality(size_t count, std::vector<size_t>& rows) const {
+    std::vector<double> scores;
+    quality_scores(scores);
+    count = std::min(count, records.size());
+    rows.resize(records.size());
+    for (size_t i = 0; i < rows.size(); ++i)
+        rows[i] = i;
+    std::partial_sort(rows.begin(), rows.begin() + count, rows.end(), [&scores](size_t a, size_t b) {
+        return scores[a] != scores[b] ? scores[a] > scores[b] : a < b;
+    });
+    rows.resize(count);
+}
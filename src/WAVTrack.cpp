@@ -1,46 +1,99 @@
-#include "WAVTrack.h"
-#include <iostream>
-
-WAVTrack::WAVTrack(const std::string& title, const std::vector<std::string>& artists, 
-                   int duration, int bpm, int sample_rate, int bit_depth)
-    : AudioTrack(title, artists, duration, bpm), sample_rate(sample_rate), bit_depth(bit_depth) {
-
-    std::cout << "WAVTrack created: " << sample_rate << "Hz/" << bit_depth << "bit" << std::endl;
-}
-
-void WAVTrack::load() {
-    std::cout << "[WAVTrack::load] Loading WAV: \"" << title
-              << "\" at " << sample_rate << "Hz/" << bit_depth
-              << "bit (uncompressed)..." << std::endl;
-    long long size =
-        static_cast<long long>(duration_seconds) *
-        sample_rate *
-        (bit_depth / 8) *
-        2;
-    std::cout << "  → Estimated file size: " << size << " bytes" << std::endl;
-    std::cout << "  → Fast loading due to uncompressed format." << std::endl;
-}
-
-void WAVTrack::analyze_beatgrid() {
-    std::cout << "[WAVTrack::analyze_beatgrid] Analyzing beat grid for: \"" << title << "\"\n";
-    double beats = (duration_seconds / 60.0) * bpm;
-    std::cout << "  → Estimated beats: " << beats
-              << "  → Precision factor: 1 (uncompressed audio)" << std::endl;
-}
-
-double WAVTrack::get_quality_score() const {
-    double score = 70.0;
-    if (sample_rate >= 44100)
-        score += 10.0;
-    if (sample_rate >= 96000)
-        score += 5.0;
-    if (bit_depth >= 16)
-        score += 10.0;
-    if (bit_depth >= 24)
-        score += 5.0;
-    return std::min(score, 100.0);
-}
-
-PointerWrapper<AudioTrack> WAVTrack::clone() const {
-    return PointerWrapper<AudioTrack>(new WAVTrack(*this));
+#include "WAVTrack.h"
+#include <algorithm>
+#include <iostream>
+
+WAVTrack::WAVTrack(const std::string& title, const std::vector<std::string>& artists, 
+                   int duration, int bpm, int sample_rate, int bit_depth,
+                   const std::string& file_path)
+    : AudioTrack(title, artists, duration, bpm), sample_rate(sample_rate), bit_depth(bit_depth),
+      file_path(file_path), wav_file() {
+
+    std::cout << "WAVTrack created: " << sample_rate << "Hz/" << bit_depth << "bit" << std::endl;
+}
+
+void WAVTrack::load() {
+    std::cout << "[WAVTrack::load] Loading WAV: \"" << title
+              << "\" at " << sample_rate << "Hz/" << bit_depth
+              << "bit (uncompressed)..." << std::endl;
+    if (map_file()) {
+        const PcmView& pcm = wav_file->pcm();
+        std::cout << "  → Mapped " << file_path << ": " << pcm.channels() << " ch, "
+                  << wav_file->sample_rate() << "Hz/" << pcm.bits_per_sample() << "bit"
+                  << (pcm.is_float() ? " float" : "") << ", " << pcm.frames() << " frames ("
+                  << wav_file->duration_seconds() << "s)" << std::endl;
+        auto name = wav_file->info().find("INAM");
+        if (name != wav_file->info().end())
+            std::cout << "  → INFO title: " << name->second << std::endl;
+        if (!wav_file->cue_points().empty())
+            std::cout << "  → Cue points: " << wav_file->cue_points().size() << std::endl;
+        std::cout << "  → Zero-copy PCM view: " << pcm.size_bytes() << " bytes, paged in on use." << std::endl;
+        return;
+    }
+    long long size =
+        static_cast<long long>(duration_seconds) *
+        sample_rate *
+        (bit_depth / 8) *
+        2;
+    std::cout << "  → Estimated file size: " << size << " bytes" << std::endl;
+    std::cout << "  → Fast loading due to uncompressed format." << std::endl;
+}
+
+bool WAVTrack::map_file() {
+    if (wav_file)
+        return true;
+    if (file_path.empty())
+        return false;
+    std::shared_ptr<WavFile> file = std::make_shared<WavFile>();
+    if (!file->open(file_path)) {
+        std::cout << "  → [WARNING] Cannot map " << file_path << ": " << file->error() << std::endl;
+        return false;
+    }
+    wav_file = file;
+    sample_rate = static_cast<int>(file->sample_rate());
+    bit_depth = static_cast<int>(file->pcm().bits_per_sample());
+    set_duration(static_cast<int>(file->duration_seconds() + 0.5));
+    return true;
+}
+
+bool WAVTrack::analysis_window(std::vector<double>& samples, double& rate) const {
+    if (!wav_file || wav_file->sample_rate() == 0)
+        return false;
+    const PcmView& pcm = wav_file->pcm();
+    size_t frames = std::min(pcm.frames(), static_cast<size_t>(ANALYSIS_SECONDS) * wav_file->sample_rate());
+    if (frames == 0)
+        return false;
+    samples.assign(frames, 0.0);
+    std::vector<double> channel(frames);
+    for (unsigned c = 0; c < pcm.channels(); ++c) {
+        pcm.decode(0, frames, c, channel.data());
+        for (size_t i = 0; i < frames; ++i)
+            samples[i] += channel[i];
+    }
+    for (double& sample : samples)
+        sample /= pcm.channels();
+    rate = wav_file->sample_rate();
+    return true;
+}
+
+void WAVTrack::analyze_beatgrid() {
+    std::cout << "[WAVTrack::analyze_beatgrid] Analyzing beat grid for: \"" << title << "\"\n";
+    const BeatGrid& grid = detect_beat_grid();
+    double beats = (duration_seconds / 60.0) * get_tempo();
+    std::cout << "  → Estimated beats: " << beats
+              << "  → Precision factor: 1 (uncompressed audio)" << std::endl;
+    if (grid.reliable())
+        std::cout << "  → Detected tempo: " << grid.bpm << " BPM (confidence " << grid.confidence
+                  << ", first beat at " << grid.first_beat << "s)" << std::endl;
+}
+
+double WAVTrack::get_quality_score() const {
+    return quality_score(sample_rate, bit_depth);
+}
+
+PointerWrapper<AudioTrack> WAVTrack::clone() const {
+    return PointerWrapper<AudioTrack>(new WAVTrack(*this));
+}
+
+size_t WAVTrack::memory_footprint() const {
+    return sizeof(WAVTrack) + heap_footprint();
 }
\ No newline at end of file
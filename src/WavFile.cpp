@@ -0,0 +1,227 @@
+#include "WavFile.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const uint16_t FORMAT_PCM = 0x0001;
+const uint16_t FORMAT_IEEE_FLOAT = 0x0003;
+const uint16_t FORMAT_EXTENSIBLE = 0xFFFE;
+
+// WAV is little-endian; assemble bytes explicitly so unaligned reads are safe.
+inline uint16_t read_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t read_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t read_u64(const uint8_t* p) {
+    return static_cast<uint64_t>(read_u32(p)) | (static_cast<uint64_t>(read_u32(p + 4)) << 32);
+}
+
+inline bool fourcc_is(const uint8_t* p, const char* id) {
+    return std::memcmp(p, id, 4) == 0;
+}
+
+inline double int16_sample(const uint8_t* p) {
+    return static_cast<int16_t>(read_u16(p)) * (1.0 / 32768.0);
+}
+
+inline double int24_sample(const uint8_t* p) {
+    // Place the 24 bits at the top of an int32 so the sign extends.
+    int32_t v = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) | (static_cast<uint32_t>(p[1]) << 16) |
+                                     (static_cast<uint32_t>(p[2]) << 24));
+    return (v >> 8) * (1.0 / 8388608.0);
+}
+
+inline double int32_sample(const uint8_t* p) {
+    return static_cast<int32_t>(read_u32(p)) * (1.0 / 2147483648.0);
+}
+
+inline double float32_sample(const uint8_t* p) {
+    uint32_t bits = read_u32(p);
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+inline double float64_sample(const uint8_t* p) {
+    uint64_t bits = read_u64(p);
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+template<double (*Convert)(const uint8_t*)>
+void decode_frames(const uint8_t* p, size_t stride, size_t count, double* out) {
+    for (size_t i = 0; i < count; ++i, p += stride)
+        out[i] = Convert(p);
+}
+
+} // namespace
+
+PcmView::PcmView()
+    : pcm(nullptr), frame_count(0), channel_count(0), bits(0), floating(false), frame_bytes(0) {}
+
+PcmView::PcmView(const uint8_t* bytes, size_t frames, unsigned channels, unsigned bits_per_sample,
+                 bool is_float, size_t block_align)
+    : pcm(bytes), frame_count(frames), channel_count(channels), bits(bits_per_sample),
+      floating(is_float), frame_bytes(block_align) {}
+
+double PcmView::sample(size_t frame, unsigned channel) const {
+    double value = 0.0;
+    decode(frame, 1, channel, &value);
+    return value;
+}
+
+size_t PcmView::decode(size_t first, size_t count, unsigned channel, double* out) const {
+    if (first >= frame_count || channel >= channel_count)
+        return 0;
+    count = std::min(count, frame_count - first);
+    const uint8_t* p = pcm + first * frame_bytes + channel * (bits / 8);
+    if (floating) {
+        if (bits == 32)
+            decode_frames<float32_sample>(p, frame_bytes, count, out);
+        else
+            decode_frames<float64_sample>(p, frame_bytes, count, out);
+    } else if (bits == 16) {
+        decode_frames<int16_sample>(p, frame_bytes, count, out);
+    } else if (bits == 24) {
+        decode_frames<int24_sample>(p, frame_bytes, count, out);
+    } else {
+        decode_frames<int32_sample>(p, frame_bytes, count, out);
+    }
+    return count;
+}
+
+WavFile::WavFile() : file(), samples(), rate(0), info_tags(), cues(), last_error() {}
+
+double WavFile::duration_seconds() const {
+    return rate ? static_cast<double>(samples.frames()) / rate : 0.0;
+}
+
+bool WavFile::fail(const std::string& message) {
+    last_error = message;
+    samples = PcmView();
+    file.close();
+    return false;
+}
+
+bool WavFile::open(const std::string& path) {
+    samples = PcmView();
+    rate = 0;
+    info_tags.clear();
+    cues.clear();
+    if (!file.open(path))
+        return fail(file.error());
+
+    const uint8_t* bytes = file.data();
+    size_t size = file.size();
+    if (size < 12 || !fourcc_is(bytes, "RIFF") || !fourcc_is(bytes + 8, "WAVE"))
+        return fail("not a RIFF/WAVE file");
+
+    bool have_format = false;
+    unsigned channels = 0, bits = 0;
+    bool is_float = false;
+    size_t block_align = 0;
+    const uint8_t* data = nullptr;
+    size_t data_size = 0;
+
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        const uint8_t* header = bytes + offset;
+        size_t chunk_size = read_u32(header + 4);
+        size_t available = size - offset - 8;
+        const uint8_t* body = header + 8;
+        if (fourcc_is(header, "data")) {
+            data = body;
+            data_size = std::min(chunk_size, available);
+        } else if (chunk_size > available) {
+            break;  // truncated header chunk; keep what was parsed so far
+        } else if (fourcc_is(header, "fmt ")) {
+            if (!parse_format(body, chunk_size, channels, bits, is_float, block_align))
+                return false;
+            have_format = true;
+        } else if (fourcc_is(header, "LIST")) {
+            parse_list(body, chunk_size);
+        } else if (fourcc_is(header, "cue ")) {
+            parse_cue(body, chunk_size);
+        }
+        if (chunk_size > available)
+            break;
+        offset += 8 + chunk_size + (chunk_size & 1);  // chunks are padded to even sizes
+    }
+
+    if (!have_format)
+        return fail("missing fmt chunk");
+    if (!data)
+        return fail("missing data chunk");
+    samples = PcmView(data, data_size / block_align, channels, bits, is_float, block_align);
+    return true;
+}
+
+bool WavFile::parse_format(const uint8_t* chunk, size_t size, unsigned& channels, unsigned& bits,
+                           bool& is_float, size_t& block_align) {
+    if (size < 16)
+        return fail("fmt chunk too short");
+    uint16_t tag = read_u16(chunk);
+    channels = read_u16(chunk + 2);
+    rate = read_u32(chunk + 4);
+    block_align = read_u16(chunk + 12);
+    bits = read_u16(chunk + 14);
+    if (tag == FORMAT_EXTENSIBLE) {
+        // cbSize, valid bits, channel mask, then the SubFormat GUID whose first two bytes are the real tag
+        if (size < 40)
+            return fail("WAVE_FORMAT_EXTENSIBLE fmt chunk too short");
+        tag = read_u16(chunk + 24);
+    }
+    if (tag == FORMAT_PCM)
+        is_float = false;
+    else if (tag == FORMAT_IEEE_FLOAT)
+        is_float = true;
+    else
+        return fail("unsupported WAV format tag " + std::to_string(tag));
+
+    bool supported = is_float ? (bits == 32 || bits == 64) : (bits == 16 || bits == 24 || bits == 32);
+    if (!supported)
+        return fail("unsupported sample size: " + std::to_string(bits) + (is_float ? "-bit float" : "-bit integer"));
+    if (channels == 0 || block_align < channels * (bits / 8))
+        return fail("inconsistent fmt chunk");
+    return true;
+}
+
+void WavFile::parse_list(const uint8_t* chunk, size_t size) {
+    if (size < 4 || !fourcc_is(chunk, "INFO"))
+        return;
+    size_t offset = 4;
+    while (offset + 8 <= size) {
+        size_t length = read_u32(chunk + offset + 4);
+        if (length > size - offset - 8)
+            return;
+        const char* text = reinterpret_cast<const char*>(chunk + offset + 8);
+        // Values are NUL-terminated (and padded); stop at the first NUL.
+        size_t used = 0;
+        while (used < length && text[used])
+            ++used;
+        info_tags[std::string(reinterpret_cast<const char*>(chunk + offset), 4)] = std::string(text, used);
+        offset += 8 + length + (length & 1);
+    }
+}
+
+void WavFile::parse_cue(const uint8_t* chunk, size_t size) {
+    if (size < 4)
+        return;
+    // Each point: id, position, fccChunk, chunkStart, blockStart, sampleOffset
+    size_t count = std::min<size_t>(read_u32(chunk), (size - 4) / 24);
+    cues.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* point = chunk + 4 + i * 24;
+        WavCuePoint cue;
+        cue.id = read_u32(point);
+        cue.sample_offset = read_u32(point + 20);
+        cues.push_back(cue);
+    }
+}
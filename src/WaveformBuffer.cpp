@@ -0,0 +1,245 @@
+#include "WaveformBuffer.h"
+#include "AnalysisCache.h"
+#include "WaveformPool.h"
+#include "WaveformPyramid.h"
+#include "WaveformRandom.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+const size_t WaveformBuffer::BLOCK_SAMPLES;
+
+namespace {
+std::atomic<int> g_default_format(static_cast<int>(WaveformFormat::Float64));
+
+size_t sample_bytes(WaveformFormat format) {
+    switch (format) {
+        case WaveformFormat::Float32: return sizeof(float);
+        case WaveformFormat::Int16:   return sizeof(int16_t);
+        case WaveformFormat::Int8:    return sizeof(int8_t);
+        default:                      return sizeof(double);
+    }
+}
+
+bool is_quantized(WaveformFormat format) {
+    return format == WaveformFormat::Int16 || format == WaveformFormat::Int8;
+}
+
+// Quantize one block to [-limit, limit] with scale = peak / limit.
+template<typename Q>
+float quantize_block(const double* source, size_t n, Q* out, int limit) {
+    double peak = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        peak = std::max(peak, std::fabs(source[i]));
+    float scale = static_cast<float>(peak / limit);
+    if (scale <= 0.0f) {
+        std::fill(out, out + n, Q(0));
+        return 0.0f;
+    }
+    double inverse = 1.0 / scale;
+    for (size_t i = 0; i < n; ++i) {
+        // shifted to be non-negative, so truncation rounds to nearest without a branch
+        double v = std::max<double>(-limit, std::min<double>(limit, source[i] * inverse));
+        out[i] = static_cast<Q>(static_cast<int>(v + (limit + 0.5)) - limit);
+    }
+    return scale;
+}
+}
+
+void WaveformBuffer::set_default_format(WaveformFormat format) {
+    g_default_format.store(static_cast<int>(format));
+}
+
+WaveformFormat WaveformBuffer::default_format() {
+    return static_cast<WaveformFormat>(g_default_format.load());
+}
+
+const char* WaveformBuffer::format_name(WaveformFormat format) {
+    switch (format) {
+        case WaveformFormat::Float32: return "float32";
+        case WaveformFormat::Int16:   return "int16";
+        case WaveformFormat::Int8:    return "int8";
+        default:                      return "float64";
+    }
+}
+
+bool WaveformBuffer::parse_format(const std::string& name, WaveformFormat& out) {
+    const WaveformFormat formats[] = {WaveformFormat::Float64, WaveformFormat::Float32,
+                                      WaveformFormat::Int16, WaveformFormat::Int8};
+    for (WaveformFormat format : formats)
+        if (name == format_name(format)) {
+            out = format;
+            return true;
+        }
+    return false;
+}
+
+size_t WaveformBuffer::storage_words(size_t count, WaveformFormat format) {
+    size_t bytes = (count * sample_bytes(format) + 7) / 8 * 8;
+    if (is_quantized(format))
+        bytes += (count + BLOCK_SAMPLES - 1) / BLOCK_SAMPLES * sizeof(float);
+    return (bytes + 7) / 8;
+}
+
+size_t WaveformBuffer::allocated_bytes() const {
+    return WaveformPool::blockBytes(storage_words(count, format));
+}
+
+WaveformBuffer::WaveformBuffer(size_t sample_count, uint64_t noise_seed, WaveformFormat storage_format)
+    : storage(nullptr), count(sample_count), seed(noise_seed), format(storage_format), generated(true),
+      materialize_once(), materialized(false), pyramid_mutex(), pyramid_memo(), pyramid_ready(false) {}
+
+WaveformBuffer::WaveformBuffer(const double* source, size_t sample_count, WaveformFormat storage_format)
+    : storage(nullptr), count(sample_count), seed(0), format(storage_format), generated(false),
+      materialize_once(), materialized(true), pyramid_mutex(), pyramid_memo(), pyramid_ready(false) {
+    allocate_storage();
+    if (source && count)
+        encode(source);
+}
+
+WaveformBuffer::WaveformBuffer(const WaveformBuffer& source, WaveformFormat storage_format)
+    : storage(nullptr), count(source.count), seed(source.seed), format(storage_format),
+      generated(source.generated), materialize_once(), materialized(false),
+      pyramid_mutex(), pyramid_memo(), pyramid_ready(false) {
+    if (generated)
+        return;   // regenerate from the seed on first read
+    allocate_storage();
+    if (count) {
+        if (format == WaveformFormat::Float64) {
+            source.decode(0, count, static_cast<double*>(storage));
+        } else {
+            double* scratch = WaveformPool::instance().allocate(count);
+            source.decode(0, count, scratch);
+            encode(scratch);
+            WaveformPool::instance().release(scratch, count);
+        }
+    }
+    materialized.store(true, std::memory_order_release);
+}
+
+WaveformBuffer::~WaveformBuffer() {
+    WaveformPool::instance().release(static_cast<double*>(storage), storage_words(count, format));
+}
+
+void WaveformBuffer::allocate_storage() const {
+    size_t words = storage_words(count, format);
+    storage = WaveformPool::instance().allocate(words);
+    if (words) {
+        // Zero the padding words so content_hash() only sees defined bytes.
+        double* block = static_cast<double*>(storage);
+        std::memset(block + (count * sample_bytes(format) + 7) / 8 - 1, 0, sizeof(double));
+        std::memset(block + words - 1, 0, sizeof(double));
+    }
+}
+
+const float* WaveformBuffer::block_scales() const {
+    const unsigned char* base = static_cast<const unsigned char*>(storage);
+    return reinterpret_cast<const float*>(base + (count * sample_bytes(format) + 7) / 8 * 8);
+}
+
+void WaveformBuffer::encode(const double* source) const {
+    float* scales = const_cast<float*>(block_scales());
+    switch (format) {
+        case WaveformFormat::Float64:
+            std::memcpy(storage, source, count * sizeof(double));
+            break;
+        case WaveformFormat::Float32: {
+            float* out = static_cast<float*>(storage);
+            for (size_t i = 0; i < count; ++i)
+                out[i] = static_cast<float>(source[i]);
+            break;
+        }
+        case WaveformFormat::Int16:
+            for (size_t first = 0, b = 0; first < count; first += BLOCK_SAMPLES, ++b)
+                scales[b] = quantize_block(source + first, std::min(BLOCK_SAMPLES, count - first),
+                                           static_cast<int16_t*>(storage) + first, 32767);
+            break;
+        case WaveformFormat::Int8:
+            for (size_t first = 0, b = 0; first < count; first += BLOCK_SAMPLES, ++b)
+                scales[b] = quantize_block(source + first, std::min(BLOCK_SAMPLES, count - first),
+                                           static_cast<int8_t*>(storage) + first, 127);
+            break;
+    }
+}
+
+void WaveformBuffer::materialize() const {
+    std::call_once(materialize_once, [this]() {
+        if (!materialized.load(std::memory_order_relaxed) && count) {
+            allocate_storage();
+            if (format == WaveformFormat::Float64) {
+                WaveformRandom::fill(static_cast<double*>(storage), count, seed);
+            } else {
+                double* scratch = WaveformPool::instance().allocate(count);
+                WaveformRandom::fill(scratch, count, seed);
+                encode(scratch);
+                WaveformPool::instance().release(scratch, count);
+            }
+        }
+        materialized.store(true, std::memory_order_release);
+    });
+}
+
+void WaveformBuffer::decode(size_t first, size_t n, double* out, const WaveformKernels::Table& kernels) const {
+    if (!out || first >= count)
+        return;
+    n = std::min(n, count - first);
+    if (!materialized.load(std::memory_order_acquire))
+        materialize();
+    switch (format) {
+        case WaveformFormat::Float64:
+            std::memcpy(out, static_cast<const double*>(storage) + first, n * sizeof(double));
+            break;
+        case WaveformFormat::Float32:
+            kernels.decode_f32(static_cast<const float*>(storage) + first, n, out);
+            break;
+        case WaveformFormat::Int16:
+        case WaveformFormat::Int8: {
+            const float* scales = block_scales();
+            size_t done = 0;
+            while (done < n) {
+                size_t pos = first + done;
+                size_t chunk = std::min(n - done, BLOCK_SAMPLES - pos % BLOCK_SAMPLES);
+                double scale = scales[pos / BLOCK_SAMPLES];
+                if (format == WaveformFormat::Int16)
+                    kernels.decode_i16(static_cast<const int16_t*>(storage) + pos, chunk, scale, out + done);
+                else
+                    kernels.decode_i8(static_cast<const int8_t*>(storage) + pos, chunk, scale, out + done);
+                done += chunk;
+            }
+            break;
+        }
+    }
+}
+
+uint64_t WaveformBuffer::content_hash() const {
+    uint64_t hash = AnalysisCache::combine(generated ? 1 : 2, count);
+    hash = AnalysisCache::combine(hash, static_cast<uint64_t>(format));
+    if (generated)
+        return AnalysisCache::combine(hash, seed);
+    if (!materialized.load(std::memory_order_acquire))
+        materialize();
+    return AnalysisCache::hash_bytes(hash, storage, storage_bytes());
+}
+
+const WaveformPyramid& WaveformBuffer::pyramid() const {
+    if (!pyramid_ready.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(pyramid_mutex);
+        if (!pyramid_memo) {
+            pyramid_memo.reset(new WaveformPyramid(*this));
+            pyramid_ready.store(true, std::memory_order_release);
+        }
+    }
+    return *pyramid_memo;
+}
+
+size_t WaveformBuffer::pyramid_bytes() const {
+    if (!pyramid_ready.load(std::memory_order_acquire))
+        return 0;
+    return sizeof(WaveformPyramid) + pyramid_memo->memory_bytes();
+}
+
+void WaveformBuffer::drop_pyramid() {
+    // Only the sole owner writes, so no reader can be holding the old pyramid.
+    pyramid_memo.reset();
+    pyramid_ready.store(false, std::memory_order_release);
+}
@@ -0,0 +1,410 @@
+#include "WaveformKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define WAVEFORM_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// ========== SCALAR ==========
+
+double scalar_sum_squares(const double* data, size_t count) {
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i)
+        sum += data[i] * data[i];
+    return sum;
+}
+
+double scalar_peak_abs(const double* data, size_t count) {
+    double peak = 0.0;
+    for (size_t i = 0; i < count; ++i)
+        peak = std::max(peak, std::fabs(data[i]));
+    return peak;
+}
+
+size_t scalar_zero_crossings(const double* data, size_t count) {
+    size_t crossings = 0;
+    for (size_t i = 1; i < count; ++i)
+        crossings += (data[i - 1] < 0.0) != (data[i] < 0.0);
+    return crossings;
+}
+
+void scalar_min_max(const double* data, size_t count, double* lo, double* hi) {
+    double mn = count ? data[0] : 0.0;
+    double mx = mn;
+    for (size_t i = 1; i < count; ++i) {
+        mn = std::min(mn, data[i]);
+        mx = std::max(mx, data[i]);
+    }
+    *lo = mn;
+    *hi = mx;
+}
+
+void scalar_butterflies(double* ar, double* ai, double* br, double* bi,
+                        const double* wr, const double* wi, size_t count) {
+    for (size_t j = 0; j < count; ++j) {
+        double tr = br[j] * wr[j] - bi[j] * wi[j];
+        double ti = br[j] * wi[j] + bi[j] * wr[j];
+        br[j] = ar[j] - tr;
+        bi[j] = ai[j] - ti;
+        ar[j] += tr;
+        ai[j] += ti;
+    }
+}
+
+void scalar_decode_f32(const float* src, size_t count, double* out) {
+    for (size_t i = 0; i < count; ++i)
+        out[i] = src[i];
+}
+
+void scalar_decode_i16(const int16_t* src, size_t count, double scale, double* out) {
+    for (size_t i = 0; i < count; ++i)
+        out[i] = src[i] * scale;
+}
+
+void scalar_decode_i8(const int8_t* src, size_t count, double scale, double* out) {
+    for (size_t i = 0; i < count; ++i)
+        out[i] = src[i] * scale;
+}
+
+const WaveformKernels::Table SCALAR_TABLE = {
+    "scalar", scalar_sum_squares, scalar_peak_abs, scalar_zero_crossings, scalar_min_max,
+    scalar_butterflies, scalar_decode_f32, scalar_decode_i16, scalar_decode_i8
+};
+
+#ifdef WAVEFORM_KERNELS_X86
+
+// ========== SSE2 ==========
+
+#define SSE2_TARGET __attribute__((target("sse2")))
+
+SSE2_TARGET double sse2_sum_squares(const double* data, size_t count) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128d a = _mm_loadu_pd(data + i);
+        __m128d b = _mm_loadu_pd(data + i + 2);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(a, a));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(b, b));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    return lanes[0] + lanes[1] + scalar_sum_squares(data + i, count - i);
+}
+
+SSE2_TARGET double sse2_peak_abs(const double* data, size_t count) {
+    const __m128d abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    __m128d peak = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+        peak = _mm_max_pd(peak, _mm_and_pd(_mm_loadu_pd(data + i), abs_mask));
+    double lanes[2];
+    _mm_storeu_pd(lanes, peak);
+    return std::max(std::max(lanes[0], lanes[1]), scalar_peak_abs(data + i, count - i));
+}
+
+SSE2_TARGET size_t sse2_zero_crossings(const double* data, size_t count) {
+    if (count < 2)
+        return 0;
+    const __m128d zero = _mm_setzero_pd();
+    size_t crossings = 0;
+    size_t i = 0;
+    // Compare sign of data[i..i+1] with data[i+1..i+2].
+    for (; i + 3 <= count; i += 2) {
+        __m128d a = _mm_cmplt_pd(_mm_loadu_pd(data + i), zero);
+        __m128d b = _mm_cmplt_pd(_mm_loadu_pd(data + i + 1), zero);
+        int mask = _mm_movemask_pd(_mm_xor_pd(a, b));
+        crossings += static_cast<size_t>((mask & 1) + ((mask >> 1) & 1));
+    }
+    return crossings + scalar_zero_crossings(data + i, count - i);
+}
+
+SSE2_TARGET void sse2_min_max(const double* data, size_t count, double* lo, double* hi) {
+    if (count < 2) {
+        scalar_min_max(data, count, lo, hi);
+        return;
+    }
+    __m128d mn = _mm_loadu_pd(data), mx = mn;
+    size_t i = 2;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(data + i);
+        mn = _mm_min_pd(mn, v);
+        mx = _mm_max_pd(mx, v);
+    }
+    double mins[2], maxs[2];
+    _mm_storeu_pd(mins, mn);
+    _mm_storeu_pd(maxs, mx);
+    double tail_lo = mins[0], tail_hi = maxs[0];
+    if (i < count)
+        scalar_min_max(data + i, count - i, &tail_lo, &tail_hi);
+    *lo = std::min(std::min(mins[0], mins[1]), tail_lo);
+    *hi = std::max(std::max(maxs[0], maxs[1]), tail_hi);
+}
+
+SSE2_TARGET void sse2_butterflies(double* ar, double* ai, double* br, double* bi,
+                                  const double* wr, const double* wi, size_t count) {
+    size_t j = 0;
+    for (; j + 2 <= count; j += 2) {
+        __m128d xr = _mm_loadu_pd(br + j), xi = _mm_loadu_pd(bi + j);
+        __m128d cr = _mm_loadu_pd(wr + j), ci = _mm_loadu_pd(wi + j);
+        __m128d tr = _mm_sub_pd(_mm_mul_pd(xr, cr), _mm_mul_pd(xi, ci));
+        __m128d ti = _mm_add_pd(_mm_mul_pd(xr, ci), _mm_mul_pd(xi, cr));
+        __m128d yr = _mm_loadu_pd(ar + j), yi = _mm_loadu_pd(ai + j);
+        _mm_storeu_pd(br + j, _mm_sub_pd(yr, tr));
+        _mm_storeu_pd(bi + j, _mm_sub_pd(yi, ti));
+        _mm_storeu_pd(ar + j, _mm_add_pd(yr, tr));
+        _mm_storeu_pd(ai + j, _mm_add_pd(yi, ti));
+    }
+    scalar_butterflies(ar + j, ai + j, br + j, bi + j, wr + j, wi + j, count - j);
+}
+
+SSE2_TARGET void sse2_decode_f32(const float* src, size_t count, double* out) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(src + i);
+        _mm_storeu_pd(out + i, _mm_cvtps_pd(v));
+        _mm_storeu_pd(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    scalar_decode_f32(src + i, count - i, out + i);
+}
+
+// Sign-extended int32 lanes -> four doubles times scale.
+SSE2_TARGET inline void sse2_store_scaled(__m128i lanes, __m128d scale, double* out) {
+    _mm_storeu_pd(out, _mm_mul_pd(_mm_cvtepi32_pd(lanes), scale));
+    _mm_storeu_pd(out + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(lanes, 8)), scale));
+}
+
+SSE2_TARGET void sse2_decode_i16(const int16_t* src, size_t count, double scale, double* out) {
+    const __m128d s = _mm_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        sse2_store_scaled(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), s, out + i);
+        sse2_store_scaled(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16), s, out + i + 4);
+    }
+    scalar_decode_i16(src + i, count - i, scale, out + i);
+}
+
+SSE2_TARGET void sse2_decode_i8(const int8_t* src, size_t count, double scale, double* out) {
+    const __m128d s = _mm_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_unpacklo_epi8(v, v), hi = _mm_unpackhi_epi8(v, v);
+        sse2_store_scaled(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 24), s, out + i);
+        sse2_store_scaled(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 24), s, out + i + 4);
+        sse2_store_scaled(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 24), s, out + i + 8);
+        sse2_store_scaled(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 24), s, out + i + 12);
+    }
+    scalar_decode_i8(src + i, count - i, scale, out + i);
+}
+
+const WaveformKernels::Table SSE2_TABLE = {
+    "sse2", sse2_sum_squares, sse2_peak_abs, sse2_zero_crossings, sse2_min_max,
+    sse2_butterflies, sse2_decode_f32, sse2_decode_i16, sse2_decode_i8
+};
+
+// ========== AVX2 ==========
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+AVX2_TARGET double avx2_hsum(__m256d v) {
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    double lanes[2];
+    _mm_storeu_pd(lanes, sum);
+    return lanes[0] + lanes[1];
+}
+
+AVX2_TARGET double avx2_sum_squares(const double* data, size_t count) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d a = _mm256_loadu_pd(data + i);
+        __m256d b = _mm256_loadu_pd(data + i + 4);
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(a, a));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(b, b));
+    }
+    return avx2_hsum(_mm256_add_pd(acc0, acc1)) + scalar_sum_squares(data + i, count - i);
+}
+
+AVX2_TARGET double avx2_peak_abs(const double* data, size_t count) {
+    const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    __m256d peak0 = _mm256_setzero_pd(), peak1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        peak0 = _mm256_max_pd(peak0, _mm256_and_pd(_mm256_loadu_pd(data + i), abs_mask));
+        peak1 = _mm256_max_pd(peak1, _mm256_and_pd(_mm256_loadu_pd(data + i + 4), abs_mask));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_max_pd(peak0, peak1));
+    double peak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    return std::max(peak, scalar_peak_abs(data + i, count - i));
+}
+
+AVX2_TARGET size_t avx2_zero_crossings(const double* data, size_t count) {
+    if (count < 2)
+        return 0;
+    const __m256d zero = _mm256_setzero_pd();
+    size_t crossings = 0;
+    size_t i = 0;
+    for (; i + 5 <= count; i += 4) {
+        __m256d a = _mm256_cmp_pd(_mm256_loadu_pd(data + i), zero, _CMP_LT_OQ);
+        __m256d b = _mm256_cmp_pd(_mm256_loadu_pd(data + i + 1), zero, _CMP_LT_OQ);
+        crossings += static_cast<size_t>(__builtin_popcount(_mm256_movemask_pd(_mm256_xor_pd(a, b))));
+    }
+    return crossings + scalar_zero_crossings(data + i, count - i);
+}
+
+AVX2_TARGET void avx2_min_max(const double* data, size_t count, double* lo, double* hi) {
+    if (count < 4) {
+        scalar_min_max(data, count, lo, hi);
+        return;
+    }
+    __m256d mn = _mm256_loadu_pd(data), mx = mn;
+    size_t i = 4;
+    for (; i + 4 <= count; i += 4) {
+        __m256d v = _mm256_loadu_pd(data + i);
+        mn = _mm256_min_pd(mn, v);
+        mx = _mm256_max_pd(mx, v);
+    }
+    double mins[4], maxs[4];
+    _mm256_storeu_pd(mins, mn);
+    _mm256_storeu_pd(maxs, mx);
+    double out_lo = std::min(std::min(mins[0], mins[1]), std::min(mins[2], mins[3]));
+    double out_hi = std::max(std::max(maxs[0], maxs[1]), std::max(maxs[2], maxs[3]));
+    if (i < count) {
+        double tail_lo, tail_hi;
+        scalar_min_max(data + i, count - i, &tail_lo, &tail_hi);
+        out_lo = std::min(out_lo, tail_lo);
+        out_hi = std::max(out_hi, tail_hi);
+    }
+    *lo = out_lo;
+    *hi = out_hi;
+}
+
+AVX2_TARGET void avx2_butterflies(double* ar, double* ai, double* br, double* bi,
+                                  const double* wr, const double* wi, size_t count) {
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        __m256d xr = _mm256_loadu_pd(br + j), xi = _mm256_loadu_pd(bi + j);
+        __m256d cr = _mm256_loadu_pd(wr + j), ci = _mm256_loadu_pd(wi + j);
+        __m256d tr = _mm256_sub_pd(_mm256_mul_pd(xr, cr), _mm256_mul_pd(xi, ci));
+        __m256d ti = _mm256_add_pd(_mm256_mul_pd(xr, ci), _mm256_mul_pd(xi, cr));
+        __m256d yr = _mm256_loadu_pd(ar + j), yi = _mm256_loadu_pd(ai + j);
+        _mm256_storeu_pd(br + j, _mm256_sub_pd(yr, tr));
+        _mm256_storeu_pd(bi + j, _mm256_sub_pd(yi, ti));
+        _mm256_storeu_pd(ar + j, _mm256_add_pd(yr, tr));
+        _mm256_storeu_pd(ai + j, _mm256_add_pd(yi, ti));
+    }
+    scalar_butterflies(ar + j, ai + j, br + j, bi + j, wr + j, wi + j, count - j);
+}
+
+AVX2_TARGET void avx2_decode_f32(const float* src, size_t count, double* out) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_pd(out + i, _mm256_cvtps_pd(_mm_loadu_ps(src + i)));
+        _mm256_storeu_pd(out + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(src + i + 4)));
+    }
+    scalar_decode_f32(src + i, count - i, out + i);
+}
+
+AVX2_TARGET void avx2_decode_i16(const int16_t* src, size_t count, double scale, double* out) {
+    const __m256d s = _mm256_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i wide = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(wide)), s));
+        _mm256_storeu_pd(out + i + 4, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(wide, 1)), s));
+    }
+    scalar_decode_i16(src + i, count - i, scale, out + i);
+}
+
+AVX2_TARGET void avx2_decode_i8(const int8_t* src, size_t count, double scale, double* out) {
+    const __m256d s = _mm256_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i wide = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(wide)), s));
+        _mm256_storeu_pd(out + i + 4, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(wide, 1)), s));
+    }
+    scalar_decode_i8(src + i, count - i, scale, out + i);
+}
+
+const WaveformKernels::Table AVX2_TABLE = {
+    "avx2", avx2_sum_squares, avx2_peak_abs, avx2_zero_crossings, avx2_min_max,
+    avx2_butterflies, avx2_decode_f32, avx2_decode_i16, avx2_decode_i8
+};
+
+#endif // WAVEFORM_KERNELS_X86
+
+} // namespace
+
+const WaveformKernels::Table& WaveformKernels::scalar() {
+    return SCALAR_TABLE;
+}
+
+const WaveformKernels::Table* WaveformKernels::sse2() {
+#ifdef WAVEFORM_KERNELS_X86
+    return __builtin_cpu_supports("sse2") ? &SSE2_TABLE : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const WaveformKernels::Table* WaveformKernels::avx2() {
+#ifdef WAVEFORM_KERNELS_X86
+    return __builtin_cpu_supports("avx2") ? &AVX2_TABLE : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const WaveformKernels::Table& WaveformKernels::active() {
+    static const Table* best = avx2() ? avx2() : (sse2() ? sse2() : &SCALAR_TABLE);
+    return *best;
+}
+
+WaveformStats WaveformKernels::stats(const double* data, size_t count, const Table& kernels) {
+    WaveformStats result;
+    if (!data || count == 0)
+        return result;
+    result.rms = std::sqrt(kernels.sum_squares(data, count) / count);
+    result.peak = kernels.peak_abs(data, count);
+    result.crest_factor = result.rms > 0.0 ? result.peak / result.rms : 0.0;
+    result.zero_crossing_rate = count > 1
+        ? static_cast<double>(kernels.zero_crossings(data, count)) / (count - 1) : 0.0;
+    return result;
+}
+
+std::vector<double> WaveformKernels::energy_envelope(const double* data, size_t count, size_t window,
+                                                     const Table& kernels) {
+    std::vector<double> envelope;
+    if (!data || count == 0 || window == 0)
+        return envelope;
+    envelope.reserve((count + window - 1) / window);
+    for (size_t start = 0; start < count; start += window) {
+        size_t length = std::min(window, count - start);
+        envelope.push_back(kernels.sum_squares(data + start, length) / length);
+    }
+    return envelope;
+}
+
+std::vector<WaveformMinMax> WaveformKernels::min_max_downsample(const double* data, size_t count, size_t buckets,
+                                                               const Table& kernels) {
+    std::vector<WaveformMinMax> overview;
+    if (!data || count == 0 || buckets == 0)
+        return overview;
+    buckets = std::min(buckets, count);
+    overview.reserve(buckets);
+    for (size_t b = 0; b < buckets; ++b) {
+        size_t begin = b * count / buckets;
+        size_t end = (b + 1) * count / buckets;
+        double lo, hi;
+        kernels.min_max(data + begin, end - begin, &lo, &hi);
+        overview.push_back(WaveformMinMax(lo, hi));
+    }
+    return overview;
+}
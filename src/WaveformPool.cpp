@@ -0,0 +1,127 @@
+#include "WaveformPool.h"
+#include <cstdlib>
+#include <new>
+
+const size_t WaveformPool::ALIGNMENT;
+const size_t WaveformPool::MAX_POOLED_BYTES;
+
+namespace {
+const size_t MIN_CLASS_BYTES = 64;       // classes step by this up to LINEAR_CLASS_BYTES
+const size_t LINEAR_CLASS_BYTES = 256;
+const size_t CLASSES_PER_OCTAVE = 4;     // above it: 1.25, 1.5, 1.75 and 2 x 2^k
+
+void* aligned_block(size_t bytes) {
+    void* block = nullptr;
+    if (posix_memalign(&block, WaveformPool::ALIGNMENT, bytes) != 0)
+        throw std::bad_alloc();
+    return block;
+}
+}
+
+WaveformPool& WaveformPool::instance() {
+    static WaveformPool pool;
+    return pool;
+}
+
+WaveformPool::WaveformPool() : free_lists(), mutex(), counters() {
+    size_t class_bytes;
+    free_lists.resize(classIndex(MAX_POOLED_BYTES, class_bytes) + 1);
+    counters.hits = 0;
+    counters.misses = 0;
+    counters.bytes_outstanding = 0;
+    counters.bytes_pooled = 0;
+}
+
+WaveformPool::~WaveformPool() {
+    trim();
+}
+
+size_t WaveformPool::classIndex(size_t bytes, size_t& class_bytes) {
+    if (bytes <= LINEAR_CLASS_BYTES) {
+        size_t steps = (bytes + MIN_CLASS_BYTES - 1) / MIN_CLASS_BYTES;
+        steps = steps ? steps : 1;
+        class_bytes = steps * MIN_CLASS_BYTES;
+        return steps - 1;
+    }
+    // bytes lies in (2^shift, 2^(shift + 1)]; round up to a quarter of 2^shift.
+    size_t shift = 0;
+    while ((size_t(2) << shift) < bytes)
+        ++shift;
+    size_t octave = size_t(1) << shift;
+    size_t step = octave / CLASSES_PER_OCTAVE;
+    size_t quarters = (bytes - octave + step - 1) / step;   // 1..4
+    class_bytes = octave + quarters * step;
+    size_t first_shift = 8;   // log2(LINEAR_CLASS_BYTES)
+    return LINEAR_CLASS_BYTES / MIN_CLASS_BYTES + (shift - first_shift) * CLASSES_PER_OCTAVE + quarters - 1;
+}
+
+size_t WaveformPool::blockBytes(size_t sample_count) {
+    size_t bytes = sample_count * sizeof(double);
+    if (bytes == 0 || bytes > MAX_POOLED_BYTES)
+        return bytes;
+    size_t class_bytes;
+    classIndex(bytes, class_bytes);
+    return class_bytes;
+}
+
+double* WaveformPool::allocate(size_t sample_count) {
+    if (sample_count == 0)
+        return nullptr;
+    size_t bytes = sample_count * sizeof(double);
+    if (bytes > MAX_POOLED_BYTES) {
+        void* block = aligned_block(bytes);
+        std::lock_guard<std::mutex> lock(mutex);
+        ++counters.misses;
+        counters.bytes_outstanding += bytes;
+        return static_cast<double*>(block);
+    }
+    size_t class_bytes;
+    size_t index = classIndex(bytes, class_bytes);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        counters.bytes_outstanding += class_bytes;
+        std::vector<void*>& list = free_lists[index];
+        if (!list.empty()) {
+            void* block = list.back();
+            list.pop_back();
+            ++counters.hits;
+            counters.bytes_pooled -= class_bytes;
+            return static_cast<double*>(block);
+        }
+        ++counters.misses;
+    }
+    return static_cast<double*>(aligned_block(class_bytes));
+}
+
+void WaveformPool::release(double* block, size_t sample_count) {
+    if (!block)
+        return;
+    size_t bytes = sample_count * sizeof(double);
+    if (bytes > MAX_POOLED_BYTES) {
+        std::free(block);
+        std::lock_guard<std::mutex> lock(mutex);
+        counters.bytes_outstanding -= bytes;
+        return;
+    }
+    size_t class_bytes;
+    size_t index = classIndex(bytes, class_bytes);
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.bytes_outstanding -= class_bytes;
+    counters.bytes_pooled += class_bytes;
+    free_lists[index].push_back(block);
+}
+
+void WaveformPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& list : free_lists) {
+        for (void* block : list)
+            std::free(block);
+        list.clear();
+    }
+    counters.bytes_pooled = 0;
+}
+
+WaveformPool::Stats WaveformPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
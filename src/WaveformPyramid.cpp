@@ -0,0 +1,118 @@
+#include "WaveformPyramid.h"
+#include "WaveformBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+const size_t WaveformPyramid::BASE_BLOCK;
+
+namespace {
+// Samples decoded per step while summarizing a compact buffer.
+const size_t DECODE_CHUNK = 64 * WaveformPyramid::BASE_BLOCK;
+}
+
+WaveformPyramid::WaveformPyramid(const WaveformBuffer& source, const WaveformKernels::Table& table)
+    : samples(source), kernels(table), level_data() {
+    size_t count = samples.size();
+    if (count == 0)
+        return;
+
+    level_data.push_back(Level());
+    Level& base = level_data.back();
+    size_t blocks = (count + BASE_BLOCK - 1) / BASE_BLOCK;
+    base.block = BASE_BLOCK;
+    base.min.resize(blocks);
+    base.max.resize(blocks);
+    base.energy.resize(blocks);
+
+    const double* direct = samples.data();
+    std::vector<double> scratch(direct ? 0 : std::min(DECODE_CHUNK, count));
+    for (size_t first = 0; first < count; first += DECODE_CHUNK) {
+        size_t chunk = std::min(DECODE_CHUNK, count - first);
+        const double* data = direct ? direct + first : scratch.data();
+        if (!direct)
+            samples.decode(first, chunk, scratch.data(), kernels);
+        for (size_t offset = 0; offset < chunk; offset += BASE_BLOCK) {
+            size_t b = (first + offset) / BASE_BLOCK;
+            size_t length = std::min(BASE_BLOCK, chunk - offset);
+            double lo, hi;
+            kernels.min_max(data + offset, length, &lo, &hi);
+            base.min[b] = static_cast<float>(lo);
+            base.max[b] = static_cast<float>(hi);
+            base.energy[b] = static_cast<float>(kernels.sum_squares(data + offset, length));
+        }
+    }
+
+    // Each coarser level merges pairs; an odd last entry is carried up alone.
+    while (level_data.back().min.size() > 1) {
+        level_data.push_back(Level());
+        const Level& fine = level_data[level_data.size() - 2];
+        Level& coarse = level_data.back();
+        size_t n = (fine.min.size() + 1) / 2;
+        coarse.block = fine.block * 2;
+        coarse.min.resize(n);
+        coarse.max.resize(n);
+        coarse.energy.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            size_t a = 2 * i, b = std::min(2 * i + 1, fine.min.size() - 1);
+            coarse.min[i] = std::min(fine.min[a], fine.min[b]);
+            coarse.max[i] = std::max(fine.max[a], fine.max[b]);
+            coarse.energy[i] = a == b ? fine.energy[a] : fine.energy[a] + fine.energy[b];
+        }
+    }
+}
+
+void WaveformPyramid::overview(size_t width, std::vector<WaveformColumn>& columns) const {
+    size_t count = samples.size();
+    width = std::min(width, count);
+    columns.resize(width);
+    if (width == 0)
+        return;
+    if (count < 4 * BASE_BLOCK * width) {
+        exact_overview(width, columns);
+        return;
+    }
+
+    // Coarsest level with at least four blocks per column.
+    size_t level = 0;
+    while (level + 1 < level_data.size() && level_data[level + 1].block * 4 * width <= count)
+        ++level;
+    const Level& source = level_data[level];
+    size_t blocks = source.min.size();
+
+    for (size_t p = 0; p < width; ++p) {
+        size_t begin = p * blocks / width;
+        size_t end = (p + 1) * blocks / width;
+        float lo = source.min[begin], hi = source.max[begin];
+        double energy = 0.0;
+        for (size_t b = begin; b < end; ++b) {
+            lo = std::min(lo, source.min[b]);
+            hi = std::max(hi, source.max[b]);
+            energy += source.energy[b];
+        }
+        size_t covered = std::min(end * source.block, count) - begin * source.block;
+        columns[p] = WaveformColumn(lo, hi, std::sqrt(energy / covered));
+    }
+}
+
+void WaveformPyramid::exact_overview(size_t width, std::vector<WaveformColumn>& columns) const {
+    size_t count = samples.size();
+    const double* direct = samples.data();
+    std::vector<double> scratch(direct ? 0 : count / width + 1);
+    for (size_t p = 0; p < width; ++p) {
+        size_t begin = p * count / width;
+        size_t length = (p + 1) * count / width - begin;
+        const double* data = direct ? direct + begin : scratch.data();
+        if (!direct)
+            samples.decode(begin, length, scratch.data(), kernels);
+        double lo, hi;
+        kernels.min_max(data, length, &lo, &hi);
+        columns[p] = WaveformColumn(lo, hi, std::sqrt(kernels.sum_squares(data, length) / length));
+    }
+}
+
+size_t WaveformPyramid::memory_bytes() const {
+    size_t bytes = level_data.capacity() * sizeof(Level);
+    for (const Level& level : level_data)
+        bytes += (level.min.capacity() + level.max.capacity() + level.energy.capacity()) * sizeof(float);
+    return bytes;
+}
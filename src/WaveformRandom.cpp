@@ -0,0 +1,65 @@
+#include "WaveformRandom.h"
+#include <atomic>
+#include <random>
+
+namespace {
+std::atomic<uint64_t> base_seed(0);
+std::atomic<uint64_t> seed_generation(1);   // bumped by seed() so threads reseed
+std::atomic<uint64_t> thread_counter(0);
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+struct ThreadStream {
+    uint64_t state = 0;
+    uint64_t generation = 0;
+};
+
+thread_local ThreadStream stream;
+}
+
+void WaveformRandom::seed(uint64_t new_seed) {
+    base_seed.store(new_seed, std::memory_order_relaxed);
+    thread_counter.store(0, std::memory_order_relaxed);
+    seed_generation.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t WaveformRandom::nextTrackSeed() {
+    uint64_t generation = seed_generation.load(std::memory_order_acquire);
+    if (stream.generation != generation) {
+        uint64_t seed = base_seed.load(std::memory_order_relaxed);
+        if (seed == 0) {
+            std::random_device rd;
+            seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+        }
+        uint64_t ordinal = thread_counter.fetch_add(1, std::memory_order_relaxed);
+        stream.state = seed ^ (ordinal * 0xD1B54A32D192ED03ULL);
+        stream.generation = generation;
+    }
+    return splitmix64(stream.state);
+}
+
+void WaveformRandom::fill(double* out, size_t count, uint64_t seed) {
+    uint64_t sm = seed;
+    uint64_t s0 = splitmix64(sm), s1 = splitmix64(sm), s2 = splitmix64(sm), s3 = splitmix64(sm);
+    for (size_t i = 0; i < count; ++i) {
+        // xoshiro256+: the top 53 bits give a uniform double in [0, 1).
+        uint64_t result = s0 + s3;
+        uint64_t t = s1 << 17;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = rotl(s3, 45);
+        out[i] = static_cast<double>(result >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+    }
+}
@@ -162,6 +162,9 @@ int main(int argc, char* argv[]) {
      * Command-line argument parsing
      * - If "-I" is provided as the first argument, run interactive DJ software
      * - If "-A" is provided as the second argument, enable play_all mode
+     * - If "-M" is provided as the first argument, run the offline cache sizing
+     *   tool: -M [trace_file|-] [sample_rate]. Without a trace file (or with "-")
+     *   the access stream is derived from the configured playlists.
      */
     bool run_software = false;
     bool play_all = false;
@@ -173,6 +176,21 @@ int main(int argc, char* argv[]) {
         play_all = true;
     }
 
+    if (argc > 1 && std::string(argv[1]) == "-M") {
+        std::string trace_path = (argc > 2 && std::string(argv[2]) != "-") ? argv[2] : "";
+        double sample_rate = 0.0;
+        if (argc > 3) {
+            try {
+                sample_rate = std::stod(argv[3]);
+            } catch (const std::exception& e) {
+                std::cerr << "[WARNING] Invalid sample rate '" << argv[3] << "', choosing automatically" << std::endl;
+            }
+        }
+        DJSession sizing_session("Cache Sizing");
+        sizing_session.run_cache_sizing(trace_path, sample_rate);
+        return 0;
+    }
+
     if (run_software) {
         std::cout << "\n============= RUNNING INTERACTIVE SOFTWARE =============" << std::endl;
         DJSession live_session("Interactive Session", play_all);